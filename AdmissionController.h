@@ -0,0 +1,230 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include "Platform.h"
+#include "ProgramConfig.h"
+#include "TimerService.h"
+#include "TextEncoding.h"
+
+// 一次系统负载采样（-1表示该项无法取得，无法取得的项视为满足阈值）
+struct LoadSample {
+    int cpuPercent = -1;
+    int diskQueue = -1;
+    int freeMemoryMB = -1;
+};
+
+// 负载来源：可替换为回放记录的来源，返回false表示本次无法采样
+using LoadSource = std::function<bool(LoadSample&)>;
+
+// 本机负载：CPU使用率为相邻两次采样之间的平均值（以构造时刻为第一次）
+class SystemLoadSource {
+private:
+    Platform::SystemLoadCounters previous;
+    bool hasPrevious = false;
+
+public:
+    SystemLoadSource() {
+        hasPrevious = Platform::ReadSystemLoad(previous);
+    }
+
+    bool operator()(LoadSample& sample) {
+        Platform::SystemLoadCounters current;
+        if (!Platform::ReadSystemLoad(current)) return false;
+        sample = LoadSample();
+        if (hasPrevious && current.totalTime > previous.totalTime) {
+            uint64_t total = current.totalTime - previous.totalTime;
+            uint64_t idle = current.idleTime - (std::min)(current.idleTime, previous.idleTime);
+            sample.cpuPercent = static_cast<int>(100 - (std::min)(idle, total) * 100 / total);
+        }
+        sample.diskQueue = static_cast<int>(current.diskQueueLength);
+        sample.freeMemoryMB = static_cast<int>(current.availableMemoryMB);
+        previous = current;
+        hasPrevious = true;
+        return true;
+    }
+};
+
+// 回放--load-record记录的负载：按时钟经过的时间取记录中不晚于此刻的最后一个样本
+// 文件每行为 "elapsedMs cpuPercent diskQueue freeMemoryMB"，#开头为注释
+class ReplayLoadSource {
+private:
+    struct Point {
+        long long elapsedMs;
+        LoadSample sample;
+    };
+
+    std::vector<Point> points;
+    TimerService* timers;
+    TimerService::TimePoint start;
+    bool started = false;
+
+public:
+    explicit ReplayLoadSource(TimerService* timerService = &TimerService::Shared()) : timers(timerService) {}
+
+    bool Load(const std::wstring& path, std::string& error) {
+        std::string content;
+        if (!Platform::ReadWholeFile(path, content)) {
+            error = "cannot read file";
+            return false;
+        }
+        points.clear();
+        size_t lineStart = 0;
+        int lineNumber = 0;
+        while (lineStart < content.size()) {
+            size_t lineEnd = content.find('\n', lineStart);
+            if (lineEnd == std::string::npos) lineEnd = content.size();
+            std::string line = content.substr(lineStart, lineEnd - lineStart);
+            lineStart = lineEnd + 1;
+            lineNumber++;
+            if (line.empty() || line[0] == '#' || line[0] == '\r') continue;
+            Point point;
+            if (sscanf(line.c_str(), "%lld %d %d %d", &point.elapsedMs, &point.sample.cpuPercent,
+                &point.sample.diskQueue, &point.sample.freeMemoryMB) != 4) {
+                error = "line " + std::to_string(lineNumber) + ": expected 4 numbers";
+                return false;
+            }
+            points.push_back(point);
+        }
+        if (points.empty()) {
+            error = "no samples";
+            return false;
+        }
+        std::stable_sort(points.begin(), points.end(),
+            [](const Point& a, const Point& b) { return a.elapsedMs < b.elapsedMs; });
+        return true;
+    }
+
+    bool operator()(LoadSample& sample) {
+        if (points.empty()) return false;
+        if (!started) {
+            start = timers->Now();
+            started = true;
+        }
+        long long elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(timers->Now() - start).count();
+        auto it = std::upper_bound(points.begin(), points.end(), elapsed,
+            [](long long value, const Point& point) { return value < point.elapsedMs; });
+        sample = it == points.begin() ? points.front().sample : (it - 1)->sample;
+        return true;
+    }
+};
+
+// 负载准入：启动前等待系统负载低于条目配置的阈值，最长等待maxWaitMs
+// 按固定间隔低频采样，并发的启动线程共用最近一次样本
+class AdmissionController {
+public:
+    struct Result {
+        bool admitted = true;
+        int waitedMs = 0;
+        LoadSample sample;            // 最后一次检查使用的样本
+        std::wstring reason;          // 未通过时的原因
+    };
+
+private:
+    std::mutex mutex;
+    LoadSource source;
+    TimerService* timers;
+    std::chrono::milliseconds sampleInterval{ 500 };
+    LoadSample cached;
+    bool hasSample = false;
+    TimerService::TimePoint sampledAt;
+    TimerService::TimePoint origin;
+    bool recording = false;
+    std::string recorded;             // --load-record 的内容，退出时写出
+
+public:
+    explicit AdmissionController(LoadSource loadSource = SystemLoadSource(),
+        TimerService* timerService = &TimerService::Shared())
+        : source(std::move(loadSource)), timers(timerService), origin(timerService->Now()) {}
+
+    void SetLoadSource(LoadSource loadSource) {
+        std::lock_guard<std::mutex> lock(mutex);
+        source = std::move(loadSource);
+        hasSample = false;
+    }
+
+    void SetSampleInterval(int intervalMs) {
+        std::lock_guard<std::mutex> lock(mutex);
+        sampleInterval = std::chrono::milliseconds((std::max)(intervalMs, 1));
+    }
+
+    int SampleIntervalMs() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return static_cast<int>(sampleInterval.count());
+    }
+
+    // 记录每次采样，格式与ReplayLoadSource读取的相同
+    void StartRecording() {
+        std::lock_guard<std::mutex> lock(mutex);
+        recording = true;
+        recorded = "# elapsedMs cpuPercent diskQueue freeMemoryMB\n";
+    }
+
+    bool SaveRecording(const std::wstring& path) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return Platform::WriteFileAtomic(path, recorded);
+    }
+
+    // 最近的样本，超过采样间隔才重新采样
+    LoadSample Current() {
+        std::lock_guard<std::mutex> lock(mutex);
+        TimerService::TimePoint now = timers->Now();
+        if (hasSample && now - sampledAt < sampleInterval) return cached;
+        LoadSample sample;
+        if (!source || !source(sample)) sample = LoadSample();
+        cached = sample;
+        hasSample = true;
+        sampledAt = now;
+        if (recording) {
+            char line[96];
+            snprintf(line, sizeof(line), "%lld %d %d %d\n",
+                static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(now - origin).count()),
+                sample.cpuPercent, sample.diskQueue, sample.freeMemoryMB);
+            recorded += line;
+        }
+        return cached;
+    }
+
+    static bool Admits(const AdmissionThresholds& thresholds, const LoadSample& sample, std::wstring& reason) {
+        if (thresholds.maxCpuPercent >= 0 && sample.cpuPercent > thresholds.maxCpuPercent) {
+            reason = L"CPU " + std::to_wstring(sample.cpuPercent) + L"% > " + std::to_wstring(thresholds.maxCpuPercent) + L"%";
+            return false;
+        }
+        if (thresholds.maxDiskQueue >= 0 && sample.diskQueue > thresholds.maxDiskQueue) {
+            reason = L"磁盘队列 " + std::to_wstring(sample.diskQueue) + L" > " + std::to_wstring(thresholds.maxDiskQueue);
+            return false;
+        }
+        if (thresholds.minFreeMemoryMB > 0 && sample.freeMemoryMB >= 0 && sample.freeMemoryMB < thresholds.minFreeMemoryMB) {
+            reason = L"可用内存 " + std::to_wstring(sample.freeMemoryMB) + L"MB < " + std::to_wstring(thresholds.minFreeMemoryMB) + L"MB";
+            return false;
+        }
+        reason.clear();
+        return true;
+    }
+
+    // 立即检查一次，不等待
+    Result Check(const AdmissionThresholds& thresholds) {
+        Result result;
+        result.sample = Current();
+        result.admitted = Admits(thresholds, result.sample, result.reason);
+        return result;
+    }
+
+    // 每个采样间隔检查一次，直到负载低于阈值或等待满maxWaitMs
+    Result WaitForAdmission(const AdmissionThresholds& thresholds, int maxWaitMs) {
+        TimerService::TimePoint start = timers->Now();
+        while (true) {
+            Result result = Check(thresholds);
+            result.waitedMs = static_cast<int>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(timers->Now() - start).count());
+            if (result.admitted || result.waitedMs >= maxWaitMs) return result;
+            int step = (std::min)(SampleIntervalMs(), maxWaitMs - result.waitedMs);
+            timers->SleepFor(std::chrono::milliseconds(step));
+        }
+    }
+};
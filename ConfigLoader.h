@@ -0,0 +1,109 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include "Platform.h"
+#include "ProgramConfig.h"
+#include "ConfigParser.h"
+#include "TraceRecorder.h"
+#include "Metrics.h"
+
+// 配置文件的目录信息（枚举时一并取得，用于判断缓存是否过期）
+struct ConfigFileInfo {
+    std::wstring fileName;            // 文件名（含扩展名）
+    uint64_t size = 0;
+    uint64_t lastWriteTime = 0;       // 平台相关的时间戳，仅用于比较
+};
+
+// 单个配置文件的加载结果
+struct LoadedConfig {
+    std::wstring fileName;            // 文件名（含扩展名）
+    ProgramConfig config;
+    bool ok = false;
+    std::string error;                // 失败原因
+};
+
+// 配置文件夹加载器：枚举*.json后由小型线程池并发读取和解析
+// 结果按文件名排序，与线程调度无关。
+class ConfigLoader {
+public:
+    static std::wstring FileStem(const std::wstring& fileName) {
+        return fileName.substr(0, fileName.find_last_of(L'.'));
+    }
+
+    // 列出文件夹中的*.json文件（按文件名排序）
+    static std::vector<ConfigFileInfo> ListJsonFiles(const std::wstring& folder) {
+        std::vector<ConfigFileInfo> files;
+        for (const auto& entry : Platform::ListDirectory(folder, L".json")) {
+            if (entry.isDirectory) continue;
+            ConfigFileInfo info;
+            info.fileName = entry.name;
+            info.size = entry.size;
+            info.lastWriteTime = entry.lastWriteTime;
+            files.push_back(info);
+        }
+        std::sort(files.begin(), files.end(),
+            [](const ConfigFileInfo& a, const ConfigFileInfo& b) { return a.fileName < b.fileName; });
+        return files;
+    }
+
+    // 读取并解析单个配置文件，未写name时使用文件名
+    static bool LoadFile(const std::wstring& path, ProgramConfig& config, std::string& error) {
+        auto start = std::chrono::steady_clock::now();
+        std::string content;
+        if (!Platform::ReadWholeFile(path, content)) {
+            error = "cannot open file";
+            return false;
+        }
+
+        ConfigParseError parseError;
+        bool parsed = ParseProgramConfig(content, config, parseError);
+        Metrics::Shared().configParse.ObserveSince(start);
+        if (!parsed) {
+            error = parseError.ToString();
+            return false;
+        }
+
+        if (config.name.empty()) {
+            config.name = FileStem(Platform::FileNameOf(path));
+        }
+        return true;
+    }
+
+    // 并发加载多个文件，返回结果与fileNames一一对应
+    static std::vector<LoadedConfig> LoadFiles(const std::wstring& folder,
+        const std::vector<std::wstring>& fileNames, unsigned maxThreads = 0) {
+        std::vector<LoadedConfig> results(fileNames.size());
+        if (fileNames.empty()) return results;
+
+        if (maxThreads == 0) maxThreads = (std::max)(1u, (std::min)(8u, std::thread::hardware_concurrency()));
+        size_t threadCount = (std::min)(static_cast<size_t>(maxThreads), fileNames.size());
+
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            size_t index;
+            while ((index = next.fetch_add(1)) < fileNames.size()) {
+                TraceSpan span("parse_file", "config", fileNames[index]);
+                LoadedConfig& result = results[index];
+                result.fileName = fileNames[index];
+                result.config = ProgramConfig(0, true, L"", {}, ProgramType::Exe, 2000);
+                result.ok = LoadFile(Platform::JoinPath(folder, fileNames[index]), result.config, result.error);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < threadCount; i++) {
+            threads.emplace_back([&]() {
+                TraceRecorder::Shared().SetThreadName("config_loader");
+                worker();
+            });
+        }
+        worker();
+        for (auto& thread : threads) thread.join();
+        return results;
+    }
+};
@@ -0,0 +1,505 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <climits>
+#include <cstdio>
+#include "ProgramConfig.h"
+#include "TextEncoding.h"
+
+// 配置解析错误（行号、列号从1开始，列号按字节计）
+struct ConfigParseError {
+    size_t line = 0;
+    size_t column = 0;
+    std::string message;
+
+    std::string ToString() const {
+        return "line " + std::to_string(line) + ", column " + std::to_string(column) + ": " + message;
+    }
+};
+
+// 单遍JSON读取器：直接在输入缓冲区上前进，字符串直接解码到目标wstring
+// 为兼容旧的手写配置，未知的转义（如未转义的 C:\Games）按原样保留反斜杠。
+class JsonReader {
+private:
+    std::string_view text;
+    size_t pos = 0;
+    size_t line = 1;
+    size_t lineStart = 0;
+    ConfigParseError* error;
+    bool failed = false;
+
+    static int HexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    bool ReadHex4(uint32_t& value) {
+        if (pos + 4 > text.size()) return Fail("truncated \\u escape");
+        value = 0;
+        for (int i = 0; i < 4; i++) {
+            int digit = HexValue(text[pos + i]);
+            if (digit < 0) return Fail("invalid \\u escape");
+            value = (value << 4) | static_cast<uint32_t>(digit);
+        }
+        pos += 4;
+        return true;
+    }
+
+public:
+    JsonReader(std::string_view json, ConfigParseError* parseError) : text(json), error(parseError) {
+        // 跳过UTF-8 BOM
+        if (text.size() >= 3 && text.substr(0, 3) == "\xEF\xBB\xBF") pos = 3;
+        lineStart = pos;
+    }
+
+    bool Failed() const { return failed; }
+
+    bool Fail(const char* message) {
+        if (!failed && error) {
+            error->line = line;
+            error->column = pos - lineStart + 1;
+            error->message = message;
+        }
+        failed = true;
+        return false;
+    }
+
+    void SkipWhitespace() {
+        while (pos < text.size()) {
+            char c = text[pos];
+            if (c == '\n') {
+                pos++;
+                line++;
+                lineStart = pos;
+            }
+            else if (c == ' ' || c == '\t' || c == '\r') {
+                pos++;
+            }
+            else {
+                break;
+            }
+        }
+    }
+
+    char Peek() {
+        SkipWhitespace();
+        return pos < text.size() ? text[pos] : '\0';
+    }
+
+    bool Consume(char c) {
+        if (Peek() != c) return false;
+        pos++;
+        return true;
+    }
+
+    bool Expect(char c) {
+        if (Consume(c)) return true;
+        char message[] = "expected ' '";
+        message[10] = c;
+        return Fail(message);
+    }
+
+    bool AtEnd() {
+        SkipWhitespace();
+        return pos >= text.size();
+    }
+
+    // 读取键名；不含转义时直接返回输入缓冲区中的片段，不分配内存
+    bool ReadKey(std::string_view& key, std::string& scratch) {
+        if (!Expect('"')) return false;
+        size_t start = pos;
+        while (pos < text.size() && text[pos] != '"' && text[pos] != '\\') pos++;
+        if (pos < text.size() && text[pos] == '"') {
+            key = text.substr(start, pos - start);
+            pos++;
+            return true;
+        }
+
+        pos = start;
+        std::wstring decoded;
+        if (!ReadStringBody(decoded)) return false;
+        scratch = TextEncoding::WideToUtf8(decoded);
+        key = scratch;
+        return true;
+    }
+
+    // 读取左引号之后的字符串内容（含右引号）
+    bool ReadStringBody(std::wstring& out) {
+        out.clear();
+        while (pos < text.size()) {
+            char c = text[pos];
+            if (c == '"') {
+                pos++;
+                return true;
+            }
+            if (c == '\n') return Fail("unterminated string");
+            if (static_cast<unsigned char>(c) >= 0x80) {
+                TextEncoding::AppendCodePoint(out, TextEncoding::DecodeUtf8(text, pos));
+                continue;
+            }
+            pos++;
+            if (c != '\\') {
+                out.push_back(static_cast<wchar_t>(c));
+                continue;
+            }
+
+            if (pos >= text.size()) break;
+            char escape = text[pos++];
+            switch (escape) {
+            case '"': out.push_back(L'"'); break;
+            case '\\': out.push_back(L'\\'); break;
+            case '/': out.push_back(L'/'); break;
+            case 'b': out.push_back(L'\b'); break;
+            case 'f': out.push_back(L'\f'); break;
+            case 'n': out.push_back(L'\n'); break;
+            case 'r': out.push_back(L'\r'); break;
+            case 't': out.push_back(L'\t'); break;
+            case 'u': {
+                uint32_t codePoint = 0;
+                if (!ReadHex4(codePoint)) return false;
+                // 代理对合并为一个码点
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF &&
+                    pos + 1 < text.size() && text[pos] == '\\' && text[pos + 1] == 'u') {
+                    size_t saved = pos;
+                    pos += 2;
+                    uint32_t low = 0;
+                    if (!ReadHex4(low)) return false;
+                    if (low >= 0xDC00 && low <= 0xDFFF) {
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    else {
+                        pos = saved;
+                    }
+                }
+                TextEncoding::AppendCodePoint(out, codePoint);
+                break;
+            }
+            default:
+                out.push_back(L'\\');
+                out.push_back(static_cast<wchar_t>(static_cast<unsigned char>(escape)));
+                break;
+            }
+        }
+        return Fail("unterminated string");
+    }
+
+    bool ReadString(std::wstring& out) {
+        if (!Expect('"')) return false;
+        return ReadStringBody(out);
+    }
+
+    // 读取整数，带小数或指数时截断为整数部分
+    bool ReadInt(int& value) {
+        Peek();
+        size_t start = pos;
+        bool negative = false;
+        if (pos < text.size() && text[pos] == '-') {
+            negative = true;
+            pos++;
+        }
+        if (pos >= text.size() || text[pos] < '0' || text[pos] > '9') {
+            pos = start;
+            return Fail("expected number");
+        }
+        long long result = 0;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+            if (result < INT_MAX) result = result * 10 + (text[pos] - '0');
+            pos++;
+        }
+        if (pos < text.size() && text[pos] == '.') {
+            pos++;
+            while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') pos++;
+        }
+        if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+            pos++;
+            if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) pos++;
+            while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') pos++;
+        }
+        if (result > INT_MAX) result = INT_MAX;
+        value = static_cast<int>(negative ? -result : result);
+        return true;
+    }
+
+    bool ReadBool(bool& value) {
+        Peek();
+        if (text.substr(pos, 4) == "true") {
+            pos += 4;
+            value = true;
+            return true;
+        }
+        if (text.substr(pos, 5) == "false") {
+            pos += 5;
+            value = false;
+            return true;
+        }
+        return Fail("expected true or false");
+    }
+
+    // 字符串或数字都按文本读取（如 "readyTarget": 8080）
+    bool ReadScalarAsString(std::wstring& out) {
+        char c = Peek();
+        if (c == '"') return ReadString(out);
+        int number;
+        if (!ReadInt(number)) return false;
+        out = std::to_wstring(number);
+        return true;
+    }
+
+    bool ReadStringArray(std::vector<std::wstring>& values) {
+        values.clear();
+        if (!Expect('[')) return false;
+        if (Consume(']')) return true;
+        do {
+            values.emplace_back();
+            if (!ReadScalarAsString(values.back())) return false;
+        } while (Consume(','));
+        return Expect(']');
+    }
+
+    // 跳过任意值（用于未知字段），支持嵌套的对象与数组
+    bool SkipValue(int depth = 0) {
+        if (depth > 64) return Fail("nesting too deep");
+        char c = Peek();
+        if (c == '"') {
+            // 只查找结束引号，不解码
+            pos++;
+            while (pos < text.size() && text[pos] != '"') {
+                if (text[pos] == '\\') pos++;
+                else if (text[pos] == '\n') return Fail("unterminated string");
+                pos++;
+            }
+            if (pos >= text.size()) return Fail("unterminated string");
+            pos++;
+            return true;
+        }
+        if (c == '{' || c == '[') {
+            char close = c == '{' ? '}' : ']';
+            pos++;
+            if (Consume(close)) return true;
+            do {
+                if (c == '{') {
+                    std::string_view key;
+                    std::string scratch;
+                    if (!ReadKey(key, scratch) || !Expect(':')) return false;
+                }
+                if (!SkipValue(depth + 1)) return false;
+            } while (Consume(','));
+            return Expect(close);
+        }
+        if (c == 't' || c == 'f') {
+            bool ignored;
+            return ReadBool(ignored);
+        }
+        if (c == 'n') {
+            if (text.substr(pos, 4) != "null") return Fail("unexpected token");
+            pos += 4;
+            return true;
+        }
+        int ignored;
+        return ReadInt(ignored);
+    }
+};
+
+// 从JSON文本填充ProgramConfig，未出现的字段保持config中的原值
+inline bool ParseProgramConfig(std::string_view json, ProgramConfig& config, ConfigParseError& error) {
+    JsonReader reader(json, &error);
+    if (!reader.Expect('{')) return false;
+
+    std::string scratch;
+    std::wstring typeString;
+    if (!reader.Consume('}')) {
+        do {
+            std::string_view key;
+            if (!reader.ReadKey(key, scratch) || !reader.Expect(':')) return false;
+
+            bool ok;
+            if (key == "order") ok = reader.ReadInt(config.order);
+            else if (key == "enabled") ok = reader.ReadBool(config.enabled);
+            else if (key == "path") ok = reader.ReadString(config.path);
+            else if (key == "arguments") ok = reader.ReadStringArray(config.arguments);
+            else if (key == "prefetch") ok = reader.ReadStringArray(config.prefetch);
+            else if (key == "ifRunning") {
+                ok = reader.ReadString(typeString);
+                config.ifRunning = StringToIfRunningPolicy(typeString);
+            }
+            else if (key == "type") {
+                ok = reader.ReadString(typeString);
+                config.type = StringToProgramType(typeString);
+            }
+            else if (key == "delayAfterStart") ok = reader.ReadInt(config.delayAfterStart);
+            else if (key == "delayMode") {
+                ok = reader.ReadString(typeString);
+                config.delayMode = StringToDelayMode(typeString);
+            }
+            else if (key == "processNameToKill") ok = reader.ReadString(config.processNameToKill);
+            else if (key == "killAnyByName") ok = reader.ReadBool(config.killAnyByName);
+            else if (key == "killAfterSeconds") ok = reader.ReadInt(config.killAfterSeconds);
+            else if (key == "name") ok = reader.ReadString(config.name);
+            else if (key == "description") ok = reader.ReadString(config.description);
+            else if (key == "dependsOn") {
+                ok = reader.ReadStringArray(config.dependsOn);
+                config.hasDependsOn = true;
+            }
+            else if (key == "readyProbe") {
+                ok = reader.ReadString(typeString);
+                config.readiness.type = StringToReadinessType(typeString);
+            }
+            else if (key == "readyTarget") ok = reader.ReadScalarAsString(config.readiness.target);
+            else if (key == "readyPattern") ok = reader.ReadString(config.readiness.pattern);
+            else if (key == "readyTimeoutMs") ok = reader.ReadInt(config.readiness.timeoutMs);
+            else if (key == "restartPolicy") {
+                ok = reader.ReadString(typeString);
+                config.restart.mode = StringToRestartMode(typeString);
+            }
+            else if (key == "restartDelayMs") ok = reader.ReadInt(config.restart.delayMs);
+            else if (key == "restartMaxDelayMs") ok = reader.ReadInt(config.restart.maxDelayMs);
+            else if (key == "restartLimit") ok = reader.ReadInt(config.restart.limit);
+            else if (key == "priorityClass" || key == "ioPriority" || key == "memoryPriority") {
+                ok = reader.ReadString(typeString);
+                PriorityLevel level = StringToPriorityLevel(typeString);
+                if (key == "priorityClass") config.scheduling.priorityClass = level;
+                else if (key == "ioPriority") config.scheduling.ioPriority = level;
+                else config.scheduling.memoryPriority = level;
+            }
+            else if (key == "cpuAffinity") ok = reader.ReadScalarAsString(config.scheduling.cpuAffinity);
+            else if (key == "limitMemoryMB") ok = reader.ReadInt(config.limits.memoryMB);
+            else if (key == "limitCpuPercent") ok = reader.ReadInt(config.limits.cpuPercent);
+            else if (key == "admitMaxCpuPercent") ok = reader.ReadInt(config.admission.maxCpuPercent);
+            else if (key == "admitMaxDiskQueue") ok = reader.ReadInt(config.admission.maxDiskQueue);
+            else if (key == "admitMinFreeMemoryMB") ok = reader.ReadInt(config.admission.minFreeMemoryMB);
+            else if (key == "admitMaxWaitMs") ok = reader.ReadInt(config.admission.maxWaitMs);
+            else if (key == "captureOutput") ok = reader.ReadBool(config.output.enabled);
+            else if (key == "outputLogMaxKB") ok = reader.ReadInt(config.output.maxKB);
+            else if (key == "outputLogFiles") ok = reader.ReadInt(config.output.files);
+            else ok = reader.SkipValue();
+
+            if (!ok) return false;
+        } while (reader.Consume(','));
+
+        if (!reader.Expect('}')) return false;
+    }
+
+    if (!reader.AtEnd()) return reader.Fail("unexpected content after object");
+    return true;
+}
+
+// JSON字符串转义
+inline void AppendJsonString(std::string& out, const std::wstring& value) {
+    std::string utf8 = TextEncoding::WideToUtf8(value);
+    out.push_back('"');
+    for (char c : utf8) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buffer[8];
+                snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned char>(c));
+                out += buffer;
+            }
+            else {
+                out.push_back(c);
+            }
+        }
+    }
+    out.push_back('"');
+}
+
+inline std::string SerializeProgramConfig(const ProgramConfig& config) {
+    std::string out = "{\n";
+    auto stringField = [&](const char* key, const std::wstring& value) {
+        out += "  \"";
+        out += key;
+        out += "\": ";
+        AppendJsonString(out, value);
+        out += ",\n";
+    };
+    auto intField = [&](const char* key, int value) {
+        out += "  \"";
+        out += key;
+        out += "\": " + std::to_string(value) + ",\n";
+    };
+    auto arrayField = [&](const char* key, const std::vector<std::wstring>& values, bool last) {
+        out += "  \"";
+        out += key;
+        out += "\": [";
+        for (size_t i = 0; i < values.size(); i++) {
+            out += i > 0 ? ",\n    " : "\n    ";
+            AppendJsonString(out, values[i]);
+        }
+        out += values.empty() ? "]" : "\n  ]";
+        out += last ? "\n" : ",\n";
+    };
+
+    intField("order", config.order);
+    out += std::string("  \"enabled\": ") + (config.enabled ? "true" : "false") + ",\n";
+    stringField("path", config.path);
+    stringField("type", ProgramTypeToString(config.type));
+    intField("delayAfterStart", config.delayAfterStart);
+    if (config.delayMode != DelayMode::Fixed) {
+        stringField("delayMode", DelayModeToString(config.delayMode));
+    }
+    if (config.readiness.type != ReadinessType::None) {
+        stringField("readyProbe", ReadinessTypeToString(config.readiness.type));
+        stringField("readyTarget", config.readiness.target);
+        stringField("readyPattern", config.readiness.pattern);
+        intField("readyTimeoutMs", config.readiness.timeoutMs);
+    }
+    if (config.restart.mode != RestartMode::Never) {
+        stringField("restartPolicy", RestartModeToString(config.restart.mode));
+        intField("restartDelayMs", config.restart.delayMs);
+        intField("restartMaxDelayMs", config.restart.maxDelayMs);
+        intField("restartLimit", config.restart.limit);
+    }
+    if (config.scheduling.priorityClass != PriorityLevel::Default) {
+        stringField("priorityClass", PriorityLevelToString(config.scheduling.priorityClass));
+    }
+    if (config.scheduling.ioPriority != PriorityLevel::Default) {
+        stringField("ioPriority", PriorityLevelToString(config.scheduling.ioPriority));
+    }
+    if (config.scheduling.memoryPriority != PriorityLevel::Default) {
+        stringField("memoryPriority", PriorityLevelToString(config.scheduling.memoryPriority));
+    }
+    if (!config.scheduling.cpuAffinity.empty()) {
+        stringField("cpuAffinity", config.scheduling.cpuAffinity);
+    }
+    if (config.limits.Enabled()) {
+        intField("limitMemoryMB", config.limits.memoryMB);
+        intField("limitCpuPercent", config.limits.cpuPercent);
+    }
+    if (config.admission.Enabled()) {
+        intField("admitMaxCpuPercent", config.admission.maxCpuPercent);
+        intField("admitMaxDiskQueue", config.admission.maxDiskQueue);
+        intField("admitMinFreeMemoryMB", config.admission.minFreeMemoryMB);
+        intField("admitMaxWaitMs", config.admission.maxWaitMs);
+    }
+    if (config.output.enabled) {
+        out += "  \"captureOutput\": true,\n";
+        intField("outputLogMaxKB", config.output.maxKB);
+        intField("outputLogFiles", config.output.files);
+    }
+    stringField("processNameToKill", config.processNameToKill);
+    if (config.killAnyByName) out += "  \"killAnyByName\": true,\n";
+    intField("killAfterSeconds", config.killAfterSeconds);
+    stringField("name", config.name);
+    stringField("description", config.description);
+    if (config.ifRunning != IfRunningPolicy::Start) {
+        stringField("ifRunning", IfRunningPolicyToString(config.ifRunning));
+    }
+    if (!config.prefetch.empty()) {
+        arrayField("prefetch", config.prefetch, false);
+    }
+    if (config.hasDependsOn) {
+        arrayField("dependsOn", config.dependsOn, false);
+    }
+    arrayField("arguments", config.arguments, true);
+    out += "}\n";
+    return out;
+}
@@ -0,0 +1,225 @@
+#pragma once
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <limits.h>
+#endif
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cwctype>
+#include <cstdint>
+#include "TextEncoding.h"
+
+// 配置文件夹监视器：基于系统变更通知（Windows为ReadDirectoryChangesW，Linux为inotify）
+// 等待期间线程阻塞在内核对象上，没有变化时不占用CPU。
+// 只报告*.json文件，短时间内同一文件的多次变化合并为一次。
+class ConfigWatcher {
+public:
+    enum class ChangeKind {
+        Modified,   // 新建、写入或改名为该文件
+        Removed,    // 删除或改名离开
+    };
+
+    struct Change {
+        std::wstring fileName;
+        ChangeKind kind;
+    };
+
+private:
+    static constexpr int kCoalesceMs = 200;     // 编辑器保存时常连续触发多次写入
+
+    std::wstring folder;
+#ifdef _WIN32
+    HANDLE directory = INVALID_HANDLE_VALUE;
+    HANDLE changeEvent = NULL;
+    HANDLE stopEvent = NULL;
+    OVERLAPPED overlapped = {};
+    alignas(DWORD) char buffer[64 * 1024];
+    bool pending = false;
+#else
+    int inotifyFd = -1;
+    int stopFd = -1;
+    alignas(struct inotify_event) char buffer[64 * 1024];
+#endif
+
+    static bool IsJsonFile(const std::wstring& fileName) {
+        if (fileName.size() < 5) return false;
+        std::wstring extension = fileName.substr(fileName.size() - 5);
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::towlower);
+        return extension == L".json";
+    }
+
+    static void Record(std::vector<Change>& changes, const std::wstring& fileName, ChangeKind kind) {
+        if (!IsJsonFile(fileName)) return;
+        auto it = std::find_if(changes.begin(), changes.end(),
+            [&](const Change& change) { return change.fileName == fileName; });
+        if (it != changes.end()) it->kind = kind;
+        else changes.push_back({ fileName, kind });
+    }
+
+#ifdef _WIN32
+    bool Arm() {
+        ResetEvent(changeEvent);
+        overlapped = {};
+        overlapped.hEvent = changeEvent;
+        pending = ReadDirectoryChangesW(directory, buffer, sizeof(buffer), FALSE,
+            FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+            NULL, &overlapped, NULL) != FALSE;
+        return pending;
+    }
+
+    // 等待一批通知，返回false表示已停止或出错；超时返回true且不产生变化
+    bool ReadBatch(std::vector<Change>& changes, DWORD timeoutMs, bool& timedOut) {
+        timedOut = false;
+        if (!pending && !Arm()) return false;
+
+        HANDLE handles[2] = { changeEvent, stopEvent };
+        DWORD waitResult = WaitForMultipleObjects(2, handles, FALSE, timeoutMs);
+        if (waitResult == WAIT_TIMEOUT) {
+            timedOut = true;
+            return true;
+        }
+        if (waitResult != WAIT_OBJECT_0) return false;
+
+        DWORD bytes = 0;
+        pending = false;
+        if (!GetOverlappedResult(directory, &overlapped, &bytes, FALSE)) return false;
+        if (bytes == 0) {
+            // 缓冲区溢出，无法得知具体文件，报告一个空文件名由调用方全量处理
+            changes.push_back({ L"", ChangeKind::Modified });
+            return true;
+        }
+
+        const char* cursor = buffer;
+        while (true) {
+            const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(cursor);
+            std::wstring fileName(info->FileName, info->FileNameLength / sizeof(wchar_t));
+            bool removed = info->Action == FILE_ACTION_REMOVED || info->Action == FILE_ACTION_RENAMED_OLD_NAME;
+            Record(changes, fileName, removed ? ChangeKind::Removed : ChangeKind::Modified);
+            if (info->NextEntryOffset == 0) break;
+            cursor += info->NextEntryOffset;
+        }
+        return true;
+    }
+#else
+    bool ReadBatch(std::vector<Change>& changes, int timeoutMs, bool& timedOut) {
+        timedOut = false;
+        struct pollfd fds[2] = { { inotifyFd, POLLIN, 0 }, { stopFd, POLLIN, 0 } };
+        int ready = poll(fds, 2, timeoutMs);
+        if (ready == 0) {
+            timedOut = true;
+            return true;
+        }
+        if (ready < 0 || (fds[1].revents & POLLIN)) return false;
+
+        ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) return false;
+
+        for (char* cursor = buffer; cursor < buffer + length;) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(cursor);
+            cursor += sizeof(struct inotify_event) + event->len;
+            if (event->mask & IN_Q_OVERFLOW) {
+                changes.push_back({ L"", ChangeKind::Modified });
+                continue;
+            }
+            if (event->len == 0) continue;
+            bool removed = (event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0;
+            Record(changes, TextEncoding::Utf8ToWide(event->name), removed ? ChangeKind::Removed : ChangeKind::Modified);
+        }
+        return true;
+    }
+#endif
+
+public:
+    ConfigWatcher() = default;
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    ~ConfigWatcher() {
+        Close();
+    }
+
+    bool Start(const std::wstring& folderPath) {
+        Close();
+        folder = folderPath;
+#ifdef _WIN32
+        directory = CreateFileW(folder.c_str(), FILE_LIST_DIRECTORY,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+        changeEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+        stopEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+        if (directory == INVALID_HANDLE_VALUE || !changeEvent || !stopEvent || !Arm()) {
+            Close();
+            return false;
+        }
+#else
+        inotifyFd = inotify_init1(IN_CLOEXEC);
+        stopFd = eventfd(0, EFD_CLOEXEC);
+        if (inotifyFd < 0 || stopFd < 0 || inotify_add_watch(inotifyFd, TextEncoding::WideToUtf8(folder).c_str(),
+            IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE) < 0) {
+            Close();
+            return false;
+        }
+#endif
+        return true;
+    }
+
+    // 阻塞直到有*.json变化（或Stop被调用）。返回false表示监视已停止。
+    // 文件名为空的变化表示通知缓冲区溢出，调用方需要重新扫描。
+    bool WaitForChanges(std::vector<Change>& changes) {
+        changes.clear();
+        bool timedOut = false;
+        while (changes.empty()) {
+#ifdef _WIN32
+            if (!ReadBatch(changes, INFINITE, timedOut)) return false;
+#else
+            if (!ReadBatch(changes, -1, timedOut)) return false;
+#endif
+        }
+        // 继续收集短时间内的后续通知，合并同一文件的多次写入
+        while (!timedOut) {
+            if (!ReadBatch(changes, kCoalesceMs, timedOut)) return false;
+        }
+        return true;
+    }
+
+    // 可从其他线程调用，唤醒阻塞中的WaitForChanges
+    void Stop() {
+#ifdef _WIN32
+        if (stopEvent) SetEvent(stopEvent);
+#else
+        if (stopFd >= 0) {
+            uint64_t one = 1;
+            ssize_t written = write(stopFd, &one, sizeof(one));
+            (void)written;
+        }
+#endif
+    }
+
+    void Close() {
+#ifdef _WIN32
+        if (directory != INVALID_HANDLE_VALUE) {
+            if (pending) {
+                DWORD bytes = 0;
+                CancelIoEx(directory, &overlapped);
+                GetOverlappedResult(directory, &overlapped, &bytes, TRUE);
+                pending = false;
+            }
+            CloseHandle(directory);
+            directory = INVALID_HANDLE_VALUE;
+        }
+        if (changeEvent) CloseHandle(changeEvent);
+        if (stopEvent) CloseHandle(stopEvent);
+        changeEvent = stopEvent = NULL;
+#else
+        if (inotifyFd >= 0) close(inotifyFd);
+        if (stopFd >= 0) close(stopFd);
+        inotifyFd = stopFd = -1;
+#endif
+    }
+};
@@ -0,0 +1,370 @@
+#pragma once
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#endif
+#include <string>
+#include <vector>
+#include <list>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include "TextEncoding.h"
+
+// 本地控制通道：Windows为命名管道 \\.\pipe\<name>，POSIX为Unix域套接字 <运行时目录>/<name>.sock
+// 协议为按行收发：客户端每发送一行命令，服务端回复一行（通常为JSON）；同一连接可连续发送多条命令。
+// 每个连接一个线程，阻塞在内核对象上等待数据，没有请求时不占用CPU。
+class ControlServer {
+public:
+    using Handler = std::function<std::string(const std::string& command)>;
+
+    static constexpr size_t kMaxLineBytes = 64 * 1024;
+
+    static std::wstring EndpointPath(const std::wstring& name) {
+#ifdef _WIN32
+        return L"\\\\.\\pipe\\" + name;
+#else
+        if (name.find(L'/') != std::wstring::npos) return name;
+        const char* runtimeDirectory = std::getenv("XDG_RUNTIME_DIR");
+        std::wstring directory = runtimeDirectory && *runtimeDirectory ? TextEncoding::Utf8ToWide(runtimeDirectory) : L"/tmp";
+        return directory + L"/" + name + L".sock";
+#endif
+    }
+
+private:
+    struct Connection {
+#ifdef _WIN32
+        HANDLE pipe = INVALID_HANDLE_VALUE;
+#else
+        int fd = -1;
+#endif
+        std::thread thread;
+        std::atomic<bool> finished{ false };
+    };
+
+    Handler handler;
+    std::thread acceptThread;
+    std::mutex mutex;
+    std::list<Connection> connections;
+    std::atomic<bool> stopping{ false };
+    bool started = false;
+#ifdef _WIN32
+    std::wstring pipePath;
+    HANDLE stopEvent = NULL;
+    HANDLE firstInstance = INVALID_HANDLE_VALUE;
+#else
+    std::string socketPath;
+    int listenFd = -1;
+#endif
+
+    // 取出缓冲区中的完整行并逐条回复
+    bool DispatchLines(std::string& pending, const std::function<bool(const std::string&)>& write) {
+        size_t lineEnd;
+        while ((lineEnd = pending.find('\n')) != std::string::npos) {
+            std::string line = pending.substr(0, lineEnd);
+            pending.erase(0, lineEnd + 1);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) continue;
+            if (!write(handler(line) + "\n")) return false;
+        }
+        return pending.size() <= kMaxLineBytes;
+    }
+
+    // 等待连接线程结束并关闭连接；在线程结束后关闭，避免Stop()对已复用的描述符调用shutdown
+    static void CloseConnection(Connection& connection) {
+        if (connection.thread.joinable()) connection.thread.join();
+#ifdef _WIN32
+        if (connection.pipe != INVALID_HANDLE_VALUE) CloseHandle(connection.pipe);
+        connection.pipe = INVALID_HANDLE_VALUE;
+#else
+        if (connection.fd >= 0) close(connection.fd);
+        connection.fd = -1;
+#endif
+    }
+
+    // 回收已结束的连接
+    void ReapConnectionsLocked() {
+        for (auto it = connections.begin(); it != connections.end();) {
+            if (!it->finished) {
+                ++it;
+                continue;
+            }
+            CloseConnection(*it);
+            it = connections.erase(it);
+        }
+    }
+
+#ifdef _WIN32
+    HANDLE CreateInstance(bool first) {
+        return CreateNamedPipeW(pipePath.c_str(),
+            PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | (first ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0),
+            PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+            PIPE_UNLIMITED_INSTANCES, 4096, 4096, 0, NULL);
+    }
+
+    // 发起重叠操作后同时等待完成和停止事件
+    bool WaitOverlapped(HANDLE pipe, OVERLAPPED& overlapped, BOOL issued, DWORD& transferred) {
+        if (!issued) {
+            DWORD error = GetLastError();
+            if (error == ERROR_PIPE_CONNECTED) return true;
+            if (error != ERROR_IO_PENDING) return false;
+        }
+        HANDLE handles[2] = { overlapped.hEvent, stopEvent };
+        if (WaitForMultipleObjects(2, handles, FALSE, INFINITE) != WAIT_OBJECT_0) {
+            CancelIoEx(pipe, &overlapped);
+            GetOverlappedResult(pipe, &overlapped, &transferred, TRUE);
+            return false;
+        }
+        return GetOverlappedResult(pipe, &overlapped, &transferred, FALSE) != FALSE;
+    }
+
+    void Serve(Connection& connection) {
+        HANDLE pipe = connection.pipe;
+        HANDLE event = CreateEventW(NULL, TRUE, FALSE, NULL);
+        std::string pending;
+        char buffer[4096];
+        auto write = [&](const std::string& reply) {
+            OVERLAPPED overlapped = {};
+            overlapped.hEvent = event;
+            ResetEvent(event);
+            DWORD written = 0;
+            BOOL issued = WriteFile(pipe, reply.data(), static_cast<DWORD>(reply.size()), NULL, &overlapped);
+            return WaitOverlapped(pipe, overlapped, issued, written) && written == reply.size();
+        };
+        while (event && !stopping) {
+            OVERLAPPED overlapped = {};
+            overlapped.hEvent = event;
+            ResetEvent(event);
+            DWORD length = 0;
+            BOOL issued = ReadFile(pipe, buffer, sizeof(buffer), NULL, &overlapped);
+            if (!WaitOverlapped(pipe, overlapped, issued, length) || length == 0) break;
+            pending.append(buffer, length);
+            if (!DispatchLines(pending, write)) break;
+        }
+        if (event) CloseHandle(event);
+        FlushFileBuffers(pipe);
+        DisconnectNamedPipe(pipe);
+        connection.finished = true;
+    }
+
+    void AcceptLoop() {
+        HANDLE event = CreateEventW(NULL, TRUE, FALSE, NULL);
+        HANDLE pipe = firstInstance;
+        firstInstance = INVALID_HANDLE_VALUE;
+        while (event && !stopping) {
+            if (pipe == INVALID_HANDLE_VALUE) pipe = CreateInstance(false);
+            if (pipe == INVALID_HANDLE_VALUE) break;
+            OVERLAPPED overlapped = {};
+            overlapped.hEvent = event;
+            ResetEvent(event);
+            DWORD unused = 0;
+            BOOL issued = ConnectNamedPipe(pipe, &overlapped);
+            if (!WaitOverlapped(pipe, overlapped, issued, unused)) {
+                if (stopping) break;
+                CloseHandle(pipe);
+                pipe = INVALID_HANDLE_VALUE;
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            ReapConnectionsLocked();
+            connections.emplace_back();
+            Connection& connection = connections.back();
+            connection.pipe = pipe;
+            connection.thread = std::thread([this, &connection]() { Serve(connection); });
+            pipe = INVALID_HANDLE_VALUE;
+        }
+        if (pipe != INVALID_HANDLE_VALUE) CloseHandle(pipe);
+        if (event) CloseHandle(event);
+    }
+#else
+    void Serve(Connection& connection) {
+        int fd = connection.fd;
+        std::string pending;
+        char buffer[4096];
+        auto write = [fd](const std::string& reply) {
+            size_t total = 0;
+            while (total < reply.size()) {
+                ssize_t length = send(fd, reply.data() + total, reply.size() - total, MSG_NOSIGNAL);
+                if (length < 0 && errno == EINTR) continue;
+                if (length <= 0) return false;
+                total += static_cast<size_t>(length);
+            }
+            return true;
+        };
+        while (!stopping) {
+            ssize_t length = recv(fd, buffer, sizeof(buffer), 0);
+            if (length < 0 && errno == EINTR) continue;
+            if (length <= 0) break;
+            pending.append(buffer, static_cast<size_t>(length));
+            if (!DispatchLines(pending, write)) break;
+        }
+        connection.finished = true;
+    }
+
+    void AcceptLoop() {
+        while (!stopping) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                break;      // Stop()关闭了监听套接字
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            ReapConnectionsLocked();
+            connections.emplace_back();
+            Connection& connection = connections.back();
+            connection.fd = fd;
+            connection.thread = std::thread([this, &connection]() { Serve(connection); });
+        }
+    }
+#endif
+
+public:
+    ControlServer() = default;
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+
+    ~ControlServer() {
+        Stop();
+    }
+
+    // 开始监听；同名通道已被其他进程使用时失败
+    bool Start(const std::wstring& name, Handler commandHandler, std::string& error) {
+        handler = std::move(commandHandler);
+        stopping = false;
+#ifdef _WIN32
+        pipePath = EndpointPath(name);
+        stopEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+        firstInstance = CreateInstance(true);
+        if (!stopEvent || firstInstance == INVALID_HANDLE_VALUE) {
+            error = GetLastError() == ERROR_ACCESS_DENIED ? "endpoint already in use" : "cannot create named pipe";
+            if (stopEvent) CloseHandle(stopEvent);
+            stopEvent = NULL;
+            return false;
+        }
+#else
+        socketPath = TextEncoding::WideToUtf8(EndpointPath(name));
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(address.sun_path)) {
+            error = "socket path too long";
+            return false;
+        }
+        memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+        // 上次异常退出留下的套接字文件：无人监听时删除后重新绑定
+        std::string reply, probeError;
+        if (SendControlCommand(name, "ping", reply, probeError)) {
+            error = "endpoint already in use";
+            return false;
+        }
+        unlink(socketPath.c_str());
+
+        listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        mode_t previousMask = umask(0077);      // 只允许当前用户连接
+        bool bound = listenFd >= 0 && bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        umask(previousMask);
+        if (!bound || listen(listenFd, 16) != 0) {
+            error = std::string("cannot listen: ") + strerror(errno);
+            if (listenFd >= 0) close(listenFd);
+            listenFd = -1;
+            return false;
+        }
+#endif
+        started = true;
+        acceptThread = std::thread([this]() { AcceptLoop(); });
+        return true;
+    }
+
+    // 停止监听并断开所有连接，等待正在执行的命令返回
+    void Stop() {
+        if (!started) return;
+        started = false;
+        stopping = true;
+#ifdef _WIN32
+        SetEvent(stopEvent);
+#else
+        shutdown(listenFd, SHUT_RDWR);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto& connection : connections) shutdown(connection.fd, SHUT_RDWR);
+        }
+#endif
+        if (acceptThread.joinable()) acceptThread.join();
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& connection : connections) CloseConnection(connection);
+        connections.clear();
+#ifdef _WIN32
+        CloseHandle(stopEvent);
+        stopEvent = NULL;
+#else
+        close(listenFd);
+        listenFd = -1;
+        unlink(socketPath.c_str());
+#endif
+    }
+
+    // 客户端：连接name指定的通道，发送一行命令并读取一行回复
+    static bool SendControlCommand(const std::wstring& name, const std::string& command, std::string& reply, std::string& error) {
+        std::string request = command + "\n";
+        reply.clear();
+#ifdef _WIN32
+        std::wstring path = EndpointPath(name);
+        HANDLE pipe = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+        if (pipe == INVALID_HANDLE_VALUE && GetLastError() == ERROR_PIPE_BUSY && WaitNamedPipeW(path.c_str(), 2000)) {
+            pipe = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+        }
+        if (pipe == INVALID_HANDLE_VALUE) {
+            error = "cannot connect to " + TextEncoding::WideToUtf8(path);
+            return false;
+        }
+        DWORD written = 0;
+        bool ok = WriteFile(pipe, request.data(), static_cast<DWORD>(request.size()), &written, NULL) && written == request.size();
+        char buffer[4096];
+        while (ok && reply.find('\n') == std::string::npos) {
+            DWORD length = 0;
+            if (!ReadFile(pipe, buffer, sizeof(buffer), &length, NULL) || length == 0) break;
+            reply.append(buffer, length);
+        }
+        CloseHandle(pipe);
+#else
+        std::string path = TextEncoding::WideToUtf8(EndpointPath(name));
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            error = "socket path too long";
+            return false;
+        }
+        memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            error = "cannot connect to " + path;
+            if (fd >= 0) close(fd);
+            return false;
+        }
+        bool ok = send(fd, request.data(), request.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(request.size());
+        char buffer[4096];
+        while (ok && reply.find('\n') == std::string::npos) {
+            ssize_t length = recv(fd, buffer, sizeof(buffer), 0);
+            if (length < 0 && errno == EINTR) continue;
+            if (length <= 0) break;
+            reply.append(buffer, static_cast<size_t>(length));
+        }
+        close(fd);
+#endif
+        size_t lineEnd = reply.find('\n');
+        if (lineEnd == std::string::npos) {
+            error = "no reply";
+            return false;
+        }
+        reply.resize(lineEnd);
+        return true;
+    }
+};
@@ -0,0 +1,835 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include "Platform.h"
+#include "TextEncoding.h"
+#include "ProgramConfig.h"
+#include "ConfigLoader.h"
+#include "ReadinessProbe.h"
+#include "TimerService.h"
+#include "ProcessSnapshot.h"
+#include "ProcessSupervisor.h"
+#include "LaunchHistory.h"
+#include "OutputCapture.h"
+#include "Metrics.h"
+#include "TraceRecorder.h"
+#include "Logger.h"
+
+// 游戏控制器：负责启动单个程序、等待就绪、定时关闭以及退出后按策略重启
+// 既可作为独立的GameController.exe运行，也可在启动器进程内直接使用
+class GameController {
+public:
+    // 进程退出监督的结果，用于结束时的汇总
+    struct SupervisionStatus {
+        bool launched = false;            // 至少成功启动过一次
+        bool exited = false;              // 最近一次启动的进程已退出
+        int exitCode = 0;                 // 最近一次退出码（无法取得时为-1）
+        bool exitCodeKnown = true;        // 接管的进程不是子进程，退出码无法取得，其退出不算失败
+        int restarts = 0;                 // 累计重启次数
+        bool restartPending = false;      // 正在等待重启
+        bool crashLoop = false;           // 连续重启达到上限后放弃
+        bool killedOnSchedule = false;    // 由定时关闭结束
+        Platform::ProcessId pid = 0;      // 当前（或最近一次）进程的PID
+
+        bool Failed() const {
+            return !launched || crashLoop || (exited && !restartPending && !killedOnSchedule && exitCodeKnown && exitCode != 0);
+        }
+    };
+
+private:
+    // 运行超过该时长后重新计算连续重启次数和等待时间
+    static constexpr std::chrono::seconds kStableRunTime{ 60 };
+    // 检查主窗口或目标进程是否出现的间隔
+    static constexpr std::chrono::milliseconds kObserveInterval{ 100 };
+
+
+    ProgramConfig config;
+    std::wstring readyEventName;      // 启动器传入的就绪通知事件名（可为空）
+    Platform::ProcessId attachPid = 0;    // 启动器传入的已在运行的进程，Run时接管而不启动
+    std::wstring logPrefix;           // 在启动器内运行时，输出前附加的程序名称
+    bool headless = false;            // 由守护模式的启动器启动：不等待按键，任务全部结束后自行退出
+
+    Platform::ProcessHandle process;  // 已启动程序的进程句柄（控制器存活期间保留，用于按句柄关闭）
+    Platform::ProcessGroup processTree;   // 启动的进程及其所有后代（重启后仍使用同一容器）
+    ReadinessProbe probe;
+
+    TimerService* timerService = &TimerService::Shared();
+    TimerService::TimerId killTimer = 0;  // 定时关闭任务（0表示没有，受supervisionMutex保护）
+    TimerService::TimePoint launchTime;   // 进程启动时刻，修改关闭时间时据此计算剩余时间
+    bool attached = false;                // 接管的是已在运行的进程（不在进程树中，视为已就绪）
+
+    // 退出监督与重启：退出回调在监督线程上，重启与定时关闭都在定时器线程上
+    std::mutex supervisionMutex;
+    ProcessSupervisor::WatchId exitWatch = 0;
+    bool adoptedRunning = false;          // 当前监督的是接管的进程（退出码无法取得），重启后为false
+    TimerService::TimerId restartTimer = 0;
+    TimerService::TimePoint runStart;     // 当前进程的启动时刻
+    int consecutiveRestarts = 0;
+    bool killRequested = false;           // 已执行定时关闭，之后的退出不再重启
+    bool stopRequested = false;           // 控制器正在销毁
+    SupervisionStatus status;
+    std::condition_variable supervisionChanged;
+
+    // 启动历史：首次启动的耗时在就绪等待和出现观察都结束后追加到historyPath（同样受supervisionMutex保护）
+    std::wstring historyPath;
+    LaunchHistory::Sample sample;
+    int pendingMeasurements = 0;
+    bool awaitingReady = false;
+    TimerService::TimerId observeTimer = 0;
+    TimerService::TimePoint observeDeadline;
+    std::thread readinessThread;          // 没有依赖者的条目在后台完成就绪探测（见WaitUntilReadyInBackground）
+    std::atomic<bool> readinessCancelled{ false };
+
+    // 输出捕获：captureOutput的条目每次启动（包括重启）的stdout/stderr写入outputFolder/logs/<name>.log
+    std::wstring outputFolder;
+    OutputCapture::SinkId outputSink = 0;   // 退出、关闭或重启后通知，无界面模式据此判断是否结束
+
+    // 启动请求：批处理交给系统shell，带参数程序最多传递前5个参数
+    // cpuAffinity格式错误时返回的设置不限制CPU（由StartProgram给出警告）
+    static Platform::SchedulingOptions ToSchedulingOptions(const SchedulingSettings& settings) {
+        Platform::SchedulingOptions options;
+        options.priorityClass = static_cast<int>(settings.priorityClass);
+        options.ioPriority = static_cast<int>(settings.ioPriority);
+        options.memoryPriority = static_cast<int>(settings.memoryPriority);
+        if (!ParseCpuList(settings.cpuAffinity, options.cpus)) options.cpus.clear();
+        return options;
+    }
+
+    Platform::SpawnRequest BuildSpawnRequest(const ProgramConfig& config) {
+        Platform::SpawnRequest request;
+        request.path = config.path;
+        request.workingDirectory = GetWorkingDirectory(config);
+        request.script = config.type == ProgramType::Bat;
+        request.group = &processTree;
+        request.scheduling = ToSchedulingOptions(config.scheduling);
+        if (config.type == ProgramType::ExeWithArgument) {
+            for (size_t i = 0; i < config.arguments.size() && i < 5; i++) {
+                request.arguments.push_back(config.arguments[i]);
+            }
+        }
+        return request;
+    }
+
+    // 带时间戳的输出，经异步日志写出，不阻塞启动和定时器线程
+    void Log(const std::wstring& message, LogLevel level = LogLevel::Info) {
+        Logger::Shared().Write(level, logPrefix + message);
+    }
+
+    // JSON处理函数（与启动器共用ConfigLoader）
+    void LoadConfigFromJson(const std::wstring& jsonPath) {
+        std::string error;
+        if (!ConfigLoader::LoadFile(jsonPath, config, error)) {
+            Log(L"Cannot load config file: " + jsonPath + L"\n  " + TextEncoding::Utf8ToWide(error), LogLevel::Error);
+            config.path.clear();
+            return;
+        }
+
+        // 调试输出解析结果（仅debug日志级别）
+        if (!Logger::Shared().IsEnabled(LogLevel::Debug)) return;
+        std::wstring dump = L"[DEBUG] JSON Parsing Results:\n  Path: " + config.path +
+            L"\n  Type: " + std::to_wstring(static_cast<int>(config.type)) +
+            L"\n  Arguments count: " + std::to_wstring(config.arguments.size());
+        for (size_t i = 0; i < config.arguments.size(); i++) {
+            dump += L"\n  Argument " + std::to_wstring(i) + L": '" + config.arguments[i] + L"'";
+        }
+        Logger::Shared().Write(LogLevel::Debug, dump, false);
+    }
+
+    // 进程管理函数
+    // 要关闭的就是启动的进程本身时可直接使用句柄，无需枚举系统进程
+    bool TargetIsChild() const {
+        if (config.processNameToKill.empty()) return true;
+        if (config.type == ProgramType::Bat) return false;
+        return ProcessSnapshot::ToLower(Platform::FileNameOf(config.path)) ==
+            ProcessSnapshot::ToLower(config.processNameToKill);
+    }
+
+    bool KillChildByHandle() {
+        if (!process.IsValid()) return false;
+        if (Platform::WaitForExit(process, 0) != Platform::WaitResult::TimedOut) {
+            Log(L"Process already exited (PID " + std::to_wstring(process.pid) + L")");
+            return true;
+        }
+        if (!Platform::Terminate(process)) return false;
+        Log(L"Process closed by handle (PID " + std::to_wstring(process.pid) + L")");
+        return true;
+    }
+
+    // 目标是子进程派生的进程：在共享快照中按名称查找，只关闭本程序的后代进程；
+    // 持有句柄的进程本身同名时（按processNameToKill接管的进程）按句柄关闭；
+    // 配置了killAnyByName时，以上都没有找到才关闭系统中所有同名进程（目标由平台客户端等拉起）
+    bool KillProcessByName(const std::wstring& processName) {
+        auto snapshot = ProcessSnapshotCache::Shared().Get();
+        std::vector<Platform::ProcessId> pids;
+        bool rootMatches = false;
+        if (process.IsValid()) {
+            pids = snapshot->FindDescendantsByName(process.pid, processName);
+            std::vector<Platform::ProcessId> named = snapshot->FindByName(processName);
+            rootMatches = std::find(named.begin(), named.end(), process.pid) != named.end();
+        }
+        if (pids.empty() && !rootMatches && config.killAnyByName) {
+            pids = snapshot->FindByName(processName);
+        }
+
+        bool found = rootMatches && KillChildByHandle();
+        for (Platform::ProcessId pid : pids) {
+            if (Platform::TerminateById(pid)) {
+                Log(L"Process closed: " + processName + L" (PID " + std::to_wstring(pid) + L")");
+                found = true;
+            }
+        }
+        if (found) ProcessSnapshotCache::Shared().Invalidate();
+        return found;
+    }
+
+    // 定时关闭回调，在定时器线程上执行
+    void OnKillTimer() {
+        TraceRecorder::Shared().SetThreadName("timer");
+        TraceSpan span("kill", "kill", config.name);
+        span.SetPid(process.pid);
+        {
+            std::lock_guard<std::mutex> lock(supervisionMutex);
+            killRequested = true;
+        }
+        CloseTarget();
+        supervisionChanged.notify_all();
+    }
+
+    // 关闭目标程序：优先关闭整棵进程树，其次按句柄，最后按进程名
+    void CloseTarget() {
+        // 启动的进程及其所有后代都在同一个容器中（包括批处理启动的程序），一次调用全部关闭
+        if (!processTree.IsEmpty()) {
+            Log(L"Closing process tree: " + Platform::FileNameOf(config.path));
+            if (!processTree.Terminate()) {
+                Log(L"Failed to close process tree, error code: " + std::to_wstring(Platform::LastError()));
+                Metrics::Shared().killFailures[Metrics::kKillTree].Add();
+            }
+            else {
+                Metrics::Shared().kills[Metrics::kKillTree].Add();
+            }
+            return;
+        }
+
+        // 进程树已全部退出：目标不是本程序的后代（例如交给平台客户端启动），按名称查找
+        if (TargetIsChild()) {
+            Log(L"Closing process: " + Platform::FileNameOf(config.path));
+            if (!KillChildByHandle()) {
+                Log(L"Failed to close process by handle, error code: " + std::to_wstring(Platform::LastError()));
+                Metrics::Shared().killFailures[Metrics::kKillHandle].Add();
+            }
+            else {
+                Metrics::Shared().kills[Metrics::kKillHandle].Add();
+            }
+            return;
+        }
+
+        Log(L"Closing process: " + config.processNameToKill);
+        if (!KillProcessByName(config.processNameToKill)) {
+            Log(L"Process not found: " + config.processNameToKill);
+            Metrics::Shared().killFailures[Metrics::kKillName].Add();
+        }
+        else {
+            Metrics::Shared().kills[Metrics::kKillName].Add();
+        }
+    }
+
+    // 启动进程并开始监督其退出（首次启动和重启共用）
+    bool SpawnProcess() {
+        Platform::SpawnRequest request = BuildSpawnRequest(config);
+        Platform::NativeHandle output = Platform::kInvalidHandle;
+        if (outputSink) request.outputPipe = &output;
+        {
+            TraceSpan span("spawn", "launch", config.name);
+            auto spawnStart = std::chrono::steady_clock::now();
+            bool spawned = Platform::Spawn(request, process);
+            Metrics::Shared().spawnLatency.ObserveSince(spawnStart);
+            if (!spawned) {
+                int error = Platform::LastError();
+                Metrics::Shared().spawnErrors.Add(error);
+                Log(L"Failed to start process, error code: " + std::to_wstring(error));
+                if (outputSink) OutputCapture::Shared().Note(outputSink, "start failed, error code " + std::to_string(error));
+                return false;
+            }
+            span.SetPid(process.pid);
+        }
+        Metrics::Shared().launchesStarted.Add();
+        if (outputSink) {
+            OutputCapture::Shared().Note(outputSink, "started PID " + std::to_string(process.pid));
+            OutputCapture::Shared().Attach(outputSink, output);
+        }
+        SuperviseProcess();
+        return true;
+    }
+
+    // 开始监督当前进程的退出（启动、重启和接管共用）
+    void SuperviseProcess() {
+        Platform::ProcessId pid = process.pid;
+        std::lock_guard<std::mutex> lock(supervisionMutex);
+        runStart = timerService->Now();
+        status.launched = true;
+        status.exited = false;
+        status.pid = pid;
+        exitWatch = ProcessSupervisor::Shared().Watch(process, [this, pid](int exitCode) { OnProcessExit(pid, exitCode); });
+        if (!exitWatch) Log(L"Process exit cannot be supervised (PID " + std::to_wstring(pid) + L")", LogLevel::Warning);
+    }
+
+    // 调用时持有supervisionMutex；Schedule和Reschedule不等待回调，可以在锁内调用
+    void ScheduleKillLocked(std::chrono::milliseconds delay) {
+        if (killTimer && timerService->Reschedule(killTimer, delay)) return;
+        killTimer = timerService->Schedule(delay, [this]() { OnKillTimer(); });
+    }
+
+    bool HasPendingKillLocked() const {
+        return killTimer && timerService->IsPending(killTimer);
+    }
+
+    // 进程退出回调，在监督线程上执行
+    // 记录退出后exitWatch已清零，析构时不会等待本回调返回，所以在锁内通知，解锁后不再访问成员
+    void OnProcessExit(Platform::ProcessId pid, int exitCode) {
+        TraceRecorder::Shared().Instant("process_exit", "supervise", config.name, pid);
+        std::lock_guard<std::mutex> lock(supervisionMutex);
+        RecordExitLocked(pid, exitCode);
+        supervisionChanged.notify_all();
+    }
+
+    // 记录退出并按策略安排重启，调用时持有supervisionMutex
+    void RecordExitLocked(Platform::ProcessId pid, int exitCode) {
+        exitWatch = 0;
+        status.exited = true;
+        status.exitCode = exitCode;
+        status.exitCodeKnown = !adoptedRunning;
+        if (killRequested) {
+            status.killedOnSchedule = true;
+            Log(L"Process exited after scheduled close (PID " + std::to_wstring(pid) + L")");
+            return;
+        }
+        if (adoptedRunning) {
+            Log(L"Attached process exited, exit code unknown (PID " + std::to_wstring(pid) + L")");
+        }
+        else {
+            Log(L"Process exited with code " + std::to_wstring(exitCode) + L" (PID " + std::to_wstring(pid) + L")",
+                exitCode == 0 ? LogLevel::Info : LogLevel::Warning);
+        }
+        ScheduleRestartLocked(status.exitCodeKnown && exitCode != 0);
+    }
+
+    // 按策略安排重启：等待时间指数增长，连续重启达到上限后放弃；退出码未知时只有always会重启
+    void ScheduleRestartLocked(bool failed) {
+        const RestartPolicy& policy = config.restart;
+        bool wanted = policy.mode == RestartMode::Always || (policy.mode == RestartMode::OnFailure && failed);
+        if (!wanted || stopRequested) return;
+
+        if (timerService->Now() - runStart >= kStableRunTime) consecutiveRestarts = 0;
+        if (consecutiveRestarts >= policy.limit) {
+            status.crashLoop = true;
+            Log(L"Restart limit reached (" + std::to_wstring(policy.limit) + L" restarts in a row), giving up", LogLevel::Error);
+            return;
+        }
+
+        long long delayMs = (std::max)(policy.delayMs, 0);
+        for (int i = 0; i < consecutiveRestarts && delayMs < policy.maxDelayMs; i++) delayMs *= 2;
+        delayMs = (std::min)(delayMs, static_cast<long long>((std::max)(policy.maxDelayMs, policy.delayMs)));
+        consecutiveRestarts++;
+        status.restartPending = true;
+        Log(L"Restarting in " + std::to_wstring(delayMs) + L" ms (attempt " + std::to_wstring(consecutiveRestarts) +
+            L"/" + std::to_wstring(policy.limit) + L")");
+        restartTimer = timerService->Schedule(std::chrono::milliseconds(delayMs), [this]() { OnRestartTimer(); });
+    }
+
+    // 重启回调，在定时器线程上执行（与定时关闭串行，不会同时操作process）
+    void OnRestartTimer() {
+        TraceRecorder::Shared().SetThreadName("timer");
+        TraceSpan span("restart", "supervise", config.name);
+        Restart(span);
+        supervisionChanged.notify_all();
+    }
+
+    // 重新启动程序，失败时按策略再次安排重启
+    void Restart(TraceSpan& span) {
+        {
+            std::lock_guard<std::mutex> lock(supervisionMutex);
+            status.restartPending = false;
+            if (stopRequested || killRequested) return;
+            status.restarts++;
+            adoptedRunning = false;       // 重启后的进程是本进程的子进程
+        }
+        Metrics::Shared().restarts.Add();
+
+        Platform::CloseProcess(process);
+        Log(L"Restarting program...");
+        if (SpawnProcess()) {
+            span.SetPid(process.pid);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(supervisionMutex);
+        status.exited = true;
+        status.exitCode = -1;
+        status.exitCodeKnown = true;
+        ScheduleRestartLocked(true);
+    }
+
+    static int32_t ElapsedMs(TimerService::TimePoint from, TimerService::TimePoint to) {
+        return static_cast<int32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count());
+    }
+
+    // 开始记录首次启动的耗时：有就绪条件时等WaitUntilReady结束；
+    // 能观察到主窗口（Windows）或间接启动的目标进程时，在定时器线程上按间隔检查，最长到delayAfterStart（或就绪超时）
+    void BeginMeasurement(TimerService::TimePoint spawnStart) {
+        if (historyPath.empty()) return;
+        int observeMs = (std::max)(config.delayAfterStart,
+            config.readiness.type != ReadinessType::None ? config.readiness.timeoutMs : 0);
+        bool observe = observeMs > 0 && (Platform::kHasWindows || !TargetIsChild());
+        {
+            std::lock_guard<std::mutex> lock(supervisionMutex);
+            sample = LaunchHistory::Sample();
+            sample.spawnMs = ElapsedMs(spawnStart, launchTime);
+            awaitingReady = config.readiness.type != ReadinessType::None;
+            pendingMeasurements = (awaitingReady ? 1 : 0) + (observe ? 1 : 0);
+            if (observe) {
+                observeDeadline = launchTime + std::chrono::milliseconds(observeMs);
+                observeTimer = timerService->Schedule(kObserveInterval, [this]() { OnObserveTimer(); });
+            }
+            if (pendingMeasurements > 0) return;
+        }
+        LaunchHistory::Append(historyPath, config.name, sample);
+    }
+
+    // 一项测量结束，全部结束时写入启动历史；调用时持有supervisionMutex，返回是否需要写入
+    bool CompleteMeasurementLocked() {
+        return pendingMeasurements > 0 && --pendingMeasurements == 0;
+    }
+
+    // 主窗口（平台支持时）或目标进程是否已出现
+    bool TargetAppeared() {
+        std::vector<Platform::ProcessId> pids;
+        if (TargetIsChild()) pids.push_back(process.pid);
+        else pids = ProcessSnapshotCache::Shared().Get()->FindByName(config.processNameToKill);
+        if (pids.empty()) return false;
+        return !Platform::kHasWindows || Platform::HasVisibleWindow(pids);
+    }
+
+    // 出现观察回调，在定时器线程上执行
+    void OnObserveTimer() {
+        bool appeared = TargetAppeared();
+        TimerService::TimePoint now = timerService->Now();
+        {
+            std::lock_guard<std::mutex> lock(supervisionMutex);
+            observeTimer = 0;
+            if (stopRequested) return;
+            if (!appeared && now < observeDeadline) {
+                observeTimer = timerService->Schedule(kObserveInterval, [this]() { OnObserveTimer(); });
+                return;
+            }
+            sample.appearMs = appeared ? ElapsedMs(launchTime, now) : LaunchHistory::kTimedOut;
+            if (!CompleteMeasurementLocked()) return;
+        }
+        LaunchHistory::Append(historyPath, config.name, sample);
+    }
+
+    // 就绪等待结束（超时记为kTimedOut，检查失败不计入）
+    void RecordReadiness(ReadinessResult result) {
+        {
+            std::lock_guard<std::mutex> lock(supervisionMutex);
+            if (!awaitingReady) return;
+            awaitingReady = false;
+            if (result == ReadinessResult::Ready) sample.readyMs = ElapsedMs(launchTime, timerService->Now());
+            else if (result == ReadinessResult::TimedOut) sample.readyMs = LaunchHistory::kTimedOut;
+            if (!CompleteMeasurementLocked()) return;
+        }
+        LaunchHistory::Append(historyPath, config.name, sample);
+    }
+
+    // 创建进程树容器并设置资源上限（重启的进程也放入同一容器）
+    void PrepareProcessTree() {
+        processTree.Create(config.name);
+        Platform::ProcessGroupLimits limits;
+        limits.memoryBytes = static_cast<uint64_t>((std::max)(config.limits.memoryMB, 0)) * 1024 * 1024;
+        limits.cpuPercent = config.limits.cpuPercent;
+        if (!processTree.SetLimits(limits)) {
+            Log(L"Resource limits could not be applied to the process tree", LogLevel::Warning);
+        }
+        std::vector<int> cpus;
+        if (!ParseCpuList(config.scheduling.cpuAffinity, cpus)) {
+            Log(L"Invalid cpuAffinity \"" + config.scheduling.cpuAffinity + L"\", CPU affinity not applied", LogLevel::Warning);
+        }
+    }
+
+    // 打开输出日志；失败时照常启动，只是不捕获输出
+    void PrepareOutput() {
+        if (!config.output.enabled || outputSink || outputFolder.empty()) return;
+        std::wstring path = OutputCapture::LogPathIn(outputFolder, config.name);
+        outputSink = OutputCapture::Shared().Open(path, config.output.maxKB, config.output.files);
+        if (!outputSink) Log(L"Cannot open output log " + path + L", output not captured", LogLevel::Warning);
+    }
+
+    // 程序启动函数，进程句柄保留到控制器销毁
+    bool StartProgram(const ProgramConfig& config) {
+        try {
+            Log(L"Start command: " + Platform::CommandLineOf(BuildSpawnRequest(config)));
+
+            probe = ReadinessProbe(config.readiness);
+            probe.Prepare();
+
+            PrepareProcessTree();
+            PrepareOutput();
+            TimerService::TimePoint spawnStart = timerService->Now();
+            if (!SpawnProcess()) return false;
+            launchTime = timerService->Now();
+            BeginMeasurement(spawnStart);
+
+            if (config.killAfterSeconds > 0) {
+                ScheduleKill(config.killAfterSeconds);
+            }
+            return true;
+        }
+        catch (...) {
+            return false;
+        }
+    }
+
+    // 显示函数
+    void DisplayProgramInfo() {
+        std::wstring info = L"=====================================\n"
+            L"Game Controller - Independent Control Window\n"
+            L"Config Name: " + config.name + L"\n"
+            L"Description: " + config.description + L"\n"
+            L"Program Path: " + config.path;
+
+        if (config.type == ProgramType::ExeWithArgument && !config.arguments.empty()) {
+            info += L"\nArguments: ";
+            for (size_t j = 0; j < config.arguments.size() && j < 5; j++) {
+                if (j > 0) info += L", ";
+                info += config.arguments[j];
+            }
+        }
+
+        if (config.killAfterSeconds > 0) {
+            info += L"\nAuto Close: " + std::to_wstring(config.killAfterSeconds) + L" seconds later close " +
+                (config.processNameToKill.empty() ? Platform::FileNameOf(config.path) : config.processNameToKill);
+        }
+
+        if (config.limits.Enabled()) {
+            info += L"\nLimits: memory " + std::to_wstring(config.limits.memoryMB) + L" MB, CPU " +
+                std::to_wstring(config.limits.cpuPercent) + L"%";
+        }
+
+        if (config.scheduling.Enabled()) {
+            info += L"\nScheduling:";
+            if (config.scheduling.priorityClass != PriorityLevel::Default) info += L" priority " + PriorityLevelToString(config.scheduling.priorityClass);
+            if (config.scheduling.ioPriority != PriorityLevel::Default) info += L" io " + PriorityLevelToString(config.scheduling.ioPriority);
+            if (config.scheduling.memoryPriority != PriorityLevel::Default) info += L" memory " + PriorityLevelToString(config.scheduling.memoryPriority);
+            if (!config.scheduling.cpuAffinity.empty()) info += L" cpus " + config.scheduling.cpuAffinity;
+        }
+
+        if (config.restart.mode != RestartMode::Never) {
+            info += L"\nRestart: " + RestartModeToString(config.restart.mode) + L", up to " +
+                std::to_wstring(config.restart.limit) + L" times in a row";
+        }
+        info += L"\n=====================================";
+        Logger::Shared().Print(info);
+    }
+
+public:
+    // 子进程的工作目录：程序所在目录（启动前预检也据此检查）
+    static std::wstring GetWorkingDirectory(const ProgramConfig& config) {
+        return Platform::DirectoryOf(config.path);
+    }
+
+    // 无论启动成功与否都通知启动器，避免其一直等待
+    void SignalReady() {
+        if (readyEventName.empty()) return;
+        Platform::ReadyEvent::Signal(readyEventName);
+    }
+
+    void SetReadyEventName(const std::wstring& name) {
+        readyEventName = name;
+    }
+
+    void SetAttachPid(Platform::ProcessId pid) {
+        attachPid = pid;
+    }
+
+    void SetHeadless(bool enabled) {
+        headless = enabled;
+    }
+
+    void SetConsoleUTF8() {
+        Platform::SetConsoleUtf8();
+    }
+
+    bool Initialize(const std::wstring& configPath) {
+        SetConsoleUTF8();
+
+        // 设置窗口标题
+        std::wstring title = L"Game Controller - ";
+        title += Platform::FileNameOf(configPath);
+        Platform::SetConsoleTitleText(title);
+
+        // 加载配置
+        LoadConfigFromJson(configPath);
+
+        if (config.path.empty()) {
+            Log(L"Error: Invalid configuration file", LogLevel::Error);
+            return false;
+        }
+
+        // 与启动器共用配置文件夹中的启动历史和输出日志目录
+        historyPath = LaunchHistory::LogPathIn(Platform::DirectoryOf(configPath));
+        outputFolder = Platform::DirectoryOf(configPath);
+        return true;
+    }
+
+    // 在启动器进程内使用：直接接收已解析的配置，不再重新读取JSON
+    bool Initialize(const ProgramConfig& programConfig) {
+        config = programConfig;
+        logPrefix = L"[" + config.name + L"] ";
+        return !config.path.empty();
+    }
+
+    // 首次启动的耗时追加到该启动历史日志，为空时不记录
+    void SetHistoryFile(const std::wstring& path) {
+        historyPath = path;
+    }
+
+    // 捕获的输出写入该目录下的logs子目录，为空时不捕获
+    void SetOutputFolder(const std::wstring& folder) {
+        outputFolder = folder;
+    }
+
+    // 使用指定的定时器服务（例如虚拟时钟），需在Launch之前调用
+    void SetTimerService(TimerService& service) {
+        timerService = &service;
+    }
+
+    // 安排（或重新安排）定时关闭
+    void ScheduleKill(int seconds) {
+        TraceRecorder::Shared().Instant("kill_scheduled", "kill", config.name, process.pid);
+        std::lock_guard<std::mutex> lock(supervisionMutex);
+        ScheduleKillLocked(std::chrono::milliseconds(static_cast<long long>(seconds) * 1000));
+    }
+
+    // 配置热更新时修改关闭时间：按启动时刻计算剩余时间，已超时则立即关闭
+    // 定时关闭已经执行过时不再重复安排
+    void UpdateKillAfter(int seconds) {
+        config.killAfterSeconds = seconds;
+        if (!process.IsValid()) return;
+        if (seconds <= 0) {
+            CancelKill();
+            return;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(timerService->Now() - launchTime);
+        auto delay = (std::max)(std::chrono::milliseconds(0),
+            std::chrono::milliseconds(static_cast<long long>(seconds) * 1000) - elapsed);
+        std::lock_guard<std::mutex> lock(supervisionMutex);
+        if (killTimer && !timerService->IsPending(killTimer)) return;
+        TraceRecorder::Shared().Instant("kill_rescheduled", "kill", config.name, process.pid);
+        ScheduleKillLocked(delay);
+    }
+
+    bool IsLaunched() const {
+        return process.IsValid();
+    }
+
+    // 取消尚未执行的定时关闭，返回是否确有任务被取消
+    // Cancel会等待正在执行的关闭回调结束，而回调需要supervisionMutex，所以在锁外取消
+    bool CancelKill() {
+        TimerService::TimerId timer;
+        {
+            std::lock_guard<std::mutex> lock(supervisionMutex);
+            timer = killTimer;
+            killTimer = 0;
+        }
+        if (!timer) return false;
+        bool cancelled = timerService->Cancel(timer);
+        if (cancelled) TraceRecorder::Shared().Instant("kill_cancelled", "kill", config.name, process.pid);
+        return cancelled;
+    }
+
+    bool HasPendingKill() {
+        std::lock_guard<std::mutex> lock(supervisionMutex);
+        return HasPendingKillLocked();
+    }
+
+    // 立即关闭程序（守护模式的stop命令）：与定时关闭走同一路径，在定时器线程上执行，之后不再重启
+    // 程序已退出且没有等待中的重启时返回false
+    bool RequestStop() {
+        {
+            std::lock_guard<std::mutex> lock(supervisionMutex);
+            if (!status.launched || (status.exited && !status.restartPending)) return false;
+        }
+        ScheduleKill(0);
+        return true;
+    }
+
+    // 阻塞直到没有待执行的定时关闭和重启，且程序已退出（未配置重启时不等待程序退出，关闭后仍需等到退出）
+    void WaitUntilFinished() {
+        std::unique_lock<std::mutex> lock(supervisionMutex);
+        supervisionChanged.wait(lock, [this]() {
+            bool waitExit = killRequested || config.restart.mode != RestartMode::Never;
+            return !HasPendingKillLocked() && !status.restartPending && (status.exited || !waitExit);
+        });
+    }
+
+    const ProgramConfig& GetConfig() const {
+        return config;
+    }
+
+    SupervisionStatus GetSupervisionStatus() {
+        std::lock_guard<std::mutex> lock(supervisionMutex);
+        return status;
+    }
+
+    // 启动程序（不等待就绪）
+    bool Launch() {
+        Log(L"Starting program...");
+
+        if (config.type != ProgramType::Bat && !Platform::FileExists(config.path)) {
+            Log(L"File does not exist: " + config.path);
+            Metrics::Shared().launchesFailed.Add();
+            return false;
+        }
+
+        if (StartProgram(config)) {
+            Log(L"Program started successfully");
+            return true;
+        }
+        Log(L"Failed to start program");
+        Metrics::Shared().launchesFailed.Add();
+        return false;
+    }
+
+    // 接管已在运行的进程（ifRunning为attach）：不启动新进程，监督其退出、按策略重启并安排定时关闭
+    // 接管的进程不是本进程的子进程，退出码无法取得：退出不算失败，on-failure策略下也不重启
+    // ifRunning为skip时只安排定时关闭，不重启
+    bool Attach(Platform::ProcessId pid) {
+        Log(L"Attaching to running process (PID " + std::to_wstring(pid) + L")");
+        if (!Platform::OpenProcessById(pid, process)) {
+            Log(L"Cannot open running process, error code: " + std::to_wstring(Platform::LastError()), LogLevel::Error);
+            return false;
+        }
+        attached = true;
+        if (config.ifRunning == IfRunningPolicy::Skip) config.restart.mode = RestartMode::Never;
+        {
+            std::lock_guard<std::mutex> lock(supervisionMutex);
+            adoptedRunning = true;
+        }
+        TraceRecorder::Shared().Instant("attach", "launch", config.name, pid);
+        PrepareProcessTree();
+        SuperviseProcess();
+        launchTime = timerService->Now();
+        if (config.killAfterSeconds > 0) {
+            ScheduleKill(config.killAfterSeconds);
+        }
+        return true;
+    }
+
+    // 阻塞直到就绪条件满足或超时，未配置就绪条件时立即返回
+    ReadinessResult WaitUntilReady() {
+        ReadinessResult result = ReadinessResult::Ready;
+        if (config.readiness.type != ReadinessType::None && !attached) {
+            Log(L"Waiting for readiness: " + ReadinessTypeToString(config.readiness.type) + L" " + config.readiness.target);
+            TraceSpan span("readiness_wait", "wait", config.name);
+            span.SetPid(process.pid);
+            result = probe.Wait(process, &readinessCancelled);
+            switch (result) {
+            case ReadinessResult::Ready:
+                Log(L"Program is ready");
+                Metrics::Shared().readinessLatency.Observe(ElapsedMs(launchTime, timerService->Now()));
+                break;
+            case ReadinessResult::TimedOut:
+                Log(L"Readiness timed out after " + std::to_wstring(config.readiness.timeoutMs) + L" ms");
+                Metrics::Shared().readinessTimeouts.Add();
+                break;
+            case ReadinessResult::Failed:
+                if (!readinessCancelled) Log(L"Readiness check failed");
+                break;
+            }
+            RecordReadiness(result);
+        }
+        return result;
+    }
+
+    // 启动器不等待没有依赖者的条目就绪：就绪探测在后台线程上完成，结果只用于启动历史和指标
+    void WaitUntilReadyInBackground() {
+        if (config.readiness.type == ReadinessType::None || attached || readinessThread.joinable()) return;
+        readinessThread = std::thread([this]() {
+            TraceRecorder::Shared().SetThreadName("readiness");
+            WaitUntilReady();
+        });
+    }
+
+    void Run() {
+        DisplayProgramInfo();
+
+        if (attachPid ? !Attach(attachPid) : !Launch()) {
+            SignalReady();
+            if (!headless) WaitForKey(L"Press any key to exit...");
+            return;
+        }
+
+        WaitUntilReady();
+        SignalReady();
+
+        if (headless) {
+            WaitUntilFinished();
+        }
+        else if (config.killAfterSeconds > 0) {
+            Log(L"Controller will run in background, waiting to auto close process...");
+            WaitForKey(L"Press any key to exit controller immediately...");
+        }
+        else {
+            WaitForKey(L"Press any key to exit...");
+        }
+
+        SupervisionStatus summary = GetSupervisionStatus();
+        std::wstring state = !summary.exited ? L"running" :
+            summary.killedOnSchedule ? L"closed on schedule" :
+            !summary.exitCodeKnown ? std::wstring(L"exited, exit code unknown") : L"exited with code " + std::to_wstring(summary.exitCode);
+        Log(L"Summary: " + state + L", restarts " + std::to_wstring(summary.restarts) +
+            (summary.crashLoop ? L", gave up after crash loop" : L""),
+            summary.Failed() ? LogLevel::Warning : LogLevel::Info);
+    }
+
+    // 输出提示后等待按键；先写出日志中尚未输出的内容，保证提示在最后
+    static void WaitForKey(const std::wstring& prompt) {
+        Logger::Shared().Print(prompt);
+        Logger::Shared().Flush();
+        std::cin.get();
+    }
+
+    GameController() = default;
+    GameController(const GameController&) = delete;
+    GameController& operator=(const GameController&) = delete;
+
+    // 控制器销毁前取消其定时任务和退出监督，避免回调访问已销毁的对象
+    ~GameController() {
+        readinessCancelled = true;
+        if (readinessThread.joinable()) readinessThread.join();
+        TimerService::TimerId pendingRestart, pendingObserve;
+        {
+            std::lock_guard<std::mutex> lock(supervisionMutex);
+            stopRequested = true;
+            pendingRestart = restartTimer;
+            pendingObserve = observeTimer;
+        }
+        if (pendingRestart) timerService->Cancel(pendingRestart);
+        if (pendingObserve) timerService->Cancel(pendingObserve);
+        CancelKill();
+        ProcessSupervisor::WatchId watch;
+        {
+            std::lock_guard<std::mutex> lock(supervisionMutex);
+            watch = exitWatch;
+            exitWatch = 0;
+        }
+        ProcessSupervisor::Shared().Unwatch(watch);
+        if (process.IsValid()) Platform::CloseProcess(process);
+        if (outputSink) OutputCapture::Shared().Release(outputSink);
+    }
+};
@@ -1,45 +1,39 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <windows.h>
 #include <algorithm>
 #include <thread>
 #include <chrono>
-#include <locale>
-#include <codecvt>
-#include <tlhelp32.h>
-#include <fstream>
-
-// 程序类型枚举
-enum class ProgramType {
-    Exe,              // 普通EXE程序
-    Bat,              // BAT脚本文件
-    ExeWithArgument   // 需要参数的EXE程序
-};
+#include <mutex>
+#include <condition_variable>
+#include <sstream>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <unordered_set>
+#include <unordered_map>
+#include "Platform.h"
+#include "TextEncoding.h"
+#include "ProgramConfig.h"
+#include "ConfigParser.h"
+#include "ConfigLoader.h"
+#include "LaunchPlanCache.h"
+#include "ConfigWatcher.h"
+#include "GameController.h"
+#include "LaunchScheduler.h"
+#include "TraceRecorder.h"
+#include "Logger.h"
+#include "AdmissionController.h"
+#include "Prefetcher.h"
+#include "ControlChannel.h"
+#include "LaunchHistory.h"
+#include "OutputCapture.h"
+#include "Metrics.h"
+#include "LaunchSimulator.h"
+#include "PlanValidator.h"
 
-// 程序配置类
-struct ProgramConfig {
-    int order;                        // 执行顺序（唯一，从小到大依次执行）
-    bool enabled;                     // 是否启用该程序
-    std::wstring path;                // 程序路径
-    std::vector<std::wstring> arguments; // 命令行参数（最多5个）
-    ProgramType type;                 // 程序类型
-    int delayAfterStart;              // 启动后等待时间（毫秒）
-    
-    std::wstring processNameToKill;   // 要关闭的进程名
-    int killAfterSeconds;             // 启动后多少秒关闭（0表示不关闭）
-    
-    std::wstring name;                // 配置名称（用于JSON文件名）
-    std::wstring description;         // 描述信息
-
-    ProgramConfig(int ord, bool en, const std::wstring& p, const std::vector<std::wstring>& args,
-        ProgramType t, int delay, const std::wstring& killProcess = L"",
-        int killAfter = 0, const std::wstring& configName = L"",
-        const std::wstring& desc = L"")
-        : order(ord), enabled(en), path(p), arguments(args), type(t),
-        delayAfterStart(delay), processNameToKill(killProcess),
-        killAfterSeconds(killAfter), name(configName), description(desc) {}
-};
 
 class ProgramLauncher {
 private:
@@ -48,276 +42,1011 @@ private:
     std::wstring gameControllerPath;
     
     // 可自定义的字符串变量
-    std::wstring gameControllerName = L"GameController.exe";  // 游戏控制器可执行文件名
+    std::wstring gameControllerName = L"GameController" + std::wstring(Platform::kExecutableSuffix);  // 游戏控制器可执行文件名
     std::wstring configFolderName = L"ProgramConfigs";        // 配置文件夹名称
+    int maxParallelLaunches = 4;                              // 同时处于启动中的程序上限
+    bool useSeparateController = false;                       // 是否为每个程序单独启动GameController.exe
+    std::wstring planCacheName = L"launch_plan.cache";        // 启动计划缓存文件名（位于配置文件夹内）
+    bool usePlanCache = true;
+    std::wstring traceFilePath;                               // 非空时记录启动时间线并在退出时写出
+    std::wstring loadRecordPath;                              // 非空时记录负载采样并在退出时写出
+    std::wstring metricsFilePath;                             // 非空时在每批启动结束和退出时写出Prometheus指标
+    int metricsIntervalSeconds = 0;                           // 守护模式下另按该间隔写出指标（0为不定时写出）
+    AdmissionController admission;                            // 按条目阈值等待系统负载回落
+    bool usePrefetch = false;                                 // 启动前把可执行文件和prefetch文件读入页缓存
+    int prefetchBandwidthMBps = 64;                           // 预读带宽上限（MB/s，0为不限），避免拖慢正在启动的程序
+    int prefetchThreads = 4;
+    Prefetcher prefetcher;
+    LaunchHistory history;                                    // 启动耗时历史，delayMode为auto的条目据此决定等待时间
+    bool strictPreflight = false;                             // 预检发现错误时不启动任何程序
+
+    Logger& logger = Logger::Shared();                        // 状态输出经异步日志写出，启动线程不等待控制台
+    std::vector<std::unique_ptr<GameController>> controllers; // 进程内模式下的控制器（需存活到定时关闭完成）
+
+    // 当前启动计划（已启用、按order排序）；热更新新增的条目追加在末尾
+    // 守护模式下控制线程会查询状态：plan、controllers、launched、runningPids的修改需持有stateMutex
+    std::mutex stateMutex;
+    std::vector<ProgramConfig> plan;
+    std::vector<std::unique_ptr<Platform::ReadyEvent>> readyEvents;
+    std::vector<Platform::ProcessHandle> controllerProcesses;
+    std::vector<char> launched;                               // 各线程分别写入，不能用vector<bool>
+    std::vector<Platform::ProcessId> runningPids;             // 按ifRunning跳过或接管的已运行进程（0表示照常启动）
+    std::shared_ptr<const ProcessSnapshot> runningSnapshot;   // 本批启动前的进程快照，所有条目共用
+    std::unordered_map<std::wstring, size_t> planIndexByName;
+    std::atomic<size_t> launchedCount{ 0 };                   // 各启动线程并发递增，用于"(n/N)"编号
+
+    // 配置热更新
+    bool watchConfigFolder = false;
+    ConfigWatcher watcher;
+    std::unordered_map<std::wstring, std::wstring> configNameByFile;  // 配置文件名 → 配置名称
+    std::unordered_map<std::wstring, std::wstring> fileByConfigName;
+
+    // 守护模式：常驻等待控制命令，run/reload启动的批次在launchThread上执行
+    bool daemonMode = false;
+    std::wstring controlName = L"GameMJ_Launcher";            // 控制通道名称（命名管道/Unix域套接字）
+    ControlServer controlServer;
+    std::mutex daemonMutex;
+    std::condition_variable daemonCondition;
+    bool busy = false;                                        // 正在加载配置或启动批次，期间不接受run/reload
+    bool shutdownRequested = false;
+    int runCount = 0;
+    std::thread launchThread;
+
+    // JSON处理函数
+    void SaveConfigToJson(const ProgramConfig& config, const std::wstring& filePath = L"") {
+        std::wstring actualPath = filePath.empty() ?
+            Platform::JoinPath(configFolderPath, config.name + L".json") : filePath;
 
-    // 编码转换工具函数
-    std::string WStringToUTF8(const std::wstring& wstr) {
-        if (wstr.empty()) return "";
-        int size_needed = WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), NULL, 0, NULL, NULL);
-        std::string str(size_needed, 0);
-        WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), &str[0], size_needed, NULL, NULL);
-        return str;
+        if (Platform::WriteFileAtomic(actualPath, SerializeProgramConfig(config))) {
+            logger.Print(L"✓ 已保存配置: " + actualPath);
+        }
     }
 
-    std::wstring UTF8ToWString(const std::string& str) {
-        if (str.empty()) return L"";
-        int size_needed = MultiByteToWideChar(CP_UTF8, 0, &str[0], (int)str.size(), NULL, 0);
-        std::wstring wstr(size_needed, 0);
-        MultiByteToWideChar(CP_UTF8, 0, &str[0], (int)str.size(), &wstr[0], size_needed);
-        return wstr;
+    // 配置管理函数
+    void InitializeConfigFolder() {
+        std::wstring exeDir = Platform::ExecutableDirectory();
+
+        // 使用可自定义的文件夹名称
+        configFolderPath = Platform::JoinPath(exeDir, configFolderName);
+        Platform::MakeDirectory(configFolderPath);
+
+        // 使用可自定义的游戏控制器名称
+        gameControllerPath = Platform::JoinPath(exeDir, gameControllerName);
     }
 
-    // 字符串输出工具函数
-    void PrintWString(const std::wstring& wstr) {
-        std::string str = WStringToUTF8(wstr);
-        std::cout << str;
+    std::wstring GetPlanCachePath() const {
+        return Platform::JoinPath(configFolderPath, planCacheName);
     }
 
-    // 程序类型转换函数
-    std::wstring ProgramTypeToString(ProgramType type) {
-        switch (type) {
-        case ProgramType::Exe: return L"Exe";
-        case ProgramType::Bat: return L"Bat";
-        case ProgramType::ExeWithArgument: return L"ExeWithArgument";
-        default: return L"Unknown";
+    // 读取配置文件夹：大小和修改时间未变的文件直接取自启动计划缓存，其余并发解析
+    std::vector<CachedConfigFile> LoadConfigFiles(const std::vector<ConfigFileInfo>& files) {
+        std::vector<CachedConfigFile> cached;
+        std::string cacheError;
+        if (usePlanCache) {
+            TraceSpan span("plan_cache_read", "config");
+            if (!LaunchPlanCache::Read(GetPlanCachePath(), cached, cacheError)) cached.clear();
+        }
+
+        std::unordered_map<std::wstring, CachedConfigFile*> cachedByName;
+        for (auto& file : cached) cachedByName.emplace(file.file.fileName, &file);
+
+        std::vector<CachedConfigFile> loaded(files.size());
+        std::vector<std::wstring> staleNames;
+        std::vector<size_t> staleIndices;
+        for (size_t i = 0; i < files.size(); i++) {
+            auto it = cachedByName.find(files[i].fileName);
+            if (it != cachedByName.end() && it->second->file.size == files[i].size &&
+                it->second->file.lastWriteTime == files[i].lastWriteTime) {
+                loaded[i] = std::move(*it->second);
+                continue;
+            }
+            loaded[i].file = files[i];
+            staleNames.push_back(files[i].fileName);
+            staleIndices.push_back(i);
+        }
+
+        std::vector<LoadedConfig> results;
+        {
+            TraceSpan span("parse", "config");
+            results = ConfigLoader::LoadFiles(configFolderPath, staleNames);
         }
+        for (size_t i = 0; i < results.size(); i++) {
+            CachedConfigFile& file = loaded[staleIndices[i]];
+            file.ok = results[i].ok;
+            file.config = std::move(results[i].config);
+            file.error = std::move(results[i].error);
+        }
+
+        if (usePlanCache) {
+            logger.Print(L"启动计划缓存: 命中 " + std::to_wstring(files.size() - staleNames.size()) + L" 个，重新解析 " +
+                std::to_wstring(staleNames.size()) + L" 个");
+            if (!staleNames.empty() || cached.size() != files.size()) {
+                TraceSpan span("plan_cache_write", "config");
+                if (!LaunchPlanCache::Write(GetPlanCachePath(), loaded)) {
+                    logger.Write(LogLevel::Warning, L"⚠ 启动计划缓存写入失败", false);
+                }
+            }
+        }
+        return loaded;
     }
 
-    ProgramType StringToProgramType(const std::wstring& str) {
-        if (str == L"Exe") return ProgramType::Exe;
-        if (str == L"Bat") return ProgramType::Bat;
-        if (str == L"ExeWithArgument") return ProgramType::ExeWithArgument;
-        return ProgramType::Exe;
+    void LoadConfigsFromFolder() {
+        // 名称去重使用哈希集合；文件名已排序，重名时排序靠前的文件优先
+        std::unordered_set<std::wstring> loadedNames;
+        for (const auto& config : programs) loadedNames.insert(config.name);
+
+        TraceSpan span("config_load", "config");
+        std::vector<ConfigFileInfo> found;
+        {
+            TraceSpan discoverySpan("config_discovery", "config");
+            found = ConfigLoader::ListJsonFiles(configFolderPath);
+        }
+        std::vector<CachedConfigFile> files = LoadConfigFiles(found);
+        for (auto& file : files) {
+            if (!file.ok) {
+                logger.Write(LogLevel::Error, L"✗ 配置加载失败: " + file.file.fileName +
+                    L" (" + TextEncoding::Utf8ToWide(file.error) + L")", false);
+                continue;
+            }
+            if (!loadedNames.insert(file.config.name).second) {
+                logger.Write(LogLevel::Warning, L"⚠ 配置名称重复，已忽略: " + file.file.fileName, false);
+                continue;
+            }
+            configNameByFile[file.file.fileName] = file.config.name;
+            fileByConfigName[file.config.name] = file.file.fileName;
+            programs.push_back(std::move(file.config));
+            logger.Print(L"✓ 从文件加载配置: " + ConfigLoader::FileStem(file.file.fileName));
+        }
     }
 
-    // JSON处理函数
-    void SaveConfigToJson(const ProgramConfig& config, const std::wstring& filePath = L"") {
-        std::wstring actualPath = filePath.empty() ? 
-            configFolderPath + L"\\" + config.name + L".json" : filePath;
-            
-        std::string jsonPath = WStringToUTF8(actualPath);
-        std::ofstream file(jsonPath);
+    // 调用游戏控制器
+    // readyEventName 非空时，控制器在程序就绪后触发该事件；controllerProcess 非空时返回控制器进程句柄
+    // attachPid 非0时控制器接管该进程而不启动新进程
+    bool CallGameController(const ProgramConfig& config, const std::wstring& readyEventName = L"",
+        Platform::ProcessHandle* controllerProcess = nullptr, Platform::ProcessId attachPid = 0) {
+        // 直接使用现有的JSON配置文件，不再创建临时文件
+        auto fileIt = fileByConfigName.find(config.name);
+        std::wstring configFilePath = Platform::JoinPath(configFolderPath,
+            fileIt != fileByConfigName.end() ? fileIt->second : config.name + L".json");
+
+        Platform::SpawnRequest request;
+        request.path = gameControllerPath;
+        request.arguments = { configFilePath };
+        if (!readyEventName.empty()) request.arguments.push_back(readyEventName);
+        if (logger.IsEnabled(LogLevel::Debug)) request.arguments.insert(request.arguments.end(), { L"--log-level", L"debug" });
+        if (Platform::backgroundMode) request.arguments.push_back(L"--background");
+        if (attachPid) request.arguments.insert(request.arguments.end(), { L"--attach", std::to_wstring(attachPid) });
+        if (daemonMode) request.arguments.push_back(L"--headless");
+        request.newConsole = true;  // 在新控制台窗口中启动
+
+        TraceSpan span("controller_spawn", "launch", config.name);
+        Platform::ProcessHandle process;
+        if (!Platform::Spawn(request, process)) {
+            logger.Write(LogLevel::Error, L"调用游戏控制器失败，错误代码: " + std::to_wstring(Platform::LastError()), false);
+            return false;
+        }
+        span.SetPid(process.pid);
+        if (controllerProcess) {
+            *controllerProcess = process;
+        }
+        else {
+            Platform::CloseProcess(process);
+        }
+        return true;
+    }
+
+    // 显示函数
+    void DisplayProgramInfo(const ProgramConfig& config, size_t index) {
+        std::wstring info = std::to_wstring(index + 1) + L". [Order:" + std::to_wstring(config.order) + L"] " + config.name +
+            L"\n   描述: " + config.description +
+            L"\n   路径: " + config.path;
+
+        if (config.type == ProgramType::ExeWithArgument && !config.arguments.empty()) {
+            info += L"\n   参数 (" + std::to_wstring(config.arguments.size()) + L"个): ";
+            for (size_t j = 0; j < config.arguments.size() && j < 5; j++) {
+                if (j > 0) info += L", ";
+                info += config.arguments[j];
+            }
+        }
+
+        if (config.killAfterSeconds > 0) {
+            info += L"\n   自动关闭: " + std::to_wstring(config.killAfterSeconds) + L"秒后关闭 " +
+                (config.processNameToKill.empty() ? L"已启动的进程" : config.processNameToKill);
+            if (!config.processNameToKill.empty() && config.killAnyByName) info += L"（进程树中没有时关闭所有同名进程）";
+        }
+
+        if (config.admission.Enabled()) {
+            info += L"\n   负载准入:";
+            if (config.admission.maxCpuPercent >= 0) info += L" CPU≤" + std::to_wstring(config.admission.maxCpuPercent) + L"%";
+            if (config.admission.maxDiskQueue >= 0) info += L" 磁盘队列≤" + std::to_wstring(config.admission.maxDiskQueue);
+            if (config.admission.minFreeMemoryMB > 0) info += L" 可用内存≥" + std::to_wstring(config.admission.minFreeMemoryMB) + L"MB";
+            info += L" (最长等待 " + std::to_wstring(config.admission.maxWaitMs) + L" 毫秒)";
+        }
+
+        if (config.limits.Enabled()) {
+            info += L"\n   资源上限:";
+            if (config.limits.memoryMB > 0) info += L" 内存 " + std::to_wstring(config.limits.memoryMB) + L"MB";
+            if (config.limits.cpuPercent > 0) info += L" CPU " + std::to_wstring(config.limits.cpuPercent) + L"%";
+        }
+
+        if (config.output.enabled) {
+            info += L"\n   输出日志: " + OutputCapture::LogPathIn(configFolderPath, config.name) + L" (每个 " +
+                std::to_wstring(config.output.maxKB) + L"KB, 保留 " + std::to_wstring(config.output.files) + L" 个)";
+        }
+
+        if (config.ifRunning != IfRunningPolicy::Start) {
+            info += L"\n   已在运行时: " + std::wstring(config.ifRunning == IfRunningPolicy::Skip ? L"跳过" : L"接管");
+        }
+
+        if (!config.prefetch.empty()) {
+            info += L"\n   预读: ";
+            for (size_t j = 0; j < config.prefetch.size(); j++) {
+                if (j > 0) info += L", ";
+                info += config.prefetch[j];
+            }
+        }
+
+        if (config.scheduling.Enabled()) {
+            info += L"\n   调度:";
+            if (config.scheduling.priorityClass != PriorityLevel::Default) info += L" 优先级 " + PriorityLevelToString(config.scheduling.priorityClass);
+            if (config.scheduling.ioPriority != PriorityLevel::Default) info += L" I/O " + PriorityLevelToString(config.scheduling.ioPriority);
+            if (config.scheduling.memoryPriority != PriorityLevel::Default) info += L" 内存 " + PriorityLevelToString(config.scheduling.memoryPriority);
+            if (!config.scheduling.cpuAffinity.empty()) info += L" CPU " + config.scheduling.cpuAffinity;
+        }
+
+        if (config.restart.mode != RestartMode::Never) {
+            info += L"\n   自动重启: " + RestartModeToString(config.restart.mode) + L" (连续最多 " +
+                std::to_wstring(config.restart.limit) + L" 次)";
+        }
+
+        if (config.readiness.type != ReadinessType::None) {
+            info += L"\n   就绪条件: " + ReadinessTypeToString(config.readiness.type) + L" " + config.readiness.target +
+                L" (超时 " + std::to_wstring(config.readiness.timeoutMs) + L" 毫秒)";
+        }
+
+        if (config.hasDependsOn) {
+            info += L"\n   依赖: ";
+            if (config.dependsOn.empty()) info += L"无（可立即并行启动）";
+            for (size_t j = 0; j < config.dependsOn.size(); j++) {
+                if (j > 0) info += L", ";
+                info += config.dependsOn[j];
+            }
+        }
+
+        if (config.delayMode == DelayMode::Auto) {
+            LaunchHistory::Stats stats = history.StatsOf(config.name);
+            info += L"\n   启动后等待: auto，";
+            if (stats.learnedMs < 0) {
+                info += L"历史样本不足 (" + std::to_wstring(stats.samples) + L"/" + std::to_wstring(LaunchHistory::kMinSamples) + L")，";
+            }
+            else {
+                info += L"最近 " + std::to_wstring(stats.samples) + L" 次P" + std::to_wstring(LaunchHistory::kPercentile) + L" ";
+                info += stats.learnedMs == LaunchHistory::kTimedOut ? L"超出观察期，" : std::to_wstring(stats.learnedMs) + L" 毫秒，";
+            }
+            info += L"等待 " + std::to_wstring(EntryDelay(config)) + L" 毫秒 (上限 " + std::to_wstring(config.delayAfterStart) + L")\n";
+        }
+        else {
+            info += L"\n   启动后等待: " + std::to_wstring(config.delayAfterStart) + L" 毫秒\n";
+        }
+        logger.Print(info);
+    }
+
+    // 条目启动后的等待时间：auto按启动历史，不超过delayAfterStart
+    int EntryDelay(const ProgramConfig& config) const {
+        if (config.delayMode != DelayMode::Auto) return config.delayAfterStart;
+        return history.DelayFor(config.name, config.delayAfterStart);
+    }
 
-        if (file.is_open()) {
-            file << "{\n";
-            file << "  \"order\": " << config.order << ",\n";
-            file << "  \"enabled\": " << (config.enabled ? "true" : "false") << ",\n";
-            file << "  \"path\": \"" << WStringToUTF8(config.path) << "\",\n";
-            file << "  \"type\": \"" << WStringToUTF8(ProgramTypeToString(config.type)) << "\",\n";
-            file << "  \"delayAfterStart\": " << config.delayAfterStart << ",\n";
-            file << "  \"processNameToKill\": \"" << WStringToUTF8(config.processNameToKill) << "\",\n";
-            file << "  \"killAfterSeconds\": " << config.killAfterSeconds << ",\n";
-            file << "  \"name\": \"" << WStringToUTF8(config.name) << "\",\n";
-            file << "  \"description\": \"" << WStringToUTF8(config.description) << "\",\n";
+    // 多行信息作为一条日志写出，并发启动时不会与其他程序的输出交错
+    void DisplayStartupInfo(const ProgramConfig& config, size_t index, size_t total) {
+        std::wstring info = L"准备启动 (" + std::to_wstring(index + 1) + L"/" + std::to_wstring(total) +
+            L"): [Order:" + std::to_wstring(config.order) + L"] " + config.name +
+            L"\n描述: " + config.description;
+
+        if (config.killAfterSeconds > 0) {
+            info += L"\n自动关闭: " + std::to_wstring(config.killAfterSeconds) + L"秒后关闭 " +
+                (config.processNameToKill.empty() ? L"已启动的进程" : config.processNameToKill);
+        }
+        logger.Info(info);
+    }
+
+    // 等待系统负载低于条目的准入阈值，最长maxWaitMs，超时后仍然启动
+    void WaitForAdmission(const ProgramConfig& config, int maxWaitMs) {
+        AdmissionController::Result result = admission.Check(config.admission);
+        if (result.admitted) return;
+
+        logger.Info(L"⏳ 系统负载较高，暂缓 " + config.name + L" (" + result.reason + L")");
+        {
+            TraceSpan span("admission_wait", "wait", config.name);
+            result = admission.WaitForAdmission(config.admission, maxWaitMs);
+        }
+        if (result.admitted) {
+            logger.Info(L"✓ 负载已回落: " + config.name + L" (等待 " + std::to_wstring(result.waitedMs) + L" 毫秒)");
+        }
+        else {
+            logger.Warning(L"⚠ 等待负载回落超时 (" + result.reason + L")，继续: " + config.name);
+        }
+    }
+
+    // 条目的目标是否已在运行（查本批启动前的快照）：按可执行文件完整路径匹配；
+    // 配置了processNameToKill时也按该进程名匹配（目标由启动的程序间接拉起）；
+    // 无法读取路径的进程（例如权限不足）退回按文件名匹配
+    Platform::ProcessId FindRunning(const ProgramConfig& config) const {
+        if (config.ifRunning == IfRunningPolicy::Start || !runningSnapshot) return 0;
+        std::vector<Platform::ProcessId> pids;
+        if (config.type != ProgramType::Bat) pids = runningSnapshot->FindByPath(config.path);
+        if (pids.empty() && !config.processNameToKill.empty()) pids = runningSnapshot->FindByName(config.processNameToKill);
+        if (pids.empty() && config.type != ProgramType::Bat) {
+            for (Platform::ProcessId pid : runningSnapshot->FindByName(Platform::FileNameOf(config.path))) {
+                if (!runningSnapshot->IsPathKnown(pid)) pids.push_back(pid);
+            }
+        }
+        pids.erase(std::remove(pids.begin(), pids.end(), Platform::CurrentProcessId()), pids.end());
+        return pids.empty() ? 0 : *std::min_element(pids.begin(), pids.end());
+    }
+
+    // 记录条目的启动结果（控制器需存活到定时关闭完成）
+    void SetEntryResult(size_t index, bool ok, std::unique_ptr<GameController> controller = nullptr) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (controller) controllers[index] = std::move(controller);
+        launched[index] = ok;
+    }
+
+    // 启动单个计划条目（由调度器工作线程调用）
+    bool LaunchEntry(size_t index) {
+        const auto& config = plan[index];
+        TraceRecorder::Shared().SetThreadName("launch_worker");
+        TraceSpan span("launch_entry", "launch", config.name);
+
+        Platform::ProcessId runningPid = FindRunning(config);
+        if (runningPid) {
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                runningPids[index] = runningPid;
+            }
+            if (config.ifRunning == IfRunningPolicy::Skip) {
+                logger.Info(L"⏭ 已在运行，跳过: " + config.name + L" (PID " + std::to_wstring(runningPid) + L")");
+                // 跳过的程序仍按killAfterSeconds定时关闭：接管它但不重启
+                std::unique_ptr<GameController> controller;
+                if (config.killAfterSeconds > 0) {
+                    bool attached = false;
+                    if (!useSeparateController) {
+                        controller = std::make_unique<GameController>();
+                        attached = controller->Initialize(config) && controller->Attach(runningPid);
+                        if (!attached) controller.reset();
+                    }
+                    else {
+                        attached = CallGameController(config, L"", &controllerProcesses[index], runningPid);
+                    }
+                    if (!attached) logger.Write(LogLevel::Warning, L"⚠ 无法安排定时关闭: " + config.name, false);
+                }
+                SetEntryResult(index, true, std::move(controller));
+                return true;
+            }
+            logger.Info(L"↪ 已在运行，接管: " + config.name + L" (PID " + std::to_wstring(runningPid) + L")");
+            prefetcher.NotifyLaunch(config.name);
+            bool attached = false;
+            std::unique_ptr<GameController> controller;
+            if (!useSeparateController) {
+                controller = std::make_unique<GameController>();
+                attached = controller->Initialize(config) && controller->Attach(runningPid);
+            }
+            else {
+                attached = CallGameController(config, L"", &controllerProcesses[index], runningPid);
+            }
+            if (!attached) logger.Write(LogLevel::Error, L"✗ 接管失败: " + config.name, false);
+            SetEntryResult(index, attached, std::move(controller));
+            return attached;
+        }
+
+        if (config.admission.Enabled()) WaitForAdmission(config, config.admission.maxWaitMs);
+        prefetcher.NotifyLaunch(config.name);
+        DisplayStartupInfo(config, launchedCount++, plan.size());
 
-            file << "  \"arguments\": [\n";
-            for (size_t i = 0; i < config.arguments.size(); i++) {
-                file << "    \"" << WStringToUTF8(config.arguments[i]) << "\"";
-                if (i < config.arguments.size() - 1) file << ",";
-                file << "\n";
+        if (!useSeparateController) {
+            // 进程内直接使用已解析的配置启动，不再创建控制器进程
+            auto controller = std::make_unique<GameController>();
+            controller->SetHistoryFile(LaunchHistory::LogPathIn(configFolderPath));
+            controller->SetOutputFolder(configFolderPath);
+            bool started = controller->Initialize(config) && controller->Launch();
+            if (!started) {
+                logger.Write(LogLevel::Error, L"✗ 启动失败: " + config.name, false);
             }
-            file << "  ]\n";
-            file << "}\n";
+            SetEntryResult(index, started, std::move(controller));
+            return started;
+        }
 
-            file.close();
-            std::wcout << L"✓ 已保存配置: " << actualPath << std::endl;
+        // 配置了就绪条件时，由控制器探测并通过命名事件通知
+        std::wstring readyEventName;
+        if (config.readiness.type != ReadinessType::None) {
+            readyEventName = Platform::ReadyEvent::MakeName(index);
+            readyEvents[index] = std::make_unique<Platform::ReadyEvent>();
+            if (!readyEvents[index]->Create(readyEventName)) {
+                readyEvents[index].reset();
+                readyEventName.clear();
+            }
         }
+
+        bool success = CallGameController(config, readyEventName, &controllerProcesses[index]);
+        SetEntryResult(index, success);
+
+        logger.Write(success ? LogLevel::Info : LogLevel::Error,
+            (success ? L"✓ 已启动游戏控制器: " : L"✗ 启动游戏控制器失败: ") + config.name, false);
+        return success;
     }
 
-    ProgramConfig LoadConfigFromJson(const std::wstring& jsonPath) {
-        std::string utf8Path = WStringToUTF8(jsonPath);
-        std::ifstream file(utf8Path);
-        ProgramConfig config(0, true, L"", {}, ProgramType::Exe, 2000);
+    // 等待条目就绪，之后其依赖者才会启动
+    void WaitEntryReady(size_t index) {
+        const auto& config = plan[index];
+        if (runningPids[index]) return;       // 跳过或接管的程序早已在运行
+        if (controllers[index] && config.readiness.type != ReadinessType::None) {
+            controllers[index]->WaitUntilReady();
+            return;
+        }
+
+        if (readyEvents[index]) {
+            logger.Print(L"等待 " + config.name + L" 就绪 (" + ReadinessTypeToString(config.readiness.type) + L")...\n");
+            // 控制器退出或超时也不再等待
+            bool ready = false;
+            {
+                TraceSpan span("controller_ready_wait", "wait", config.name);
+                span.SetPid(controllerProcesses[index].pid);
+                ready = readyEvents[index]->Wait(controllerProcesses[index], config.readiness.timeoutMs + 5000);
+            }
+
+            logger.Write(ready ? LogLevel::Info : LogLevel::Warning,
+                (ready ? L"✓ 已就绪: " : L"⚠ 就绪等待结束（超时或控制器已退出）: ") + config.name, false);
+            return;
+        }
 
-        if (file.is_open()) {
-            std::string line;
-            while (std::getline(file, line)) {
-                ParseJsonLine(line, config);
+        // 配置了准入阈值时等待时间只作为上限：等程序开始加载一个采样间隔后，负载回落即可继续
+        int delayMs = EntryDelay(config);
+        if (config.admission.Enabled()) {
+            int settleMs = (std::min)(admission.SampleIntervalMs(), delayMs);
+            {
+                TraceSpan span("delay_sleep", "wait", config.name);
+                std::this_thread::sleep_for(std::chrono::milliseconds(settleMs));
             }
-            file.close();
+            WaitForAdmission(config, delayMs - settleMs);
+            return;
         }
 
-        return config;
+        logger.Print(L"等待 " + (delayMs % 1000 == 0 ? std::to_wstring(delayMs / 1000) + L" 秒" : std::to_wstring(delayMs) + L" 毫秒") +
+            L"后启动依赖 " + config.name + L" 的程序...\n");
+        TraceSpan span("delay_sleep", "wait", config.name);
+        std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
     }
 
-    void ParseJsonLine(const std::string& line, ProgramConfig& config) {
-        auto extractStringValue = [&](const std::string& key) -> std::wstring {
-            size_t start = line.find("\"", line.find(key) + key.length() + 1) + 1;
-            size_t end = line.find("\"", start);
-            return (start != std::string::npos && end != std::string::npos) ?
-                UTF8ToWString(line.substr(start, end - start)) : L"";
-            };
+    // 调度器只等待有依赖者的条目就绪；其余条目的就绪探测在后台完成，以便记录启动历史
+    // （独立控制器模式下控制器自己等待就绪）
+    void ProbeReadinessInBackground(size_t index) {
+        if (runningPids[index] || !controllers[index]) return;
+        controllers[index]->WaitUntilReadyInBackground();
+    }
 
-        auto extractIntValue = [&](const std::string& key) -> int {
-            size_t pos = line.find(":");
-            if (pos != std::string::npos) {
-                std::string value = line.substr(pos + 1);
-                value.erase(0, value.find_first_not_of(" \t"));
-                value.erase(value.find_last_not_of(" \t,") + 1);
-                return std::stoi(value);
+    // 退出前汇总各程序的运行结果，失败的条目单独标出
+    void DisplayRunSummary() {
+        std::wstring summary = L"=====================================\n运行汇总:";
+        size_t failed = 0;
+        for (size_t i = 0; i < plan.size(); i++) {
+            std::wstring state;
+            bool entryFailed = false;
+            if (!launched[i]) {
+                state = L"未启动";
+                entryFailed = true;
+            }
+            else if (runningPids[i] && plan[i].ifRunning == IfRunningPolicy::Skip) {
+                state = L"已在运行 (PID " + std::to_wstring(runningPids[i]) + L")，已跳过";
+            }
+            else if (!controllers[i]) {
+                state = L"已启动（由独立控制器监督）";
             }
-            return 0;
-            };
+            else {
+                GameController::SupervisionStatus status = controllers[i]->GetSupervisionStatus();
+                if (status.restartPending) state = L"等待重启";
+                else if (!status.exited) state = L"运行中";
+                else if (status.killedOnSchedule) state = L"已定时关闭";
+                else if (!status.exitCodeKnown) state = L"已退出 (退出码未知)";
+                else state = L"已退出 (退出码 " + std::to_wstring(status.exitCode) + L")";
+                if (runningPids[i]) state = L"接管 PID " + std::to_wstring(runningPids[i]) + L"，" + state;
+                if (status.restarts > 0) state += L"，重启 " + std::to_wstring(status.restarts) + L" 次";
+                if (status.crashLoop) state += L"，连续崩溃已停止重启";
+                entryFailed = status.Failed();
+            }
+            if (entryFailed) failed++;
+            summary += std::wstring(L"\n  ") + (entryFailed ? L"✗ " : L"✓ ") + plan[i].name + L": " + state;
+        }
+        summary += L"\n失败: " + std::to_wstring(failed) + L" / " + std::to_wstring(plan.size());
+        logger.Write(failed > 0 ? LogLevel::Warning : LogLevel::Info, summary, false);
+    }
 
-        if (line.find("\"order\"") != std::string::npos) {
-            config.order = extractIntValue("\"order\"");
+    // 按依赖图启动plan[first..]，首次运行时first为0，热更新时只包含新增条目
+    void LaunchEntries(size_t first) {
+        std::vector<ProgramConfig> batch(plan.begin() + first, plan.end());
+        for (size_t i = first; i < plan.size(); i++) planIndexByName[plan[i].name] = i;
+        readyEvents.clear();
+        readyEvents.resize(plan.size());
+        controllerProcesses.assign(plan.size(), Platform::ProcessHandle());
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            controllers.resize(plan.size());
+            launched.resize(plan.size(), false);
+            runningPids.resize(plan.size(), 0);
         }
-        else if (line.find("\"enabled\"") != std::string::npos) {
-            config.enabled = (line.find("true") != std::string::npos);
+
+        // 需要判断是否已在运行的条目共用一次进程枚举（含路径），不再逐个条目枚举
+        runningSnapshot.reset();
+        if (std::any_of(batch.begin(), batch.end(), [](const ProgramConfig& c) { return c.ifRunning != IfRunningPolicy::Start; })) {
+            TraceSpan span("process_snapshot", "plan");
+            runningSnapshot = ProcessSnapshot::Capture(true);
         }
-        else if (line.find("\"path\"") != std::string::npos) {
-            config.path = extractStringValue("\"path\"");
+
+        // 构建依赖图：无依赖的程序并发启动，关键路径决定总耗时
+        LaunchGraph graph;
+        std::vector<std::wstring> warnings;
+        {
+            TraceSpan span("launch_graph", "plan");
+            graph.Build(batch, warnings);
         }
-        else if (line.find("\"type\"") != std::string::npos) {
-            config.type = StringToProgramType(extractStringValue("\"type\""));
+        for (const auto& warning : warnings) {
+            logger.Write(LogLevel::Warning, L"⚠ " + warning, false);
         }
-        else if (line.find("\"name\"") != std::string::npos) {
-            config.name = extractStringValue("\"name\"");
+
+        LaunchScheduler::Run(graph, maxParallelLaunches,
+            [&](size_t index) {
+                bool success = LaunchEntry(first + index);
+                if (success && !graph.HasDependents(index)) ProbeReadinessInBackground(first + index);
+                return success;
+            },
+            [&](size_t index) { WaitEntryReady(first + index); });
+
+        for (size_t i = first; i < plan.size(); i++) {
+            readyEvents[i].reset();
+            Platform::CloseProcess(controllerProcesses[i]);
         }
-        else if (line.find("\"description\"") != std::string::npos) {
-            config.description = extractStringValue("\"description\"");
+
+        for (size_t i = 0; i < graph.Size(); i++) {
+            if (graph.State(i) == LaunchGraph::NodeState::Skipped) {
+                logger.Write(LogLevel::Warning, L"✗ 未启动（依赖失败或循环依赖）: " + batch[i].name, false);
+            }
         }
-        else if (line.find("\"processNameToKill\"") != std::string::npos) {
-            config.processNameToKill = extractStringValue("\"processNameToKill\"");
+    }
+
+    // 监视线程：只重新解析发生变化的文件，并增量更新正在执行的计划
+    void WatchConfigFolder() {
+        std::vector<ConfigWatcher::Change> changes;
+        while (watcher.WaitForChanges(changes)) {
+            // 通知缓冲区溢出时才退回到重新扫描整个文件夹
+            if (std::any_of(changes.begin(), changes.end(),
+                [](const ConfigWatcher::Change& change) { return change.fileName.empty(); })) {
+                changes = RescanChanges();
+            }
+            std::vector<ProgramConfig> added = CollectChanges(changes);
+            if (!added.empty()) LaunchAdded(std::move(added));
         }
-        else if (line.find("\"killAfterSeconds\"") != std::string::npos) {
-            config.killAfterSeconds = extractIntValue("\"killAfterSeconds\"");
+    }
+
+    // 把整个文件夹视为已修改，已知但不再存在的文件视为已删除
+    std::vector<ConfigWatcher::Change> RescanChanges() {
+        std::vector<ConfigWatcher::Change> changes;
+        std::unordered_set<std::wstring> present;
+        for (const auto& file : ConfigLoader::ListJsonFiles(configFolderPath)) {
+            present.insert(file.fileName);
+            changes.push_back({ file.fileName, ConfigWatcher::ChangeKind::Modified });
         }
-        else if (line.find("\"delayAfterStart\"") != std::string::npos) {
-            config.delayAfterStart = extractIntValue("\"delayAfterStart\"");
+        for (const auto& known : configNameByFile) {
+            if (!present.count(known.first)) changes.push_back({ known.first, ConfigWatcher::ChangeKind::Removed });
         }
+        return changes;
     }
 
-    // 配置管理函数
-    void InitializeConfigFolder() {
-        wchar_t exePath[MAX_PATH];
-        GetModuleFileNameW(NULL, exePath, MAX_PATH);
-        std::wstring exeDir = exePath;
-        exeDir = exeDir.substr(0, exeDir.find_last_of(L"\\/"));
+    // 将变化应用到计划中已启动的条目，返回需要新启动的条目（按order排序）
+    std::vector<ProgramConfig> CollectChanges(const std::vector<ConfigWatcher::Change>& changes) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        std::vector<ProgramConfig> added;
+        for (const auto& change : changes) {
+            ApplyConfigChange(change, added);
+        }
 
-        // 使用可自定义的文件夹名称
-        configFolderPath = exeDir + L"\\" + configFolderName;
-        CreateDirectoryW(configFolderPath.c_str(), NULL);
-        
-        // 使用可自定义的游戏控制器名称
-        gameControllerPath = exeDir + L"\\" + gameControllerName;
+        // 新条目依赖的已启动程序视为已满足，只在新条目之间建立依赖
+        std::sort(added.begin(), added.end(),
+            [](const ProgramConfig& a, const ProgramConfig& b) { return a.order < b.order; });
+        for (auto& config : added) {
+            config.dependsOn.erase(std::remove_if(config.dependsOn.begin(), config.dependsOn.end(),
+                [&](const std::wstring& dependency) {
+                    auto it = planIndexByName.find(dependency);
+                    return it != planIndexByName.end() && launched[it->second];
+                }), config.dependsOn.end());
+        }
+        return added;
     }
 
-    void LoadConfigsFromFolder() {
-        WIN32_FIND_DATAW findFileData;
-        HANDLE hFind = FindFirstFileW((configFolderPath + L"\\*.json").c_str(), &findFileData);
-
-        if (hFind != INVALID_HANDLE_VALUE) {
-            do {
-                if (!(findFileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
-                    std::wstring fileName = findFileData.cFileName;
-                    std::wstring configName = fileName.substr(0, fileName.find_last_of(L'.'));
-
-                    bool exists = std::any_of(programs.begin(), programs.end(),
-                        [&](const ProgramConfig& c) { return c.name == configName; });
-
-                    if (!exists) {
-                        std::wstring jsonPath = configFolderPath + L"\\" + fileName;
-                        programs.push_back(LoadConfigFromJson(jsonPath));
-                        std::wcout << L"✓ 从文件加载配置: " << configName << std::endl;
-                    }
-                }
-            } while (FindNextFileW(hFind, &findFileData));
-            FindClose(hFind);
+    // 把新条目追加到计划末尾并启动
+    void LaunchAdded(std::vector<ProgramConfig> added) {
+        logger.Print(L"=====================================\n配置更新：新增 " + std::to_wstring(added.size()) + L" 个程序");
+        if (!PreflightPlan(added)) return;
+        size_t first;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            first = plan.size();
+            plan.insert(plan.end(), added.begin(), added.end());
         }
+        LaunchEntries(first);
     }
 
-    // 调用游戏控制器
-    bool CallGameController(const ProgramConfig& config) {
-        // 直接使用现有的JSON配置文件，不再创建临时文件
-        std::wstring configFilePath = configFolderPath + L"\\" + config.name + L".json";
-        
-        // 构建命令行
-        std::wstring commandLine = L"\"" + gameControllerPath + L"\" \"" + configFilePath + L"\"";
-        
-        STARTUPINFOW si = { sizeof(si) };
-        PROCESS_INFORMATION pi;
-        
-        BOOL success = CreateProcessW(
-            NULL,
-            const_cast<LPWSTR>(commandLine.c_str()),
-            NULL,
-            NULL,
-            FALSE,
-            CREATE_NEW_CONSOLE,  // 在新控制台窗口中启动
-            NULL,
-            NULL,
-            &si,
-            &pi
-        );
-
-        if (success) {
-            CloseHandle(pi.hProcess);
-            CloseHandle(pi.hThread);
-            return true;
-        } else {
-            std::cerr << "调用游戏控制器失败，错误代码: " << GetLastError() << std::endl;
-            return false;
+    // 处理单个文件的变化；需要新启动的条目加入added
+    void ApplyConfigChange(const ConfigWatcher::Change& change, std::vector<ProgramConfig>& added) {
+        ProgramConfig updated(0, true, L"", {}, ProgramType::Exe, 2000);
+        bool present = change.kind == ConfigWatcher::ChangeKind::Modified;
+        if (present) {
+            std::string error;
+            if (!ConfigLoader::LoadFile(Platform::JoinPath(configFolderPath, change.fileName), updated, error)) {
+                // 文件可能正在被删除或写入，保持原配置
+                logger.Write(LogLevel::Error, L"✗ 配置解析失败，保持原配置: " + change.fileName +
+                    L" (" + TextEncoding::Utf8ToWide(error) + L")", false);
+                return;
+            }
+        }
+
+        // 文件删除或配置改名时，原条目按禁用处理
+        auto fileIt = configNameByFile.find(change.fileName);
+        if (fileIt != configNameByFile.end() && (!present || fileIt->second != updated.name)) {
+            auto planIt = planIndexByName.find(fileIt->second);
+            if (planIt != planIndexByName.end()) {
+                ProgramConfig disabled = plan[planIt->second];
+                disabled.enabled = false;
+                UpdateEntry(disabled, added);
+            }
+            fileByConfigName.erase(fileIt->second);
+            configNameByFile.erase(fileIt);
         }
+        if (!present) return;
+
+        auto ownerIt = fileByConfigName.find(updated.name);
+        if (ownerIt != fileByConfigName.end() && ownerIt->second != change.fileName) {
+            logger.Write(LogLevel::Warning, L"⚠ 配置名称重复，已忽略: " + change.fileName, false);
+            return;
+        }
+        configNameByFile[change.fileName] = updated.name;
+        fileByConfigName[updated.name] = change.fileName;
+        UpdateEntry(updated, added);
     }
 
-    // 显示函数
-    void DisplayProgramInfo(const ProgramConfig& config, size_t index, size_t total) {
-        std::cout << index + 1 << ". [Order:" << config.order << "] ";
-        PrintWString(config.name);
-        std::cout << std::endl;
+    // 将新配置应用到计划中的同名条目：禁用则取消定时关闭，关闭时间变化则重新安排
+    void UpdateEntry(const ProgramConfig& updated, std::vector<ProgramConfig>& added) {
+        auto planIt = planIndexByName.find(updated.name);
+        if (planIt == planIndexByName.end() || !launched[planIt->second]) {
+            if (updated.enabled) {
+                added.erase(std::remove_if(added.begin(), added.end(),
+                    [&](const ProgramConfig& c) { return c.name == updated.name; }), added.end());
+                added.push_back(updated);
+            }
+            return;
+        }
 
-        std::cout << "   描述: ";
-        PrintWString(config.description);
-        std::cout << std::endl;
+        size_t index = planIt->second;
+        ProgramConfig& current = plan[index];
+        bool enabledChanged = current.enabled != updated.enabled;
+        bool killChanged = current.killAfterSeconds != updated.killAfterSeconds;
 
-        std::cout << "   路径: ";
-        PrintWString(config.path);
-        std::cout << std::endl;
+        ProgramConfig comparable = updated;
+        comparable.enabled = current.enabled;
+        comparable.killAfterSeconds = current.killAfterSeconds;
+        bool otherChanged = updated.enabled && !LaunchPlanCache::SameConfig(comparable, current);
 
-        if (config.type == ProgramType::ExeWithArgument && !config.arguments.empty()) {
-            std::cout << "   参数 (" << config.arguments.size() << "个): ";
-            for (size_t j = 0; j < config.arguments.size() && j < 5; j++) {
-                if (j > 0) std::cout << ", ";
-                PrintWString(config.arguments[j]);
+        std::wstring message;
+        if (useSeparateController) {
+            if (enabledChanged || killChanged) message = L"⚠ 独立控制器模式下无法修改已启动程序的定时关闭: ";
+        }
+        else if (!controllers[index]) {
+            // 跳过且未接管的程序（未配置定时关闭或接管失败）：没有控制器，修改在下次启动时生效
+            if (enabledChanged || killChanged) message = L"⚠ 已跳过的程序未被接管，无法修改定时关闭: ";
+        }
+        else if (!updated.enabled) {
+            if (controllers[index]->CancelKill()) message = L"✓ 已禁用，取消定时关闭: ";
+        }
+        else if (enabledChanged || killChanged) {
+            controllers[index]->UpdateKillAfter(updated.killAfterSeconds);
+            message = L"✓ 定时关闭已更新: ";
+        }
+        current = updated;
+
+        if (!message.empty()) {
+            message += updated.name;
+            if (!useSeparateController && controllers[index] && updated.enabled) {
+                if (updated.killAfterSeconds > 0) message += L" (启动后 " + std::to_wstring(updated.killAfterSeconds) + L" 秒)";
+                else message += L" (不再自动关闭)";
             }
-            std::cout << std::endl;
+            logger.Print(message);
+        }
+        if (otherChanged) {
+            logger.Print(L"   " + updated.name + L" 的其他修改将在下次启动时生效");
         }
+    }
 
-        if (config.killAfterSeconds > 0 && !config.processNameToKill.empty()) {
-            std::cout << "   自动关闭: " << config.killAfterSeconds << "秒后关闭 ";
-            PrintWString(config.processNameToKill);
-            std::cout << std::endl;
+    // 显示设置信息；独立控制器模式下找不到控制器时返回false
+    bool DisplayHeader() {
+        logger.Print(L"游戏控制器: " + gameControllerName + L"\n配置文件夹: " + configFolderName);
+
+        // 检查游戏控制器是否存在（仅独立控制器模式需要）
+        if (useSeparateController && !Platform::FileExists(gameControllerPath)) {
+            logger.Write(LogLevel::Error, L"错误: 未找到 " + gameControllerName + L"，请确保它与主程序在同一目录下。", false);
+            return false;
         }
 
-        std::cout << "   启动后等待: " << config.delayAfterStart << " 毫秒" << std::endl;
-        std::cout << std::endl;
+        // 显示标题和特性
+        logger.Print(std::wstring(L"游戏助手启动器 v4.0 - ") + (useSeparateController ? L"分布式控制版" : L"单进程控制版") +
+            L"\n配置文件夹: " + configFolderPath + L"\n");
+        return true;
     }
 
-    void DisplayStartupInfo(const ProgramConfig& config, size_t index, size_t total) {
-        std::cout << "[" << GetCurrentTime() << "] 准备启动 (" << index + 1 << "/" << total
-            << "): [Order:" << config.order << "] ";
-        PrintWString(config.name);
-        std::cout << std::endl;
+    // 由programs生成新的启动计划并显示；上一次运行的控制器被释放（其未执行的定时关闭随之取消）
+    void BuildPlan() {
+        std::vector<ProgramConfig> built;
+        {
+            TraceSpan span("plan_build", "plan");
+            built = programs;
+            built.erase(std::remove_if(built.begin(), built.end(),
+                [](const ProgramConfig& c) { return !c.enabled; }), built.end());
+
+            std::sort(built.begin(), built.end(),
+                [](const ProgramConfig& a, const ProgramConfig& b) { return a.order < b.order; });
+        }
+
+        // 合并上次运行以来追加的启动历史（只读取汇总之后的部分）
+        {
+            TraceSpan span("history_load", "plan");
+            if (!history.Load(configFolderPath)) {
+                logger.Write(LogLevel::Warning, L"⚠ 启动历史读取失败，auto等待使用配置值", false);
+            }
+        }
+
+        std::vector<std::unique_ptr<GameController>> previous;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            plan = std::move(built);
+            previous.swap(controllers);
+            controllers.resize(plan.size());
+            launched.assign(plan.size(), false);
+            runningPids.assign(plan.size(), 0);
+            planIndexByName.clear();
+            launchedCount = 0;
+        }
+        previous.clear();
+
+        // 显示配置信息
+        logger.Print(L"当前启用的程序配置 (" + std::to_wstring(plan.size()) + L"个):\n=====================================");
+
+        for (size_t i = 0; i < plan.size(); i++) {
+            DisplayProgramInfo(plan[i], i);
+        }
+    }
+
+    // 启动前并发检查batch中的所有条目，问题一次报告；严格模式下有错误时返回false，此时不应启动任何条目
+    bool PreflightPlan(const std::vector<ProgramConfig>& batch) {
+        PlanValidator validator;
+        std::vector<PlanValidator::Issue> issues = validator.Validate(batch);
+        if (issues.empty()) return true;
+        bool errors = PlanValidator::HasErrors(issues);
+        logger.Write(errors ? LogLevel::Error : LogLevel::Warning, PlanValidator::Report(batch, issues), false);
+        if (!errors || !strictPreflight) return true;
+        logger.Write(LogLevel::Error, L"✗ 严格模式：预检未通过，未启动任何程序", false);
+        return false;
+    }
 
-        std::cout << "描述: ";
-        PrintWString(config.description);
-        std::cout << std::endl;
+    // 执行BuildPlan生成的计划，返回时所有条目均已启动（或失败）
+    void LaunchPlan() {
+        // 预读与启动同时进行，按启动顺序读取，尽量在每个程序启动之前读完它的文件
+        if (usePrefetch) {
+            TraceSpan span("prefetch_plan", "plan");
+            prefetcher.Start(plan, prefetchThreads, prefetchBandwidthMBps);
+            logger.Print(L"预读 " + std::to_wstring(prefetcher.FileCount()) + L" 个文件 (带宽上限 " +
+                (prefetchBandwidthMBps > 0 ? std::to_wstring(prefetchBandwidthMBps) + L" MB/s)" : L"无)"));
+        }
+
+        // 启动程序
+        logger.Print(L"=====================================\n开始启动程序...\n");
+        LaunchEntries(0);
+        logger.Print(L"=====================================\n所有程序启动完成！");
 
-        if (config.killAfterSeconds > 0 && !config.processNameToKill.empty()) {
-            std::cout << "自动关闭: " << config.killAfterSeconds << "秒后关闭 ";
-            PrintWString(config.processNameToKill);
-            std::cout << std::endl;
+        if (usePrefetch) {
+            Prefetcher::Report report = prefetcher.Finish();
+            std::wstring summary = L"预读: " + std::to_wstring(report.files) + L" 个文件, " +
+                std::to_wstring(report.bytes / (1024 * 1024)) + L" MB, 用时 " + std::to_wstring(report.elapsedMs) +
+                L" 毫秒; " + std::to_wstring(report.entriesReady) + L"/" + std::to_wstring(report.entries) +
+                L" 个程序启动前已完成预读, 节省约 " + std::to_wstring(report.savedMs) + L" 毫秒磁盘读取";
+            if (report.skippedFiles > 0) summary += L"\n  程序已先启动而跳过: " + std::to_wstring(report.skippedFiles) + L" 个文件";
+            if (report.failedFiles > 0) summary += L"\n  无法读取: " + std::to_wstring(report.failedFiles) + L" 个文件";
+            logger.Write(report.failedFiles > 0 ? LogLevel::Warning : LogLevel::Info, summary, false);
         }
     }
 
-    std::string GetCurrentTime() {
-        SYSTEMTIME st;
-        GetLocalTime(&st);
-        char buffer[64];
-        sprintf_s(buffer, sizeof(buffer), "%02d:%02d:%02d", st.wHour, st.wMinute, st.wSecond);
-        return std::string(buffer);
+    void WriteMetrics() {
+        if (!metricsFilePath.empty() && !Metrics::Shared().WriteTextFile(metricsFilePath)) {
+            logger.Write(LogLevel::Warning, L"⚠ 指标文件写入失败: " + metricsFilePath, false);
+        }
+    }
+
+    // 退出时写出启动时间线、负载记录和指标
+    void WriteRunRecords() {
+        WriteMetrics();
+        if (!traceFilePath.empty()) {
+            logger.Print((TraceRecorder::Shared().WriteChromeTrace(traceFilePath) ?
+                L"✓ 启动时间线已写入: " : L"✗ 启动时间线写入失败: ") + traceFilePath);
+        }
+        if (!loadRecordPath.empty()) {
+            logger.Print((admission.SaveRecording(loadRecordPath) ?
+                L"✓ 负载记录已写入: " : L"✗ 负载记录写入失败: ") + loadRecordPath);
+        }
+    }
+
+    // 重新读取配置文件夹（守护模式每次run之前），修改配置无需重启守护进程
+    void ReloadPrograms() {
+        programs.clear();
+        configNameByFile.clear();
+        fileByConfigName.clear();
+        InitializePrograms();
+    }
+
+    // 守护模式的命令处理（在控制通道的连接线程上执行），每条命令回复一行JSON
+    std::string HandleCommand(const std::string& line) {
+        std::istringstream words(line);
+        std::string command, argument;
+        words >> command;
+        std::getline(words >> std::ws, argument);
+
+        if (command == "ping") return "{\"ok\":true}";
+        if (command == "status") return StatusReply();
+        if (command == "run") return RunReply();
+        if (command == "stop") return StopReply(TextEncoding::Utf8ToWide(argument));
+        if (command == "reload") return ReloadReply();
+        if (command == "shutdown") {
+            std::lock_guard<std::mutex> lock(daemonMutex);
+            shutdownRequested = true;
+            daemonCondition.notify_all();
+            return "{\"ok\":true}";
+        }
+        return ErrorReply("unknown command");
+    }
+
+    static std::string ErrorReply(const char* message) {
+        return std::string("{\"ok\":false,\"error\":\"") + message + "\"}";
+    }
+
+    // 占用守护进程（加载配置或启动批次期间不接受新的run/reload），已被占用时返回false
+    bool TryBeginWork() {
+        std::lock_guard<std::mutex> lock(daemonMutex);
+        if (busy) return false;
+        busy = true;
+        return true;
+    }
+
+    void EndWork() {
+        std::lock_guard<std::mutex> lock(daemonMutex);
+        busy = false;
+    }
+
+    // 在launchThread上执行启动，完成后解除占用；调用者须已通过TryBeginWork占用
+    void StartLaunchThread(std::function<void()> work) {
+        if (launchThread.joinable()) launchThread.join();     // 上一批次已结束
+        launchThread = std::thread([this, work]() {
+            TraceRecorder::Shared().SetThreadName("daemon_launch");
+            work();
+            WriteMetrics();
+            EndWork();
+        });
+    }
+
+    // run：重新读取配置并按新计划启动；已有的运行被新计划取代
+    std::string RunReply() {
+        if (!TryBeginWork()) return ErrorReply("busy");
+        ReloadPrograms();
+        BuildPlan();
+        if (!PreflightPlan(plan)) {
+            EndWork();
+            return ErrorReply("preflight failed");
+        }
+        int run;
+        {
+            std::lock_guard<std::mutex> lock(daemonMutex);
+            run = ++runCount;
+        }
+        size_t entries = plan.size();
+        StartLaunchThread([this]() { LaunchPlan(); });
+        return "{\"ok\":true,\"run\":" + std::to_string(run) + ",\"entries\":" + std::to_string(entries) + "}";
+    }
+
+    // reload：尚未运行时只重新读取配置；已有运行时按热更新路径应用修改，新增条目在后台启动
+    std::string ReloadReply() {
+        if (!TryBeginWork()) return ErrorReply("busy");
+        bool hasRun;
+        {
+            std::lock_guard<std::mutex> lock(daemonMutex);
+            hasRun = runCount > 0;
+        }
+        if (!hasRun) {
+            ReloadPrograms();
+            EndWork();
+            return "{\"ok\":true,\"programs\":" + std::to_string(programs.size()) + "}";
+        }
+
+        std::vector<ProgramConfig> added = CollectChanges(RescanChanges());
+        size_t count = added.size();
+        if (count == 0) EndWork();
+        else StartLaunchThread([this, added]() { LaunchAdded(added); });
+        return "{\"ok\":true,\"added\":" + std::to_string(count) + "}";
+    }
+
+    // stop [名称]：立即关闭指定条目（不指定时关闭全部），之后不再重启；仅进程内控制器支持
+    std::string StopReply(const std::wstring& name) {
+        if (useSeparateController) return ErrorReply("stop requires in-process controllers");
+        std::lock_guard<std::mutex> lock(stateMutex);
+        size_t matched = 0, stopped = 0;
+        for (size_t i = 0; i < plan.size() && i < controllers.size(); i++) {
+            if (!name.empty() && plan[i].name != name) continue;
+            matched++;
+            if (controllers[i] && controllers[i]->RequestStop()) stopped++;
+        }
+        if (!name.empty() && matched == 0) return ErrorReply("unknown entry");
+        if (!name.empty() && stopped == 0) return ErrorReply("not running");
+        return "{\"ok\":true,\"stopped\":" + std::to_string(stopped) + "}";
+    }
+
+    // status：守护进程状态和各条目状态
+    // 条目状态: pending failed skipped running restarting exited closed crash-loop，独立控制器模式下为controller
+    std::string StatusReply() {
+        bool launching;
+        int runs;
+        {
+            std::lock_guard<std::mutex> lock(daemonMutex);
+            launching = busy;
+            runs = runCount;
+        }
+        std::string reply = "{\"ok\":true,\"state\":\"";
+        reply += launching ? "launching" : runs == 0 ? "idle" : "running";
+        reply += "\",\"runs\":" + std::to_string(runs) + ",\"entries\":[";
+
+        std::lock_guard<std::mutex> lock(stateMutex);
+        for (size_t i = 0; i < plan.size(); i++) {
+            bool started = i < launched.size() && launched[i];
+            Platform::ProcessId runningPid = i < runningPids.size() ? runningPids[i] : 0;
+            GameController* controller = i < controllers.size() ? controllers[i].get() : nullptr;
+
+            const char* state;
+            Platform::ProcessId pid = 0;
+            int restarts = 0;
+            bool exited = false;
+            int exitCode = 0;
+            if (!started) {
+                state = launching ? "pending" : "failed";
+            }
+            else if (runningPid && plan[i].ifRunning == IfRunningPolicy::Skip) {
+                state = "skipped";
+                pid = runningPid;
+            }
+            else if (!controller) {
+                state = "controller";
+            }
+            else {
+                GameController::SupervisionStatus status = controller->GetSupervisionStatus();
+                state = status.crashLoop ? "crash-loop" : status.restartPending ? "restarting" :
+                    !status.exited ? "running" : status.killedOnSchedule ? "closed" : "exited";
+                pid = status.pid;
+                restarts = status.restarts;
+                exited = status.exited && status.exitCodeKnown;   // 接管的进程不报告退出码
+                exitCode = status.exitCode;
+            }
+
+            if (i > 0) reply += ",";
+            reply += "{\"name\":";
+            AppendJsonString(reply, plan[i].name);
+            reply += ",\"state\":\"" + std::string(state) + "\",\"pid\":" + std::to_string(pid) +
+                ",\"restarts\":" + std::to_string(restarts);
+            if (exited) reply += ",\"exitCode\":" + std::to_string(exitCode);
+            reply += "}";
+        }
+        reply += "]}";
+        return reply;
     }
 
 public:
@@ -329,27 +1058,150 @@ public:
     void SetGameControllerName(const std::wstring& name) {
         gameControllerName = name;
         // 重新初始化路径
-        wchar_t exePath[MAX_PATH];
-        GetModuleFileNameW(NULL, exePath, MAX_PATH);
-        std::wstring exeDir = exePath;
-        exeDir = exeDir.substr(0, exeDir.find_last_of(L"\\/"));
-        gameControllerPath = exeDir + L"\\" + gameControllerName;
+        gameControllerPath = Platform::JoinPath(Platform::ExecutableDirectory(), gameControllerName);
+    }
+
+    // 独立控制器模式：每个程序由单独的GameController.exe进程负责
+    void SetUseSeparateController(bool separate) {
+        useSeparateController = separate;
+    }
+
+    void SetMaxParallelLaunches(int count) {
+        maxParallelLaunches = count < 1 ? 1 : count;
     }
 
     void SetConfigFolderName(const std::wstring& name) {
         configFolderName = name;
         // 重新初始化配置文件夹路径
-        wchar_t exePath[MAX_PATH];
-        GetModuleFileNameW(NULL, exePath, MAX_PATH);
-        std::wstring exeDir = exePath;
-        exeDir = exeDir.substr(0, exeDir.find_last_of(L"\\/"));
-        configFolderPath = exeDir + L"\\" + configFolderName;
-        CreateDirectoryW(configFolderPath.c_str(), NULL);
+        configFolderPath = Platform::JoinPath(Platform::ExecutableDirectory(), configFolderName);
+        Platform::MakeDirectory(configFolderPath);
+    }
+
+    // 启动完成后监视配置文件夹，修改即时应用到运行中的计划
+    void SetWatchConfigFolder(bool watch) {
+        watchConfigFolder = watch;
+    }
+
+    void SetUsePlanCache(bool use) {
+        usePlanCache = use;
+    }
+
+    // 日志级别，debug时输出配置解析详情；独立控制器进程使用同一级别
+    void SetLogLevel(LogLevel level) {
+        logger.SetLevel(level);
+    }
+
+    void SetLogFile(const std::wstring& path) {
+        if (!logger.OpenFile(path)) {
+            logger.Write(LogLevel::Warning, L"⚠ 无法打开日志文件: " + path, false);
+        }
+    }
+
+    // 记录启动时间线（Chrome Trace Event JSON），需在InitializePrograms之前调用以包含配置加载
+    void SetTraceFile(const std::wstring& path) {
+        traceFilePath = path;
+        if (path.empty()) return;
+        TraceRecorder::Shared().Enable();
+        TraceRecorder::Shared().SetThreadName("main");
+    }
+
+    // 负载准入改为回放记录的负载（格式见ReplayLoadSource），用于复现和调试准入策略
+    bool SetLoadReplay(const std::wstring& path) {
+        ReplayLoadSource replay;
+        std::string error;
+        if (!replay.Load(path, error)) {
+            logger.Write(LogLevel::Error, L"✗ 无法读取负载记录: " + path + L" (" + TextEncoding::Utf8ToWide(error) + L")", false);
+            return false;
+        }
+        admission.SetLoadSource(std::move(replay));
+        return true;
+    }
+
+    // 写出Prometheus文本格式的指标（供node_exporter的textfile collector读取，文件名须以.prom结尾）
+    void SetMetricsFile(const std::wstring& path) {
+        metricsFilePath = path;
+    }
+
+    void SetMetricsInterval(int seconds) {
+        metricsIntervalSeconds = (std::max)(seconds, 0);
+    }
+
+    // 记录负载准入使用的每次采样，退出时写出，可供--load-replay回放
+    void SetLoadRecordFile(const std::wstring& path) {
+        loadRecordPath = path;
+        if (!path.empty()) admission.StartRecording();
+    }
+
+    // 启动器（及其启动的控制器）以后台优先级运行，不与正在启动的程序争抢CPU和磁盘；
+    // 启动的程序仍按normal（或条目配置的优先级）运行
+    void SetBackgroundMode() {
+        if (!Platform::EnterBackgroundMode()) {
+            logger.Write(LogLevel::Warning, L"⚠ 无法降低启动器优先级", false);
+        }
+    }
+
+    // 守护模式：Run改为RunDaemon，由控制命令启动计划；独立控制器以无界面模式运行
+    void SetDaemonMode(bool enabled) {
+        daemonMode = enabled;
+    }
+
+    // 控制通道名称，守护进程与--ctl须一致
+    void SetControlName(const std::wstring& name) {
+        controlName = name;
+    }
+
+    // 启动前的预读阶段；bandwidthMBps为0时不限速
+    void SetPrefetch(bool enabled, int bandwidthMBps = 64) {
+        usePrefetch = enabled;
+        prefetchBandwidthMBps = (std::max)(bandwidthMBps, 0);
+    }
+
+    // 输出启动计划缓存内容
+    bool DumpPlanCache() {
+        std::string error;
+        if (!LaunchPlanCache::Dump(GetPlanCachePath(), std::cout, error)) {
+            std::cout << "✗ 无法读取启动计划缓存: " << error << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // 校验启动计划缓存与配置文件夹是否一致
+    bool VerifyPlanCache() {
+        return LaunchPlanCache::Verify(GetPlanCachePath(), configFolderPath, std::cout);
+    }
+
+    // 模拟启动：与实际启动相同地加载配置、启动历史并构建依赖图，但用虚拟时钟和假的启动执行调度，
+    // 不创建进程也不真实等待；useHistory为false时所有耗时都按配置值；严格预检未通过时返回false
+    bool Simulate(bool useHistory) {
+        SetConsoleUTF8();
+        BuildPlan();
+        if (!PreflightPlan(plan)) return false;
+
+        LaunchGraph graph;
+        std::vector<std::wstring> warnings;
+        graph.Build(plan, warnings);
+        for (const auto& warning : warnings) {
+            logger.Write(LogLevel::Warning, L"⚠ " + warning, false);
+        }
+
+        std::vector<LaunchSimulator::EntryModel> models;
+        models.reserve(plan.size());
+        for (const auto& config : plan) {
+            models.push_back(LaunchSimulator::ModelFor(config, useHistory ? &history : nullptr));
+        }
+        LaunchSimulator::Result result = LaunchSimulator::Run(plan, models, graph, maxParallelLaunches);
+        logger.Print(L"=====================================\n" + LaunchSimulator::Report(plan, models, result, maxParallelLaunches));
+        return true;
+    }
+
+    // 严格预检：任一条目有错误（文件不存在、order重复等）时整批不启动
+    void SetStrictPreflight(bool strict) {
+        strictPreflight = strict;
     }
 
     void SetConsoleUTF8() {
-        SetConsoleOutputCP(65001);
-        SetConsoleCP(65001);
+        Platform::SetConsoleUtf8();
     }
 
     void InitializePrograms() {
@@ -366,91 +1218,208 @@ public:
         LoadConfigsFromFolder();
     }
 
-    void Run() {
+    // 找不到控制器或严格预检未通过时返回false
+    bool Run() {
         SetConsoleUTF8();
-        SetConsoleTitleW(L"游戏助手启动器 - 主控制器");
-
-        // 显示自定义设置信息
-        std::cout << "游戏控制器: ";
-        PrintWString(gameControllerName);
-        std::cout << std::endl;
-        std::cout << "配置文件夹: ";
-        PrintWString(configFolderName);
-        std::cout << std::endl;
-
-        // 检查游戏控制器是否存在
-        if (GetFileAttributesW(gameControllerPath.c_str()) == INVALID_FILE_ATTRIBUTES) {
-            std::wcout << L"错误: 未找到 " << gameControllerName << L"，请确保它与主程序在同一目录下。" << std::endl;
-            std::cout << "按任意键退出..." << std::endl;
-            std::cin.get();
-            return;
+        Platform::SetConsoleTitleText(L"游戏助手启动器 - 主控制器");
+        if (!DisplayHeader()) {
+            GameController::WaitForKey(L"按任意键退出...");
+            return false;
         }
 
-        // 显示标题和特性
-        std::cout << "游戏助手启动器 v4.0 - 分布式控制版" << std::endl;
-        std::cout << "配置文件夹: ";
-        PrintWString(configFolderPath);
-        std::cout << std::endl << std::endl;
+        BuildPlan();
+        if (!PreflightPlan(plan)) {
+            GameController::WaitForKey(L"按任意键退出...");
+            return false;
+        }
 
-        // 过滤和排序程序
-        auto enabledPrograms = programs;
-        enabledPrograms.erase(std::remove_if(enabledPrograms.begin(), enabledPrograms.end(),
-            [](const ProgramConfig& c) { return !c.enabled; }), enabledPrograms.end());
+        // 监视模式下先开始监视，启动过程中的修改也不会遗漏
+        bool watching = watchConfigFolder && watcher.Start(configFolderPath);
+        if (watchConfigFolder && !watching) {
+            logger.Write(LogLevel::Warning, L"⚠ 无法监视配置文件夹，热更新已关闭", false);
+        }
 
-        std::sort(enabledPrograms.begin(), enabledPrograms.end(),
-            [](const ProgramConfig& a, const ProgramConfig& b) { return a.order < b.order; });
+        LaunchPlan();
+        WriteMetrics();
 
-        // 显示配置信息
-        std::cout << "当前启用的程序配置 (" << enabledPrograms.size() << "个):" << std::endl;
-        std::cout << "=====================================" << std::endl;
+        bool hasPendingKill = std::any_of(plan.begin(), plan.end(),
+            [](const ProgramConfig& c) { return c.killAfterSeconds > 0 || c.restart.mode != RestartMode::Never; });
+        if (!useSeparateController && (hasPendingKill || watching)) {
+            logger.Print(L"启动器将保持运行以执行定时关闭和自动重启，提前退出将取消未执行的任务。");
+        }
 
-        for (size_t i = 0; i < enabledPrograms.size(); i++) {
-            DisplayProgramInfo(enabledPrograms[i], i, enabledPrograms.size());
+        std::thread watchThread;
+        if (watching) {
+            logger.Print(L"正在监视配置文件夹，修改将即时生效...");
+            watchThread = std::thread([this]() { WatchConfigFolder(); });
         }
 
-        // 启动程序
-        std::cout << "=====================================" << std::endl;
-        std::cout << "开始启动程序..." << std::endl << std::endl;
+        GameController::WaitForKey(L"按任意键退出...");
 
-        for (size_t i = 0; i < enabledPrograms.size(); i++) {
-            const auto& config = enabledPrograms[i];
-            DisplayStartupInfo(config, i, enabledPrograms.size());
+        if (watchThread.joinable()) {
+            watcher.Stop();
+            watchThread.join();
+        }
+        watcher.Close();
+        DisplayRunSummary();
+        WriteRunRecords();
+        return true;
+    }
 
-            if (CallGameController(config)) {
-                std::cout << "✓ 已启动游戏控制器: ";
-                PrintWString(config.name);
-                std::cout << std::endl;
-            } else {
-                std::cout << "✗ 启动游戏控制器失败: ";
-                PrintWString(config.name);
-                std::cout << std::endl;
-            }
+    // 守护模式：不立即启动，常驻等待控制通道上的命令，直到收到shutdown
+    // 控制线程阻塞在管道/套接字上，空闲时不占用CPU
+    bool RunDaemon() {
+        SetConsoleUTF8();
+        Platform::SetConsoleTitleText(L"游戏助手启动器 - 守护模式");
+        if (!DisplayHeader()) return false;
 
-            if (i < enabledPrograms.size() - 1) {
-                int delaySeconds = config.delayAfterStart / 1000;
-                std::cout << "等待 " << delaySeconds << " 秒后启动下一个程序..." << std::endl << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(config.delayAfterStart));
+        std::string error;
+        std::wstring endpoint = ControlServer::EndpointPath(controlName);
+        if (!controlServer.Start(controlName, [this](const std::string& command) { return HandleCommand(command); }, error)) {
+            logger.Write(LogLevel::Error, L"✗ 无法打开控制通道: " + endpoint + L" (" + TextEncoding::Utf8ToWide(error) + L")", false);
+            return false;
+        }
+        logger.Print(L"守护模式，控制通道: " + endpoint + L"\n命令: run | status | stop [名称] | reload | ping | shutdown");
+
+        {
+            std::unique_lock<std::mutex> lock(daemonMutex);
+            auto shutdown = [this]() { return shutdownRequested; };
+            if (metricsFilePath.empty() || metricsIntervalSeconds <= 0) {
+                daemonCondition.wait(lock, shutdown);
+            }
+            else {
+                while (!daemonCondition.wait_for(lock, std::chrono::seconds(metricsIntervalSeconds), shutdown)) {
+                    lock.unlock();
+                    WriteMetrics();
+                    lock.lock();
+                }
             }
         }
+        controlServer.Stop();
+        if (launchThread.joinable()) launchThread.join();
 
-        std::cout << "=====================================" << std::endl;
-        std::cout << "所有程序启动完成！" << std::endl;
-        std::cout << "按任意键退出..." << std::endl;
-        std::cin.get();
+        logger.Print(L"守护进程退出");
+        if (runCount > 0) DisplayRunSummary();
+        WriteRunRecords();
+        return true;
     }
-};
 
+    // 向运行中的守护进程发送一条命令并输出回复，回复为{"ok":true...}时返回true
+    bool SendControlCommand(const std::string& command) {
+        std::string reply, error;
+        if (!ControlServer::SendControlCommand(controlName, command, reply, error)) {
+            std::cerr << "✗ " << error << std::endl;
+            return false;
+        }
+        std::cout << reply << std::endl;
+        return reply.compare(0, 10, "{\"ok\":true") == 0;
+    }
+};
 
-int main() {
 
-    
+int main(int argc, char* argv[]) {
     ProgramLauncher launcher;
     
     // 在这里可以自定义名称（可选）
     //launcher.SetGameControllerName(L"GameMJ_Controller.exe");
     // launcher.SetConfigFolderName(L"MyConfigs");
-    
+    // launcher.SetMaxParallelLaunches(8);
+    // launcher.SetUseSeparateController(true);
+    // launcher.SetUsePlanCache(false);
+    // launcher.SetWatchConfigFolder(true);
+
+    // 启动计划缓存维护命令: --dump-plan 输出缓存内容，--verify-plan 校验缓存是否与配置一致
+    // --watch 启动后继续监视配置文件夹
+    // --trace <文件> 记录本次启动的时间线，可在Perfetto中打开
+    // --log-level debug|info|warning|error 输出级别，--log-file <文件> 同时写入滚动日志文件
+    // --load-record <文件> 记录负载准入的采样，--load-replay <文件> 用记录代替实时负载
+    // --background 启动器和控制器以后台优先级运行
+    // --prefetch [MB/s] 启动前预读各程序的文件，可选带宽上限（默认64，0为不限）
+    // --daemon 常驻等待控制命令（代替--watch，修改配置后发送reload），--control-name <名称> 控制通道名称
+    // --ctl <命令...> 向守护进程发送一条命令并输出JSON回复，须放在最后
+    // --metrics-file <文件.prom> 每批启动结束和退出时写出指标，--metrics-interval <秒> 守护模式下另按间隔写出
+    // --strict 启动前预检发现错误时不启动任何程序（默认只报告）
+    // --simulate [config] 不启动任何程序，按虚拟时钟模拟启动计划并输出时间线和关键路径（config表示不使用启动历史）
+    bool daemon = false;
+    bool simulate = false;
+    bool simulateWithHistory = true;
+    for (int i = 1; i < argc; i++) {
+        std::string command = argv[i];
+        LogLevel level;
+        if (command == "--dump-plan" || command == "--verify-plan") {
+            launcher.SetConsoleUTF8();
+            return (command == "--dump-plan" ? launcher.DumpPlanCache() : launcher.VerifyPlanCache()) ? 0 : 1;
+        }
+        if (command == "--watch") {
+            launcher.SetWatchConfigFolder(true);
+        }
+        else if (command == "--trace" && i + 1 < argc) {
+            launcher.SetTraceFile(TextEncoding::Utf8ToWide(argv[++i]));
+        }
+        else if (command == "--log-level" && i + 1 < argc && Logger::ParseLevel(argv[i + 1], level)) {
+            launcher.SetLogLevel(level);
+            i++;
+        }
+        else if (command == "--log-file" && i + 1 < argc) {
+            launcher.SetLogFile(TextEncoding::Utf8ToWide(argv[++i]));
+        }
+        else if (command == "--load-record" && i + 1 < argc) {
+            launcher.SetLoadRecordFile(TextEncoding::Utf8ToWide(argv[++i]));
+        }
+        else if (command == "--load-replay" && i + 1 < argc) {
+            if (!launcher.SetLoadReplay(TextEncoding::Utf8ToWide(argv[++i]))) return 1;
+        }
+        else if (command == "--background") {
+            launcher.SetBackgroundMode();
+        }
+        else if (command == "--prefetch") {
+            int bandwidth = 64;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) bandwidth = std::atoi(argv[++i]);
+            launcher.SetPrefetch(true, bandwidth);
+        }
+        else if (command == "--strict") {
+            launcher.SetStrictPreflight(true);
+        }
+        else if (command == "--simulate") {
+            simulate = true;
+            if (i + 1 < argc && std::string(argv[i + 1]) == "config") {
+                simulateWithHistory = false;
+                i++;
+            }
+        }
+        else if (command == "--daemon") {
+            daemon = true;
+            launcher.SetDaemonMode(true);
+        }
+        else if (command == "--metrics-file" && i + 1 < argc) {
+            launcher.SetMetricsFile(TextEncoding::Utf8ToWide(argv[++i]));
+        }
+        else if (command == "--metrics-interval" && i + 1 < argc) {
+            launcher.SetMetricsInterval(std::atoi(argv[++i]));
+        }
+        else if (command == "--control-name" && i + 1 < argc) {
+            launcher.SetControlName(TextEncoding::Utf8ToWide(argv[++i]));
+        }
+        else if (command == "--ctl" && i + 1 < argc) {
+            std::string request;
+            for (i++; i < argc; i++) {
+                if (!request.empty()) request += ' ';
+                request += argv[i];
+            }
+            launcher.SetConsoleUTF8();
+            return launcher.SendControlCommand(request) ? 0 : 1;
+        }
+        else {
+            std::cout << "Usage: GameMJ_Launcher.exe [--watch] [--trace <file>] [--log-level <level>] [--log-file <file>]"
+                " [--load-record <file>] [--load-replay <file>] [--background] [--prefetch [MB/s]] [--strict] [--daemon]"
+                " [--control-name <name>] [--metrics-file <file.prom>] [--metrics-interval <seconds>]"
+                " | --simulate [config] | --ctl <command> | --dump-plan | --verify-plan" << std::endl;
+            return 1;
+        }
+    }
+
+    if (daemon) return launcher.RunDaemon() ? 0 : 1;
     launcher.InitializePrograms();
-    launcher.Run();
-    return 0;
+    if (simulate) return launcher.Simulate(simulateWithHistory) ? 0 : 1;
+    return launcher.Run() ? 0 : 1;
 }
\ No newline at end of file
@@ -0,0 +1,378 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <numeric>
+#include <fstream>
+#include <filesystem>
+#include "Platform.h"
+#include "TextEncoding.h"
+#include "ConfigParser.h"
+#include "ConfigLoader.h"
+#include "LaunchPlanCache.h"
+#include "LaunchScheduler.h"
+
+// 启动流程基准测试
+// 用法: LaunchBenchmark [配置文件夹] [--sizes 10,1000,10000] [--iterations N] [--spawn N] [--json 结果文件] [--keep]
+//   内存解析：生成的合成配置；带配置文件夹时额外解析该文件夹中的*.json
+//   流水线：在临时目录生成含Unicode路径的合成ProgramConfigs文件夹，分别测量
+//           目录枚举、并发解析、计划构建（过滤/排序/依赖图）、计划缓存读写
+//   进程：以自身（--stand-in模式，仅休眠）作为替身子进程，测量启动延迟和按句柄关闭延迟
+//   --json 将全部统计写为机器可读的JSON，便于不同构建之间对比回归
+
+using BenchClock = std::chrono::steady_clock;
+
+static double ElapsedMs(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+static double ElapsedUs(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::micro>(BenchClock::now() - start).count();
+}
+
+// 一个阶段的全部采样
+struct StageSamples {
+    std::string stage;
+    size_t entries = 0;               // 工作量（配置数量或文档数量）
+    std::string unit;                 // "ms" 或 "us"
+    std::vector<double> values;
+
+    double Percentile(double p) const {
+        std::vector<double> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted[static_cast<size_t>(p * (sorted.size() - 1) + 0.5)];
+    }
+
+    double Mean() const {
+        return std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+    }
+};
+
+static std::vector<StageSamples> results;
+
+static void Report(const StageSamples& samples) {
+    if (samples.values.empty()) return;
+    std::cout << "  " << samples.stage << " (" << samples.entries << "): p50 " << samples.Percentile(0.50)
+        << " " << samples.unit << ", p90 " << samples.Percentile(0.90) << ", p99 " << samples.Percentile(0.99)
+        << ", max " << samples.Percentile(1.0) << ", mean " << samples.Mean()
+        << "  [" << samples.values.size() << " samples]" << std::endl;
+    results.push_back(samples);
+}
+
+static bool WriteJsonResults(const std::string& path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+#ifdef _WIN32
+    const char* platform = "win32";
+#else
+    const char* platform = "posix";
+#endif
+    out << "{\n  \"benchmark\": \"LaunchBenchmark\",\n  \"platform\": \"" << platform
+        << "\",\n  \"hardwareThreads\": " << std::thread::hardware_concurrency() << ",\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const StageSamples& samples = results[i];
+        out << (i > 0 ? "," : "") << "\n    {\"stage\": \"" << samples.stage << "\", \"entries\": " << samples.entries
+            << ", \"unit\": \"" << samples.unit << "\", \"samples\": " << samples.values.size()
+            << ", \"p50\": " << samples.Percentile(0.50) << ", \"p90\": " << samples.Percentile(0.90)
+            << ", \"p99\": " << samples.Percentile(0.99) << ", \"max\": " << samples.Percentile(1.0)
+            << ", \"mean\": " << samples.Mean() << "}";
+    }
+    out << "\n  ]\n}\n";
+    return out.good();
+}
+
+// 生成一个典型配置，参数数量和路径随序号变化，包含中文字符和转义
+static std::string MakeTypicalConfig(int index) {
+    ProgramConfig config(index, index % 7 != 0, L"C:\\Games\\游戏" + std::to_wstring(index) + L"\\bin\\game.exe",
+        {}, ProgramType::ExeWithArgument, 1500 + index % 10 * 100, L"game.exe", index % 3 == 0 ? 600 : 0,
+        L"entry_" + std::to_wstring(index), L"自动生成的配置 \"" + std::to_wstring(index) + L"\"");
+    for (int i = 0; i < index % 6; i++) {
+        config.arguments.push_back(L"--option" + std::to_wstring(i) + L"=value with spaces");
+    }
+    if (index % 4 == 0) {
+        config.hasDependsOn = true;
+        config.dependsOn = { L"entry_" + std::to_wstring(index / 2) };
+    }
+    return SerializeProgramConfig(config);
+}
+
+// 生成一个大配置：长描述、大量参数以及需要跳过的嵌套未知字段
+static std::string MakeLargeConfig(size_t targetBytes) {
+    std::string json = "{\n  \"order\": 1,\n  \"path\": \"C:\\\\Games\\\\big.exe\",\n  \"extra\": [";
+    size_t item = 0;
+    while (json.size() < targetBytes / 2) {
+        if (item > 0) json += ",";
+        json += "{\"k\": [1, 2, [3, {\"deep\": \"\\u6e38\\u620f\"}]], \"s\": \"padding padding padding\"}";
+        item++;
+    }
+    json += "],\n  \"arguments\": [";
+    item = 0;
+    while (json.size() < targetBytes) {
+        if (item > 0) json += ", ";
+        json += "\"--argument-" + std::to_string(item++) + "=\\\"quoted\\\" \\\\ path\"";
+    }
+    json += "],\n  \"name\": \"large\"\n}\n";
+    return json;
+}
+
+static void ReportThroughput(const char* label, size_t bytes, size_t documents, double ms) {
+    double mbPerSecond = bytes / (1024.0 * 1024.0) / (ms / 1000.0);
+    double docsPerSecond = documents / (ms / 1000.0);
+    std::cout << "  " << label << ": " << documents << " docs, " << bytes / 1024 << " KiB in "
+        << ms << " ms  (" << mbPerSecond << " MiB/s, " << docsPerSecond << " docs/s)" << std::endl;
+}
+
+static bool ParseAll(const std::vector<std::string>& documents, int iterations, const char* label, const char* stage) {
+    size_t bytes = 0;
+    for (const auto& document : documents) bytes += document.size();
+
+    StageSamples perDocument{ stage, documents.size(), "us", {} };
+    perDocument.values.reserve(documents.size() * iterations);
+    auto start = BenchClock::now();
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        for (const auto& document : documents) {
+            auto documentStart = BenchClock::now();
+            ProgramConfig config;
+            ConfigParseError error;
+            if (!ParseProgramConfig(document, config, error)) {
+                std::cerr << "parse failed: " << error.ToString() << std::endl;
+                return false;
+            }
+            perDocument.values.push_back(ElapsedUs(documentStart));
+        }
+    }
+    double ms = ElapsedMs(start);
+    ReportThroughput(label, bytes * iterations, documents.size() * iterations, ms);
+    Report(perDocument);
+    return true;
+}
+
+static bool BenchmarkParse(const char* folder) {
+    std::cout << "[parse]" << std::endl;
+
+    std::vector<std::string> numerous;
+    for (int i = 0; i < 10000; i++) numerous.push_back(MakeTypicalConfig(i));
+    if (!ParseAll(numerous, 5, "numerous (10000 typical)", "parse_document_typical")) return false;
+
+    std::vector<std::string> large = { MakeLargeConfig(8 * 1024 * 1024) };
+    if (!ParseAll(large, 5, "large (8 MiB)", "parse_document_large")) return false;
+
+    if (folder) {
+        std::vector<std::string> files;
+        for (const auto& entry : std::filesystem::directory_iterator(folder)) {
+            if (entry.path().extension() != ".json") continue;
+            std::ifstream file(entry.path(), std::ios::binary);
+            files.emplace_back((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        }
+        if (!files.empty() && !ParseAll(files, 100, "folder", "parse_document_folder")) return false;
+    }
+    return true;
+}
+
+// 在临时目录下生成合成配置文件夹，目录和文件名都含非ASCII字符
+static std::wstring MakeSyntheticFolder(const std::wstring& root, size_t count) {
+    std::wstring folder = Platform::JoinPath(root, L"ProgramConfigs_" + std::to_wstring(count));
+    Platform::MakeDirectory(folder);
+    for (size_t i = 0; i < count; i++) {
+        std::wstring fileName = L"配置_ゲーム_" + std::to_wstring(i) + L".json";
+        Platform::WriteFileAtomic(Platform::JoinPath(folder, fileName), MakeTypicalConfig(static_cast<int>(i)));
+    }
+    return folder;
+}
+
+// 与ProgramLauncher::Run相同的计划构建：过滤未启用、按order排序、建立依赖图
+static size_t BuildPlan(const std::vector<LoadedConfig>& loaded) {
+    std::vector<ProgramConfig> plan;
+    plan.reserve(loaded.size());
+    for (const auto& item : loaded) {
+        if (item.ok && item.config.enabled) plan.push_back(item.config);
+    }
+    std::sort(plan.begin(), plan.end(),
+        [](const ProgramConfig& a, const ProgramConfig& b) { return a.order < b.order; });
+
+    LaunchGraph graph;
+    std::vector<std::wstring> warnings;
+    graph.Build(plan, warnings);
+    return graph.Size();
+}
+
+static bool BenchmarkPipeline(const std::wstring& root, size_t count, int iterations) {
+    auto generateStart = BenchClock::now();
+    std::wstring folder = MakeSyntheticFolder(root, count);
+    std::cout << "[pipeline " << count << "] generated in " << ElapsedMs(generateStart) << " ms" << std::endl;
+
+    StageSamples discovery{ "discovery", count, "ms", {} };
+    StageSamples parse{ "parse_folder", count, "ms", {} };
+    StageSamples planBuild{ "plan_build", count, "ms", {} };
+    StageSamples cacheWrite{ "plan_cache_write", count, "ms", {} };
+    StageSamples cacheRead{ "plan_cache_read", count, "ms", {} };
+    std::wstring cachePath = Platform::JoinPath(folder, L"launch_plan.cache");
+
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        auto start = BenchClock::now();
+        std::vector<ConfigFileInfo> files = ConfigLoader::ListJsonFiles(folder);
+        discovery.values.push_back(ElapsedMs(start));
+        if (files.size() != count) {
+            std::cerr << "discovery found " << files.size() << " of " << count << " files" << std::endl;
+            return false;
+        }
+
+        std::vector<std::wstring> fileNames;
+        fileNames.reserve(files.size());
+        for (const auto& file : files) fileNames.push_back(file.fileName);
+        start = BenchClock::now();
+        std::vector<LoadedConfig> loaded = ConfigLoader::LoadFiles(folder, fileNames);
+        parse.values.push_back(ElapsedMs(start));
+        for (const auto& item : loaded) {
+            if (!item.ok) {
+                std::cerr << "parse failed: " << item.error << std::endl;
+                return false;
+            }
+        }
+
+        start = BenchClock::now();
+        BuildPlan(loaded);
+        planBuild.values.push_back(ElapsedMs(start));
+
+        std::vector<CachedConfigFile> cached(files.size());
+        for (size_t i = 0; i < files.size(); i++) {
+            cached[i].file = files[i];
+            cached[i].ok = true;
+            cached[i].config = loaded[i].config;
+        }
+        start = BenchClock::now();
+        if (!LaunchPlanCache::Write(cachePath, cached)) {
+            std::cerr << "plan cache write failed" << std::endl;
+            return false;
+        }
+        cacheWrite.values.push_back(ElapsedMs(start));
+
+        std::vector<CachedConfigFile> readBack;
+        std::string error;
+        start = BenchClock::now();
+        if (!LaunchPlanCache::Read(cachePath, readBack, error)) {
+            std::cerr << "plan cache read failed: " << error << std::endl;
+            return false;
+        }
+        cacheRead.values.push_back(ElapsedMs(start));
+    }
+
+    Report(discovery);
+    Report(parse);
+    std::cout << "    parse throughput: " << count / (parse.Percentile(0.50) / 1000.0) << " files/s at p50" << std::endl;
+    Report(planBuild);
+    Report(cacheWrite);
+    Report(cacheRead);
+    return true;
+}
+
+// 启动替身子进程并立即按句柄关闭，分别记录两段耗时
+static bool BenchmarkProcesses(int count) {
+    std::cout << "[process]" << std::endl;
+    Platform::SpawnRequest request;
+    request.path = Platform::ExecutablePath();
+    request.arguments = { L"--stand-in" };
+    if (request.path.empty()) {
+        std::cerr << "cannot locate own executable" << std::endl;
+        return false;
+    }
+
+    StageSamples spawn{ "spawn", static_cast<size_t>(count), "us", {} };
+    StageSamples kill{ "kill", static_cast<size_t>(count), "us", {} };
+    for (int i = 0; i < count; i++) {
+        Platform::ProcessHandle process;
+        auto start = BenchClock::now();
+        if (!Platform::Spawn(request, process)) {
+            std::cerr << "spawn failed, error code: " << Platform::LastError() << std::endl;
+            return false;
+        }
+        spawn.values.push_back(ElapsedUs(start));
+
+        start = BenchClock::now();
+        bool killed = Platform::Terminate(process) && Platform::WaitForExit(process, 5000) == Platform::WaitResult::Exited;
+        double killUs = ElapsedUs(start);
+        Platform::CloseProcess(process);
+        if (!killed) {
+            std::cerr << "stand-in did not exit after terminate" << std::endl;
+            return false;
+        }
+        kill.values.push_back(killUs);
+    }
+    Report(spawn);
+    Report(kill);
+    return true;
+}
+
+static std::vector<size_t> ParseSizes(const std::string& text) {
+    std::vector<size_t> sizes;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t comma = text.find(',', start);
+        if (comma == std::string::npos) comma = text.size();
+        size_t value = std::strtoul(text.substr(start, comma - start).c_str(), nullptr, 10);
+        if (value > 0) sizes.push_back(value);
+        start = comma + 1;
+    }
+    return sizes;
+}
+
+int main(int argc, char* argv[]) {
+    // 替身子进程：什么也不做，等待被关闭
+    if (argc >= 2 && std::string(argv[1]) == "--stand-in") {
+        std::this_thread::sleep_for(std::chrono::seconds(60));
+        return 0;
+    }
+
+    const char* folder = nullptr;
+    std::vector<size_t> sizes = { 10, 1000, 10000 };
+    int iterations = 5;
+    int spawnCount = 50;
+    std::string jsonPath;
+    bool keep = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--sizes" && hasValue) sizes = ParseSizes(argv[++i]);
+        else if (arg == "--iterations" && hasValue) iterations = (std::max)(1, std::atoi(argv[++i]));
+        else if (arg == "--spawn" && hasValue) spawnCount = (std::max)(0, std::atoi(argv[++i]));
+        else if (arg == "--json" && hasValue) jsonPath = argv[++i];
+        else if (arg == "--keep") keep = true;
+        else if (arg.rfind("--", 0) != 0 && !folder) folder = argv[i];
+        else {
+            std::cerr << "Usage: LaunchBenchmark [folder] [--sizes 10,1000,10000] [--iterations N] [--spawn N] [--json file] [--keep]" << std::endl;
+            return 2;
+        }
+    }
+
+    if (!BenchmarkParse(folder)) return 1;
+
+    std::filesystem::path tempRoot = std::filesystem::temp_directory_path() /
+        std::filesystem::u8path("LaunchBenchmark_基准_" + std::to_string(Platform::CurrentProcessId()));
+    std::wstring root = TextEncoding::Utf8ToWide(tempRoot.u8string());
+    Platform::MakeDirectory(root);
+    bool ok = true;
+    for (size_t count : sizes) {
+        if (!BenchmarkPipeline(root, count, iterations)) {
+            ok = false;
+            break;
+        }
+    }
+    if (keep) std::cout << "synthetic folders kept in " << tempRoot.u8string() << std::endl;
+    else {
+        std::error_code error;
+        std::filesystem::remove_all(tempRoot, error);
+    }
+
+    if (ok && spawnCount > 0) ok = BenchmarkProcesses(spawnCount);
+
+    if (!jsonPath.empty()) {
+        if (!WriteJsonResults(jsonPath)) {
+            std::cerr << "failed to write " << jsonPath << std::endl;
+            return 1;
+        }
+        std::cout << "results written to " << jsonPath << std::endl;
+    }
+    return ok ? 0 : 1;
+}
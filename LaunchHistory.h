@@ -0,0 +1,215 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <ctime>
+#include <cstdint>
+#include <cstring>
+#include "Platform.h"
+#include "TextEncoding.h"
+
+// 启动历史：用于delayMode为auto的条目按实际启动耗时决定等待时间
+//
+// launch_history.log     每次启动追加一条定长记录（只追加，控制器进程也可直接写入）
+// launch_history.summary 各条目最近kWindow个样本的滚动汇总，以及已汇总到的日志位置；
+//                        加载时只读取该位置之后新追加的记录，不必扫描整个日志
+// 日志超过kMaxLogBytes时，汇总写回后清空日志重新开始
+class LaunchHistory {
+public:
+    static constexpr const wchar_t* kLogName = L"launch_history.log";
+    static constexpr const wchar_t* kSummaryName = L"launch_history.summary";
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kWindow = 20;             // 每个条目保留的最近样本数
+    static constexpr uint32_t kMinSamples = 3;        // 样本少于该数时仍使用配置值
+    static constexpr int kPercentile = 90;
+    static constexpr uint64_t kMaxLogBytes = 1024 * 1024;
+    static constexpr int32_t kTimedOut = 0x7FFFFFFF;  // 观察期内未出现，按配置值处理
+
+    // 一次启动的耗时（毫秒，-1表示未测量）
+    struct Sample {
+        int32_t spawnMs = -1;         // 创建进程本身的耗时
+        int32_t readyMs = -1;         // 启动到就绪条件满足
+        int32_t appearMs = -1;        // 启动到主窗口或目标进程出现（kTimedOut表示观察期内未出现）
+    };
+
+    // 条目的历史统计
+    struct Stats {
+        uint32_t launches = 0;        // 累计记录的启动次数
+        uint32_t samples = 0;         // 窗口内的启动耗时样本数
+        int learnedMs = -1;           // 样本的kPercentile分位数，样本不足时为-1
+        int lastSpawnMs = -1;
+    };
+
+private:
+    struct LogRecord {
+        uint32_t magic;
+        uint32_t reserved;
+        uint64_t nameHash;
+        int64_t time;                 // Unix时间（秒）
+        int32_t spawnMs;
+        int32_t readyMs;
+        int32_t appearMs;
+        int32_t reserved2;
+    };
+
+    struct SummaryHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+        uint64_t logOffset;           // 已汇总到的日志位置
+    };
+
+    struct SummaryRecord {
+        uint64_t nameHash;
+        uint32_t launches;
+        uint32_t count;               // ring中的有效样本数
+        uint32_t next;                // 下一个样本写入的位置
+        int32_t lastSpawnMs;
+        int32_t startupMs[kWindow];   // 启动耗时：有就绪条件时为readyMs，否则为appearMs
+    };
+
+    static constexpr uint32_t kRecordMagic = 0x4C48524Cu;     // "LRHL"
+
+    static_assert(sizeof(LogRecord) == 40, "LogRecord layout");
+    static_assert(sizeof(SummaryHeader) == 24, "SummaryHeader layout");
+    static_assert(sizeof(SummaryRecord) == 104, "SummaryRecord layout");
+
+    std::wstring logPath;
+    std::wstring summaryPath;
+    uint64_t logOffset = 0;
+    std::unordered_map<uint64_t, SummaryRecord> records;
+
+    static uint64_t NameHash(const std::wstring& name) {
+        std::string utf8 = TextEncoding::WideToUtf8(name);
+        uint64_t hash = 1469598103934665603ull;
+        for (char c : utf8) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    void Fold(const LogRecord& log) {
+        auto inserted = records.try_emplace(log.nameHash, SummaryRecord{});
+        SummaryRecord& record = inserted.first->second;
+        if (inserted.second) {
+            record.nameHash = log.nameHash;
+            record.lastSpawnMs = -1;
+        }
+        record.launches++;
+        if (log.spawnMs >= 0) record.lastSpawnMs = log.spawnMs;
+        int32_t startupMs = log.readyMs >= 0 ? log.readyMs : log.appearMs;
+        if (startupMs < 0) return;
+        record.startupMs[record.next] = startupMs;
+        record.next = (record.next + 1) % kWindow;
+        record.count = (std::min)(record.count + 1, static_cast<uint32_t>(kWindow));
+    }
+
+    bool ReadSummary() {
+        std::string content;
+        if (!Platform::ReadWholeFile(summaryPath, content) || content.size() < sizeof(SummaryHeader)) return false;
+        SummaryHeader header;
+        memcpy(&header, content.data(), sizeof(header));
+        if (memcmp(header.magic, "LHSM", 4) != 0 || header.version != kVersion ||
+            content.size() != sizeof(header) + static_cast<uint64_t>(header.entryCount) * sizeof(SummaryRecord)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < header.entryCount; i++) {
+            SummaryRecord record;
+            memcpy(&record, content.data() + sizeof(header) + i * sizeof(SummaryRecord), sizeof(record));
+            if (record.count > kWindow || record.next >= kWindow) return false;
+            records[record.nameHash] = record;
+        }
+        logOffset = header.logOffset;
+        return true;
+    }
+
+    bool WriteSummary() const {
+        SummaryHeader header = {};
+        memcpy(header.magic, "LHSM", 4);
+        header.version = kVersion;
+        header.entryCount = static_cast<uint32_t>(records.size());
+        header.logOffset = logOffset;
+        std::string content(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& item : records) {
+            content.append(reinterpret_cast<const char*>(&item.second), sizeof(SummaryRecord));
+        }
+        return Platform::WriteFileAtomic(summaryPath, content);
+    }
+
+public:
+    // 追加一条启动记录（launcher或独立控制器在测量结束时调用）
+    static bool Append(const std::wstring& path, const std::wstring& name, const Sample& sample) {
+        LogRecord record = {};
+        record.magic = kRecordMagic;
+        record.nameHash = NameHash(name);
+        record.time = static_cast<int64_t>(std::time(nullptr));
+        record.spawnMs = sample.spawnMs;
+        record.readyMs = sample.readyMs;
+        record.appearMs = sample.appearMs;
+        return Platform::AppendToFile(path, std::string(reinterpret_cast<const char*>(&record), sizeof(record)));
+    }
+
+    static std::wstring LogPathIn(const std::wstring& folder) {
+        return Platform::JoinPath(folder, kLogName);
+    }
+
+    // 读取汇总，并把汇总之后追加的日志合并进来；有新记录时写回汇总
+    // 汇总损坏时从日志重建；日志比汇总位置短（被清空或替换）时保留汇总并从日志开头合并
+    bool Load(const std::wstring& folder) {
+        logPath = LogPathIn(folder);
+        summaryPath = Platform::JoinPath(folder, kSummaryName);
+        records.clear();
+        logOffset = 0;
+        if (!ReadSummary()) {
+            records.clear();
+            logOffset = 0;
+        }
+
+        std::string tail;
+        uint64_t logSize = 0;
+        if (!Platform::ReadFileFrom(logPath, logOffset, tail, logSize)) return true;   // 还没有任何记录
+        if (logSize < logOffset) {
+            logOffset = 0;
+            if (!Platform::ReadFileFrom(logPath, 0, tail, logSize)) return false;
+        }
+
+        // 只合并完整的记录；末尾不完整的记录（正在写入）留到下次
+        size_t whole = tail.size() - tail.size() % sizeof(LogRecord);
+        for (size_t offset = 0; offset < whole; offset += sizeof(LogRecord)) {
+            LogRecord record;
+            memcpy(&record, tail.data() + offset, sizeof(record));
+            if (record.magic == kRecordMagic) Fold(record);
+        }
+        if (whole == 0) return true;
+        logOffset += whole;
+
+        if (logOffset >= kMaxLogBytes && Platform::WriteFileAtomic(logPath, std::string())) logOffset = 0;
+        return WriteSummary();
+    }
+
+    Stats StatsOf(const std::wstring& name) const {
+        Stats stats;
+        auto it = records.find(NameHash(name));
+        if (it == records.end()) return stats;
+        const SummaryRecord& record = it->second;
+        stats.launches = record.launches;
+        stats.samples = record.count;
+        stats.lastSpawnMs = record.lastSpawnMs;
+        if (record.count >= kMinSamples) {
+            std::vector<int32_t> values(record.startupMs, record.startupMs + record.count);
+            size_t rank = (values.size() * kPercentile + 99) / 100;   // 最近秩法
+            std::nth_element(values.begin(), values.begin() + (rank - 1), values.end());
+            stats.learnedMs = values[rank - 1];
+        }
+        return stats;
+    }
+
+    // auto条目的实际等待时间：学习到的分位数，不超过配置值；历史不足时为配置值
+    int DelayFor(const std::wstring& name, int configuredMs) const {
+        int learnedMs = StatsOf(name).learnedMs;
+        return learnedMs < 0 ? configuredMs : (std::min)(learnedMs, configuredMs);
+    }
+};
@@ -0,0 +1,576 @@
+#pragma once
+#include <string>
+#include <ostream>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "Platform.h"
+#include "ProgramConfig.h"
+#include "ConfigLoader.h"
+#include "TextEncoding.h"
+
+// 编译后的启动计划缓存
+// 每个配置文件解析一次后写入扁平二进制文件，下次启动时内存映射读取，
+// 只有大小或修改时间变化的文件才重新解析JSON。
+//
+// 文件布局（小端，各段紧密排列）:
+//   PlanHeader
+//   PlanFileRecord  [fileCount]   按文件名排序
+//   PlanEntryRecord [entryCount]  按order排序（同order按文件名）
+//   uint32_t        [listCount]   参数和依赖的字符串编号
+//   PlanString      [stringCount] 字符串表（已去重）
+//   char            [stringBytes] UTF-8字符数据
+
+// 缓存中的一个配置文件：解析成功时带配置，失败时带错误信息
+struct CachedConfigFile {
+    ConfigFileInfo file;
+    bool ok = false;
+    ProgramConfig config;
+    std::string error;
+};
+
+class LaunchPlanCache {
+public:
+    static constexpr uint32_t kVersion = 10;
+    static constexpr uint32_t kNone = 0xFFFFFFFFu;
+
+private:
+    struct PlanHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t fileCount;
+        uint32_t entryCount;
+        uint32_t listCount;
+        uint32_t stringCount;
+        uint32_t stringBytes;
+        uint32_t reserved;
+        uint64_t checksum;            // 头部之后全部数据的FNV-1a
+    };
+
+    struct PlanFileRecord {
+        uint64_t size;
+        uint64_t lastWriteTime;
+        uint32_t fileName;
+        uint32_t entry;               // 解析失败时为kNone
+        uint32_t error;               // 解析成功时为kNone
+        uint32_t reserved;
+    };
+
+    enum EntryFlags : uint32_t {
+        kEnabled = 1,
+        kHasDependsOn = 2,
+        kCaptureOutput = 4,
+        kKillAnyByName = 8,
+    };
+
+    struct PlanEntryRecord {
+        int32_t order;
+        uint32_t flags;
+        uint32_t type;
+        int32_t delayAfterStart;
+        uint32_t readinessType;
+        int32_t readinessTimeoutMs;
+        int32_t killAfterSeconds;
+        uint32_t path;
+        uint32_t processNameToKill;
+        uint32_t name;
+        uint32_t description;
+        uint32_t readinessTarget;
+        uint32_t readinessPattern;
+        uint32_t firstArgument;
+        uint32_t argumentCount;
+        uint32_t firstDependency;
+        uint32_t dependencyCount;
+        uint32_t file;
+        int32_t admitMaxCpuPercent;
+        int32_t admitMaxDiskQueue;
+        int32_t admitMinFreeMemoryMB;
+        int32_t admitMaxWaitMs;
+        uint32_t restartMode;
+        int32_t restartDelayMs;
+        int32_t restartMaxDelayMs;
+        int32_t restartLimit;
+        int32_t limitMemoryMB;
+        int32_t limitCpuPercent;
+        uint32_t priorityClass;
+        uint32_t ioPriority;
+        uint32_t memoryPriority;
+        uint32_t cpuAffinity;
+        uint32_t firstPrefetch;
+        uint32_t prefetchCount;
+        uint32_t ifRunning;
+        uint32_t delayMode;
+        int32_t outputLogMaxKB;
+        int32_t outputLogFiles;
+    };
+
+    struct PlanString {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    static_assert(sizeof(PlanHeader) == 40, "PlanHeader layout");
+    static_assert(sizeof(PlanFileRecord) == 32, "PlanFileRecord layout");
+    static_assert(sizeof(PlanEntryRecord) == 152, "PlanEntryRecord layout");
+
+    static uint64_t Checksum(const char* data, size_t size) {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // 写入时的字符串驻留表
+    class StringTable {
+    public:
+        uint32_t Intern(const std::string& str) {
+            auto it = ids.find(str);
+            if (it != ids.end()) return it->second;
+            uint32_t id = static_cast<uint32_t>(strings.size());
+            strings.push_back({ static_cast<uint32_t>(bytes.size()), static_cast<uint32_t>(str.size()) });
+            bytes += str;
+            ids.emplace(str, id);
+            return id;
+        }
+
+        uint32_t Intern(const std::wstring& wstr) {
+            return Intern(TextEncoding::WideToUtf8(wstr));
+        }
+
+        std::vector<PlanString> strings;
+        std::string bytes;
+
+    private:
+        std::unordered_map<std::string, uint32_t> ids;
+    };
+
+    // 映射后的只读视图，所有访问前均已做过边界检查
+    struct PlanView {
+        const PlanHeader* header = nullptr;
+        const PlanFileRecord* files = nullptr;
+        const PlanEntryRecord* entries = nullptr;
+        const uint32_t* lists = nullptr;
+        const PlanString* strings = nullptr;
+        const char* bytes = nullptr;
+
+        std::wstring String(uint32_t id) const {
+            if (id == kNone) return L"";
+            return TextEncoding::Utf8ToWide(std::string_view(bytes + strings[id].offset, strings[id].length));
+        }
+
+        std::vector<std::wstring> List(uint32_t first, uint32_t count) const {
+            std::vector<std::wstring> result;
+            result.reserve(count);
+            for (uint32_t i = 0; i < count; i++) result.push_back(String(lists[first + i]));
+            return result;
+        }
+
+        ProgramConfig Entry(uint32_t index) const {
+            const PlanEntryRecord& record = entries[index];
+            ProgramConfig config;
+            config.order = record.order;
+            config.enabled = (record.flags & kEnabled) != 0;
+            config.hasDependsOn = (record.flags & kHasDependsOn) != 0;
+            config.output.enabled = (record.flags & kCaptureOutput) != 0;
+            config.killAnyByName = (record.flags & kKillAnyByName) != 0;
+            config.output.maxKB = record.outputLogMaxKB;
+            config.output.files = record.outputLogFiles;
+            config.type = static_cast<ProgramType>(record.type);
+            config.delayAfterStart = record.delayAfterStart;
+            config.delayMode = static_cast<DelayMode>(record.delayMode);
+            config.readiness.type = static_cast<ReadinessType>(record.readinessType);
+            config.readiness.timeoutMs = record.readinessTimeoutMs;
+            config.readiness.target = String(record.readinessTarget);
+            config.readiness.pattern = String(record.readinessPattern);
+            config.admission.maxCpuPercent = record.admitMaxCpuPercent;
+            config.admission.maxDiskQueue = record.admitMaxDiskQueue;
+            config.admission.minFreeMemoryMB = record.admitMinFreeMemoryMB;
+            config.admission.maxWaitMs = record.admitMaxWaitMs;
+            config.restart.mode = static_cast<RestartMode>(record.restartMode);
+            config.restart.delayMs = record.restartDelayMs;
+            config.restart.maxDelayMs = record.restartMaxDelayMs;
+            config.restart.limit = record.restartLimit;
+            config.limits.memoryMB = record.limitMemoryMB;
+            config.limits.cpuPercent = record.limitCpuPercent;
+            config.scheduling.priorityClass = static_cast<PriorityLevel>(record.priorityClass);
+            config.scheduling.ioPriority = static_cast<PriorityLevel>(record.ioPriority);
+            config.scheduling.memoryPriority = static_cast<PriorityLevel>(record.memoryPriority);
+            config.scheduling.cpuAffinity = String(record.cpuAffinity);
+            config.killAfterSeconds = record.killAfterSeconds;
+            config.path = String(record.path);
+            config.processNameToKill = String(record.processNameToKill);
+            config.name = String(record.name);
+            config.description = String(record.description);
+            config.arguments = List(record.firstArgument, record.argumentCount);
+            config.dependsOn = List(record.firstDependency, record.dependencyCount);
+            config.prefetch = List(record.firstPrefetch, record.prefetchCount);
+            config.ifRunning = static_cast<IfRunningPolicy>(record.ifRunning);
+            return config;
+        }
+    };
+
+    // 校验头部、各段长度、校验和以及所有编号范围
+    static bool Validate(const char* data, size_t size, PlanView& view, std::string& error) {
+        if (size < sizeof(PlanHeader)) {
+            error = "file too small";
+            return false;
+        }
+        const PlanHeader* header = reinterpret_cast<const PlanHeader*>(data);
+        if (std::memcmp(header->magic, "DCLP", 4) != 0) {
+            error = "bad magic";
+            return false;
+        }
+        if (header->version != kVersion) {
+            error = "unsupported version " + std::to_string(header->version);
+            return false;
+        }
+
+        uint64_t expected = sizeof(PlanHeader) +
+            static_cast<uint64_t>(header->fileCount) * sizeof(PlanFileRecord) +
+            static_cast<uint64_t>(header->entryCount) * sizeof(PlanEntryRecord) +
+            static_cast<uint64_t>(header->listCount) * sizeof(uint32_t) +
+            static_cast<uint64_t>(header->stringCount) * sizeof(PlanString) +
+            header->stringBytes;
+        if (expected != size) {
+            error = "size mismatch (expected " + std::to_string(expected) + ", got " + std::to_string(size) + ")";
+            return false;
+        }
+        if (Checksum(data + sizeof(PlanHeader), size - sizeof(PlanHeader)) != header->checksum) {
+            error = "checksum mismatch";
+            return false;
+        }
+
+        const char* cursor = data + sizeof(PlanHeader);
+        view.header = header;
+        view.files = reinterpret_cast<const PlanFileRecord*>(cursor);
+        cursor += header->fileCount * sizeof(PlanFileRecord);
+        view.entries = reinterpret_cast<const PlanEntryRecord*>(cursor);
+        cursor += header->entryCount * sizeof(PlanEntryRecord);
+        view.lists = reinterpret_cast<const uint32_t*>(cursor);
+        cursor += header->listCount * sizeof(uint32_t);
+        view.strings = reinterpret_cast<const PlanString*>(cursor);
+        cursor += header->stringCount * sizeof(PlanString);
+        view.bytes = cursor;
+
+        auto validString = [&](uint32_t id, bool optional) {
+            return (optional && id == kNone) || id < header->stringCount;
+        };
+        auto validList = [&](uint32_t first, uint32_t count) {
+            if (static_cast<uint64_t>(first) + count > header->listCount) return false;
+            for (uint32_t i = 0; i < count; i++) {
+                if (view.lists[first + i] >= header->stringCount) return false;
+            }
+            return true;
+        };
+
+        for (uint32_t i = 0; i < header->stringCount; i++) {
+            if (static_cast<uint64_t>(view.strings[i].offset) + view.strings[i].length > header->stringBytes) {
+                error = "string " + std::to_string(i) + " out of range";
+                return false;
+            }
+        }
+        for (uint32_t i = 0; i < header->fileCount; i++) {
+            const PlanFileRecord& file = view.files[i];
+            bool ok = validString(file.fileName, false) &&
+                (file.entry == kNone ? validString(file.error, false) : file.entry < header->entryCount);
+            if (!ok) {
+                error = "file record " + std::to_string(i) + " out of range";
+                return false;
+            }
+        }
+        for (uint32_t i = 0; i < header->entryCount; i++) {
+            const PlanEntryRecord& entry = view.entries[i];
+            bool ok = entry.type <= static_cast<uint32_t>(ProgramType::ExeWithArgument) &&
+                entry.readinessType <= static_cast<uint32_t>(ReadinessType::TcpPort) &&
+                entry.restartMode <= static_cast<uint32_t>(RestartMode::Always) &&
+                entry.priorityClass <= static_cast<uint32_t>(PriorityLevel::High) &&
+                entry.ioPriority <= static_cast<uint32_t>(PriorityLevel::High) &&
+                entry.memoryPriority <= static_cast<uint32_t>(PriorityLevel::High) &&
+                validString(entry.cpuAffinity, true) &&
+                validString(entry.path, false) && validString(entry.name, false) &&
+                validString(entry.processNameToKill, true) && validString(entry.description, true) &&
+                validString(entry.readinessTarget, true) && validString(entry.readinessPattern, true) &&
+                validList(entry.firstArgument, entry.argumentCount) &&
+                validList(entry.firstDependency, entry.dependencyCount) &&
+                validList(entry.firstPrefetch, entry.prefetchCount) &&
+                entry.ifRunning <= static_cast<uint32_t>(IfRunningPolicy::Attach) &&
+                entry.delayMode <= static_cast<uint32_t>(DelayMode::Auto) &&
+                entry.file < header->fileCount;
+            if (!ok) {
+                error = "entry " + std::to_string(i) + " out of range";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 只读映射整个缓存文件；visit在映射有效期内被调用
+    template <typename Visitor>
+    static bool MapFile(const std::wstring& cachePath, std::string& error, Visitor visit) {
+        Platform::MappedFile file;
+        if (!file.Open(cachePath)) {
+            error = "cannot open cache";
+            return false;
+        }
+        PlanView view;
+        return Validate(file.Data(), file.Size(), view, error) && visit(view);
+    }
+
+public:
+    static bool SameConfig(const ProgramConfig& a, const ProgramConfig& b) {
+        return a.order == b.order && a.enabled == b.enabled && a.path == b.path &&
+            a.arguments == b.arguments && a.type == b.type && a.delayAfterStart == b.delayAfterStart &&
+            a.delayMode == b.delayMode &&
+            a.output.enabled == b.output.enabled && a.output.maxKB == b.output.maxKB && a.output.files == b.output.files &&
+            a.readiness.type == b.readiness.type && a.readiness.target == b.readiness.target &&
+            a.readiness.pattern == b.readiness.pattern && a.readiness.timeoutMs == b.readiness.timeoutMs &&
+            a.admission.maxCpuPercent == b.admission.maxCpuPercent && a.admission.maxDiskQueue == b.admission.maxDiskQueue &&
+            a.admission.minFreeMemoryMB == b.admission.minFreeMemoryMB && a.admission.maxWaitMs == b.admission.maxWaitMs &&
+            a.restart.mode == b.restart.mode && a.restart.delayMs == b.restart.delayMs &&
+            a.restart.maxDelayMs == b.restart.maxDelayMs && a.restart.limit == b.restart.limit &&
+            a.limits.memoryMB == b.limits.memoryMB && a.limits.cpuPercent == b.limits.cpuPercent &&
+            a.scheduling.priorityClass == b.scheduling.priorityClass && a.scheduling.ioPriority == b.scheduling.ioPriority &&
+            a.scheduling.memoryPriority == b.scheduling.memoryPriority && a.scheduling.cpuAffinity == b.scheduling.cpuAffinity &&
+            a.processNameToKill == b.processNameToKill && a.killAnyByName == b.killAnyByName &&
+            a.killAfterSeconds == b.killAfterSeconds &&
+            a.name == b.name && a.description == b.description &&
+            a.hasDependsOn == b.hasDependsOn && a.dependsOn == b.dependsOn && a.prefetch == b.prefetch &&
+            a.ifRunning == b.ifRunning;
+    }
+
+    // 读取缓存，files按文件名排序
+    static bool Read(const std::wstring& cachePath, std::vector<CachedConfigFile>& files, std::string& error) {
+        return MapFile(cachePath, error, [&](const PlanView& view) {
+            files.clear();
+            files.reserve(view.header->fileCount);
+            for (uint32_t i = 0; i < view.header->fileCount; i++) {
+                const PlanFileRecord& record = view.files[i];
+                CachedConfigFile file;
+                file.file.fileName = view.String(record.fileName);
+                file.file.size = record.size;
+                file.file.lastWriteTime = record.lastWriteTime;
+                file.ok = record.entry != kNone;
+                if (file.ok) file.config = view.Entry(record.entry);
+                else file.error = TextEncoding::WideToUtf8(view.String(record.error));
+                files.push_back(std::move(file));
+            }
+            return true;
+        });
+    }
+
+    // 写入临时文件后替换，避免中途失败留下半个缓存
+    static bool Write(const std::wstring& cachePath, const std::vector<CachedConfigFile>& files) {
+        std::vector<uint32_t> entryFiles;
+        for (uint32_t i = 0; i < files.size(); i++) {
+            if (files[i].ok) entryFiles.push_back(i);
+        }
+        std::stable_sort(entryFiles.begin(), entryFiles.end(), [&](uint32_t a, uint32_t b) {
+            return files[a].config.order < files[b].config.order;
+        });
+
+        StringTable table;
+        std::vector<PlanFileRecord> fileRecords(files.size());
+        std::vector<PlanEntryRecord> entryRecords;
+        std::vector<uint32_t> lists;
+
+        for (uint32_t i = 0; i < files.size(); i++) {
+            PlanFileRecord& record = fileRecords[i];
+            record.size = files[i].file.size;
+            record.lastWriteTime = files[i].file.lastWriteTime;
+            record.fileName = table.Intern(files[i].file.fileName);
+            record.entry = kNone;
+            record.error = files[i].ok ? kNone : table.Intern(files[i].error);
+            record.reserved = 0;
+        }
+
+        auto optionalString = [&](const std::wstring& str) { return str.empty() ? kNone : table.Intern(str); };
+        auto appendList = [&](const std::vector<std::wstring>& items, uint32_t& first, uint32_t& count) {
+            first = static_cast<uint32_t>(lists.size());
+            count = static_cast<uint32_t>(items.size());
+            for (const auto& item : items) lists.push_back(table.Intern(item));
+        };
+
+        for (uint32_t fileIndex : entryFiles) {
+            const ProgramConfig& config = files[fileIndex].config;
+            PlanEntryRecord record = {};
+            record.order = config.order;
+            record.flags = (config.enabled ? uint32_t(kEnabled) : 0u) | (config.hasDependsOn ? uint32_t(kHasDependsOn) : 0u) |
+                (config.output.enabled ? uint32_t(kCaptureOutput) : 0u) | (config.killAnyByName ? uint32_t(kKillAnyByName) : 0u);
+            record.outputLogMaxKB = config.output.maxKB;
+            record.outputLogFiles = config.output.files;
+            record.type = static_cast<uint32_t>(config.type);
+            record.delayAfterStart = config.delayAfterStart;
+            record.delayMode = static_cast<uint32_t>(config.delayMode);
+            record.readinessType = static_cast<uint32_t>(config.readiness.type);
+            record.readinessTimeoutMs = config.readiness.timeoutMs;
+            record.admitMaxCpuPercent = config.admission.maxCpuPercent;
+            record.admitMaxDiskQueue = config.admission.maxDiskQueue;
+            record.admitMinFreeMemoryMB = config.admission.minFreeMemoryMB;
+            record.admitMaxWaitMs = config.admission.maxWaitMs;
+            record.restartMode = static_cast<uint32_t>(config.restart.mode);
+            record.restartDelayMs = config.restart.delayMs;
+            record.restartMaxDelayMs = config.restart.maxDelayMs;
+            record.restartLimit = config.restart.limit;
+            record.limitMemoryMB = config.limits.memoryMB;
+            record.limitCpuPercent = config.limits.cpuPercent;
+            record.priorityClass = static_cast<uint32_t>(config.scheduling.priorityClass);
+            record.ioPriority = static_cast<uint32_t>(config.scheduling.ioPriority);
+            record.memoryPriority = static_cast<uint32_t>(config.scheduling.memoryPriority);
+            record.cpuAffinity = optionalString(config.scheduling.cpuAffinity);
+            record.killAfterSeconds = config.killAfterSeconds;
+            record.path = table.Intern(config.path);
+            record.processNameToKill = optionalString(config.processNameToKill);
+            record.name = table.Intern(config.name);
+            record.description = optionalString(config.description);
+            record.readinessTarget = optionalString(config.readiness.target);
+            record.readinessPattern = optionalString(config.readiness.pattern);
+            appendList(config.arguments, record.firstArgument, record.argumentCount);
+            appendList(config.dependsOn, record.firstDependency, record.dependencyCount);
+            appendList(config.prefetch, record.firstPrefetch, record.prefetchCount);
+            record.ifRunning = static_cast<uint32_t>(config.ifRunning);
+            record.file = fileIndex;
+            fileRecords[fileIndex].entry = static_cast<uint32_t>(entryRecords.size());
+            entryRecords.push_back(record);
+        }
+
+        PlanHeader header = {};
+        std::string content(sizeof(PlanHeader), '\0');
+        auto appendSection = [&](const void* data, size_t bytes) {
+            content.append(static_cast<const char*>(data), bytes);
+        };
+        appendSection(fileRecords.data(), fileRecords.size() * sizeof(PlanFileRecord));
+        appendSection(entryRecords.data(), entryRecords.size() * sizeof(PlanEntryRecord));
+        appendSection(lists.data(), lists.size() * sizeof(uint32_t));
+        appendSection(table.strings.data(), table.strings.size() * sizeof(PlanString));
+        content += table.bytes;
+
+        std::memcpy(header.magic, "DCLP", 4);
+        header.version = kVersion;
+        header.fileCount = static_cast<uint32_t>(fileRecords.size());
+        header.entryCount = static_cast<uint32_t>(entryRecords.size());
+        header.listCount = static_cast<uint32_t>(lists.size());
+        header.stringCount = static_cast<uint32_t>(table.strings.size());
+        header.stringBytes = static_cast<uint32_t>(table.bytes.size());
+        header.checksum = Checksum(content.data() + sizeof(PlanHeader), content.size() - sizeof(PlanHeader));
+        std::memcpy(&content[0], &header, sizeof(PlanHeader));
+
+        return Platform::WriteFileAtomic(cachePath, content);
+    }
+
+    // 按启动顺序输出缓存内容
+    static bool Dump(const std::wstring& cachePath, std::ostream& out, std::string& error) {
+        return MapFile(cachePath, error, [&](const PlanView& view) {
+            const PlanHeader& header = *view.header;
+            out << "launch plan v" << header.version << ": " << header.fileCount << " files, "
+                << header.entryCount << " entries, " << header.stringCount << " strings ("
+                << header.stringBytes << " bytes)" << std::endl;
+
+            for (uint32_t i = 0; i < header.entryCount; i++) {
+                ProgramConfig config = view.Entry(i);
+                const PlanFileRecord& file = view.files[view.entries[i].file];
+                out << "  [" << config.order << "] " << TextEncoding::WideToUtf8(config.name)
+                    << (config.enabled ? "" : " (disabled)") << std::endl;
+                out << "      file: " << TextEncoding::WideToUtf8(view.String(file.fileName))
+                    << " size " << file.size << " mtime " << file.lastWriteTime << std::endl;
+                out << "      path: " << TextEncoding::WideToUtf8(config.path) << " type "
+                    << TextEncoding::WideToUtf8(ProgramTypeToString(config.type)) << " args "
+                    << config.arguments.size() << " delay " << config.delayAfterStart
+                    << (config.delayMode == DelayMode::Auto ? " (auto)" : "") << std::endl;
+                if (config.restart.mode != RestartMode::Never) {
+                    out << "      restart: " << TextEncoding::WideToUtf8(RestartModeToString(config.restart.mode))
+                        << " delay " << config.restart.delayMs << "-" << config.restart.maxDelayMs
+                        << " limit " << config.restart.limit << std::endl;
+                }
+                if (config.scheduling.Enabled()) {
+                    out << "      scheduling: priority " << static_cast<int>(config.scheduling.priorityClass)
+                        << " io " << static_cast<int>(config.scheduling.ioPriority)
+                        << " memory " << static_cast<int>(config.scheduling.memoryPriority)
+                        << " cpus " << TextEncoding::WideToUtf8(config.scheduling.cpuAffinity) << std::endl;
+                }
+                if (config.limits.Enabled()) {
+                    out << "      limits: mem " << config.limits.memoryMB << "MB cpu " << config.limits.cpuPercent << "%" << std::endl;
+                }
+                if (config.admission.Enabled()) {
+                    out << "      admission: cpu " << config.admission.maxCpuPercent << "% disk "
+                        << config.admission.maxDiskQueue << " mem " << config.admission.minFreeMemoryMB
+                        << "MB wait " << config.admission.maxWaitMs << std::endl;
+                }
+                if (config.output.enabled) {
+                    out << "      output: max " << config.output.maxKB << "KB files " << config.output.files << std::endl;
+                }
+                if (config.ifRunning != IfRunningPolicy::Start) {
+                    out << "      ifRunning: " << TextEncoding::WideToUtf8(IfRunningPolicyToString(config.ifRunning)) << std::endl;
+                }
+                if (!config.prefetch.empty()) {
+                    out << "      prefetch:";
+                    for (const auto& pattern : config.prefetch) out << " " << TextEncoding::WideToUtf8(pattern);
+                    out << std::endl;
+                }
+                if (config.hasDependsOn) {
+                    out << "      dependsOn:";
+                    for (const auto& dependency : config.dependsOn) out << " " << TextEncoding::WideToUtf8(dependency);
+                    out << std::endl;
+                }
+            }
+            for (uint32_t i = 0; i < header.fileCount; i++) {
+                if (view.files[i].entry != kNone) continue;
+                out << "  (failed) " << TextEncoding::WideToUtf8(view.String(view.files[i].fileName))
+                    << ": " << TextEncoding::WideToUtf8(view.String(view.files[i].error)) << std::endl;
+            }
+            return true;
+        });
+    }
+
+    // 校验缓存结构，并与文件夹当前内容逐个比对（过期记录和解析结果不一致均视为失败）
+    static bool Verify(const std::wstring& cachePath, const std::wstring& folder, std::ostream& out) {
+        std::vector<CachedConfigFile> cached;
+        std::string error;
+        if (!Read(cachePath, cached, error)) {
+            out << "✗ cache invalid: " << error << std::endl;
+            return false;
+        }
+
+        std::vector<ConfigFileInfo> current = ConfigLoader::ListJsonFiles(folder);
+        std::unordered_map<std::wstring, const CachedConfigFile*> byName;
+        for (const auto& file : cached) byName.emplace(file.file.fileName, &file);
+
+        size_t problems = 0;
+        for (const auto& info : current) {
+            std::string name = TextEncoding::WideToUtf8(info.fileName);
+            auto it = byName.find(info.fileName);
+            if (it == byName.end()) {
+                out << "✗ missing from cache: " << name << std::endl;
+                problems++;
+                continue;
+            }
+            const CachedConfigFile& file = *it->second;
+            byName.erase(it);
+            if (file.file.size != info.size || file.file.lastWriteTime != info.lastWriteTime) {
+                out << "✗ stale: " << name << std::endl;
+                problems++;
+                continue;
+            }
+
+            ProgramConfig parsed(0, true, L"", {}, ProgramType::Exe, 2000);
+            std::string parseError;
+            bool ok = ConfigLoader::LoadFile(Platform::JoinPath(folder, info.fileName), parsed, parseError);
+            if (ok != file.ok || (ok && !SameConfig(parsed, file.config))) {
+                out << "✗ content differs: " << name << std::endl;
+                problems++;
+            }
+        }
+        for (const auto& removed : byName) {
+            out << "✗ file no longer exists: " << TextEncoding::WideToUtf8(removed.first) << std::endl;
+            problems++;
+        }
+
+        out << (problems == 0 ? "✓ cache is up to date: " : "✗ cache problems: ")
+            << (problems == 0 ? cached.size() : problems) << std::endl;
+        return problems == 0;
+    }
+};
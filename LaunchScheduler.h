@@ -0,0 +1,266 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <queue>
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <unordered_map>
+#include "ProgramConfig.h"
+#include "TimerService.h"
+
+// 启动依赖图
+// 显式写了dependsOn的程序只等待其列出的前置程序；
+// 未写dependsOn的程序保持原有行为，按order串行等待上一个同类程序。
+class LaunchGraph {
+public:
+    enum class NodeState { Waiting, Ready, Running, Done, Failed, Skipped };
+
+private:
+    struct Edge {
+        size_t to;
+        bool explicitDependency;      // 来自dependsOn（前置失败时跳过后继）
+    };
+
+    std::vector<std::vector<Edge>> dependents;
+    std::vector<int> initialPending;
+    std::vector<int> pending;
+    std::vector<NodeState> states;
+    std::vector<bool> cyclic;
+    // 按下标（即order顺序）取最小者，保证无依赖程序仍按order启动
+    std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> ready;
+    size_t remaining = 0;
+
+    void Release(size_t index) {
+        states[index] = NodeState::Ready;
+        ready.push(index);
+    }
+
+    void SkipDependents(size_t index) {
+        for (const Edge& edge : dependents[index]) {
+            if (states[edge.to] != NodeState::Waiting) continue;
+            if (edge.explicitDependency) {
+                states[edge.to] = NodeState::Skipped;
+                remaining--;
+                SkipDependents(edge.to);
+            }
+            else if (--pending[edge.to] == 0) {
+                Release(edge.to);
+            }
+        }
+    }
+
+public:
+    // programs 必须已按order排序
+    void Build(const std::vector<ProgramConfig>& programs, std::vector<std::wstring>& warnings) {
+        size_t count = programs.size();
+        dependents.assign(count, {});
+        initialPending.assign(count, 0);
+        cyclic.assign(count, false);
+
+        std::unordered_map<std::wstring, size_t> indexByName;
+        for (size_t i = 0; i < count; i++) {
+            indexByName.emplace(programs[i].name, i);
+        }
+
+        const size_t none = static_cast<size_t>(-1);
+        size_t previousImplicit = none;
+        for (size_t i = 0; i < count; i++) {
+            const ProgramConfig& config = programs[i];
+            if (!config.hasDependsOn) {
+                if (previousImplicit != none) {
+                    dependents[previousImplicit].push_back({ i, false });
+                    initialPending[i]++;
+                }
+                previousImplicit = i;
+                continue;
+            }
+
+            for (const auto& dependency : config.dependsOn) {
+                auto it = indexByName.find(dependency);
+                if (it == indexByName.end()) {
+                    warnings.push_back(config.name + L": 依赖 " + dependency + L" 不存在或未启用，已忽略");
+                    continue;
+                }
+                dependents[it->second].push_back({ i, true });
+                initialPending[i]++;
+            }
+        }
+
+        // Kahn算法检测环，环上及其下游的程序不会被启动
+        std::vector<int> indegree = initialPending;
+        std::vector<size_t> queue;
+        for (size_t i = 0; i < count; i++) {
+            if (indegree[i] == 0) queue.push_back(i);
+        }
+        for (size_t head = 0; head < queue.size(); head++) {
+            for (const Edge& edge : dependents[queue[head]]) {
+                if (--indegree[edge.to] == 0) queue.push_back(edge.to);
+            }
+        }
+        if (queue.size() != count) {
+            for (size_t i = 0; i < count; i++) {
+                if (indegree[i] > 0) {
+                    cyclic[i] = true;
+                    warnings.push_back(programs[i].name + L": 存在循环依赖，将不会启动");
+                }
+            }
+        }
+
+        Reset();
+    }
+
+    void Reset() {
+        pending = initialPending;
+        states.assign(pending.size(), NodeState::Waiting);
+        ready = {};
+        remaining = 0;
+        for (size_t i = 0; i < pending.size(); i++) {
+            if (cyclic[i]) {
+                states[i] = NodeState::Skipped;
+                continue;
+            }
+            remaining++;
+            if (pending[i] == 0) Release(i);
+        }
+    }
+
+    size_t Size() const { return states.size(); }
+
+    bool HasDependents(size_t index) const { return !dependents[index].empty(); }
+
+    NodeState State(size_t index) const { return states[index]; }
+
+    // visit(后继下标)，用于模拟时找出是哪个前置程序释放了后继
+    template <typename Visitor>
+    void ForEachDependent(size_t index, Visitor visit) const {
+        for (const Edge& edge : dependents[index]) visit(edge.to);
+    }
+
+    bool Finished() const { return remaining == 0; }
+
+    // 取出order最小的就绪程序
+    bool PopReady(size_t& index) {
+        if (ready.empty()) return false;
+        index = ready.top();
+        ready.pop();
+        states[index] = NodeState::Running;
+        return true;
+    }
+
+    // 标记程序启动完成（成功或失败），释放其后继
+    void Complete(size_t index, bool success) {
+        states[index] = success ? NodeState::Done : NodeState::Failed;
+        remaining--;
+        if (!success) {
+            SkipDependents(index);
+            return;
+        }
+        for (const Edge& edge : dependents[index]) {
+            if (states[edge.to] == NodeState::Waiting && --pending[edge.to] == 0) {
+                Release(edge.to);
+            }
+        }
+    }
+};
+
+// 启动调度器：最多maxParallel个程序同时处于"启动中"状态
+class LaunchScheduler {
+public:
+    using LaunchFunction = std::function<bool(size_t)>;   // 启动程序，返回是否成功
+    using WaitFunction = std::function<void(size_t)>;     // 等待程序就绪（仅有后继时调用）
+
+    static void Run(LaunchGraph& graph, int maxParallel,
+        const LaunchFunction& launch, const WaitFunction& waitReady) {
+        std::mutex mutex;
+        std::condition_variable cv;
+
+        auto worker = [&]() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                size_t index = 0;
+                bool taken = false;
+                cv.wait(lock, [&]() {
+                    taken = graph.PopReady(index);
+                    return taken || graph.Finished();
+                    });
+                if (!taken) return;
+
+                lock.unlock();
+                bool success = launch(index);
+                if (success && graph.HasDependents(index)) {
+                    waitReady(index);
+                }
+                lock.lock();
+
+                graph.Complete(index, success);
+                cv.notify_all();
+            }
+        };
+
+        if (maxParallel < 1) maxParallel = 1;
+        std::vector<std::thread> workers;
+        size_t workerCount = (std::min)(static_cast<size_t>(maxParallel), graph.Size());
+        for (size_t i = 0; i < workerCount; i++) {
+            workers.emplace_back(worker);
+        }
+        for (auto& thread : workers) {
+            thread.join();
+        }
+    }
+
+    // 虚拟时钟下的同一调度：不创建线程，launch只返回模拟的耗时和结果，由clock按时间顺序推进
+    // 槽位数、按order取就绪程序、仅有后继时等待就绪、完成后释放后继，均与Run一致；结果是确定的
+    struct VirtualLaunch {
+        int launchMs = 0;             // 启动本身的耗时
+        bool success = true;
+        int readyMs = 0;              // 启动后到就绪的时间（仅有后继时等待）
+    };
+
+    struct VirtualObserver {
+        std::function<void(size_t)> started;              // 占用槽位开始启动
+        std::function<void(size_t, bool)> launched;       // 启动结束（成功或失败）
+        std::function<void(size_t)> completed;            // 已标记完成，后继已释放，槽位尚未重新分配
+    };
+
+    using VirtualLaunchFunction = std::function<VirtualLaunch(size_t)>;
+
+    // 返回时图中所有条目均已完成或被跳过；clock中由observer安排的其他定时器可能尚未到期
+    static void RunVirtual(LaunchGraph& graph, int maxParallel, TimerService& clock,
+        const VirtualLaunchFunction& launch, const VirtualObserver& observer = VirtualObserver()) {
+        if (maxParallel < 1) maxParallel = 1;
+        size_t freeSlots = (std::min)(static_cast<size_t>(maxParallel), graph.Size());
+
+        std::function<void()> fill = [&]() {
+            size_t index = 0;
+            while (freeSlots > 0 && graph.PopReady(index)) {
+                freeSlots--;
+                if (observer.started) observer.started(index);
+                VirtualLaunch step = launch(index);
+                clock.Schedule(std::chrono::milliseconds((std::max)(step.launchMs, 0)), [&, index, step]() {
+                    if (observer.launched) observer.launched(index, step.success);
+                    auto finish = [&, index, step]() {
+                        graph.Complete(index, step.success);
+                        if (observer.completed) observer.completed(index);
+                        freeSlots++;
+                        fill();
+                    };
+                    if (step.success && graph.HasDependents(index)) {
+                        clock.Schedule(std::chrono::milliseconds((std::max)(step.readyMs, 0)), finish);
+                    }
+                    else {
+                        finish();
+                    }
+                });
+            }
+        };
+
+        fill();
+        std::chrono::milliseconds remaining(0);
+        while (!graph.Finished() && clock.NextDeadline(remaining)) {
+            clock.AdvanceBy((std::max)(remaining, std::chrono::milliseconds(0)));
+        }
+    }
+};
@@ -0,0 +1,216 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cwchar>
+#include "ProgramConfig.h"
+#include "LaunchScheduler.h"
+#include "LaunchHistory.h"
+#include "TimerService.h"
+#include "Platform.h"
+
+// 启动模拟：用虚拟时钟和假的启动函数执行与实际启动相同的调度（LaunchScheduler::RunVirtual），
+// 不创建任何进程、不真实等待。输出每个条目的时间线、总耗时和决定总耗时的关键路径。
+// 每个条目的耗时由EntryModel给出，可以来自启动历史，也可以由调用方直接构造（结果确定，可用于测试调度）。
+class LaunchSimulator {
+public:
+    static constexpr size_t kNone = static_cast<size_t>(-1);
+    static constexpr int kDefaultSpawnMs = 10;        // 没有历史时假定的创建进程耗时
+
+    // 条目的耗时模型
+    struct EntryModel {
+        int spawnMs = kDefaultSpawnMs;
+        int readyMs = 0;              // 启动后到依赖者可以启动的时间
+        bool fails = false;           // 模拟启动失败（例如程序文件不存在）
+        std::wstring source;          // readyMs的来源，显示在时间线中
+    };
+
+    // 模拟结果，时间均为相对开始的毫秒数，-1表示未发生
+    struct EntryResult {
+        int64_t startMs = -1;         // 占用槽位开始启动
+        int64_t launchedMs = -1;      // 启动结束
+        int64_t doneMs = -1;          // 完成（有后继时为就绪），之后释放后继
+        int64_t killMs = -1;          // 定时关闭
+        bool success = false;
+        size_t gate = kNone;          // 决定开始时间的条目：释放它的前置程序，或腾出槽位的程序
+        bool gateIsSlot = false;      // 开始时间由并行上限决定
+    };
+
+    struct Result {
+        std::vector<EntryResult> entries;
+        int64_t makespanMs = 0;       // 最后一个条目完成的时间（即实际启动时LaunchPlan返回的时间）
+        std::vector<size_t> criticalPath;   // 从第一个到最后完成的条目
+    };
+
+    // 与launcher的等待逻辑一致：有就绪条件时按历史的启动耗时（没有历史时按超时上限），
+    // 否则按delayAfterStart（auto条目按历史学习到的值）；history为空时只使用配置值
+    static EntryModel ModelFor(const ProgramConfig& config, const LaunchHistory* history) {
+        EntryModel model;
+        LaunchHistory::Stats stats;
+        if (history) stats = history->StatsOf(config.name);
+        if (stats.lastSpawnMs >= 0) model.spawnMs = stats.lastSpawnMs;
+        model.fails = config.type != ProgramType::Bat && !Platform::FileExists(config.path);
+
+        if (config.readiness.type == ReadinessType::ProcessAlive) {
+            model.readyMs = ParseInt(config.readiness.target);
+            model.source = L"alive";
+        }
+        else if (config.readiness.type != ReadinessType::None) {
+            if (stats.learnedMs >= 0) {
+                model.readyMs = (std::min)(stats.learnedMs, config.readiness.timeoutMs);
+                model.source = L"历史 p" + std::to_wstring(LaunchHistory::kPercentile);
+            }
+            else {
+                model.readyMs = config.readiness.timeoutMs;
+                model.source = L"超时上限";
+            }
+        }
+        else if (config.delayMode == DelayMode::Auto && history) {
+            model.readyMs = history->DelayFor(config.name, config.delayAfterStart);
+            model.source = stats.learnedMs >= 0 ? L"auto 历史" : L"auto 配置值";
+        }
+        else {
+            model.readyMs = config.delayAfterStart;
+            model.source = L"delayAfterStart";
+        }
+        if (config.admission.Enabled()) model.source += L"，准入等待未计入";
+        return model;
+    }
+
+    // programs须已按order排序，graph由同一列表构建
+    static Result Run(const std::vector<ProgramConfig>& programs, const std::vector<EntryModel>& models,
+        LaunchGraph& graph, int maxParallel) {
+        TimerService clock{ TimerService::VirtualClockTag() };
+        const TimerService::TimePoint origin = clock.Now();
+        auto now = [&]() {
+            return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(clock.Now() - origin).count());
+        };
+
+        Result result;
+        result.entries.assign(programs.size(), EntryResult());
+        std::vector<int64_t> readyAt(programs.size(), -1);
+        std::vector<size_t> releasedBy(programs.size(), kNone);
+        size_t lastCompleted = kNone;
+
+        LaunchScheduler::VirtualObserver observer;
+        observer.started = [&](size_t index) {
+            EntryResult& entry = result.entries[index];
+            entry.startMs = now();
+            if (readyAt[index] < 0) {
+                readyAt[index] = entry.startMs;
+                releasedBy[index] = lastCompleted;
+            }
+            // 就绪后没有立即开始，说明在等待空闲槽位
+            entry.gateIsSlot = readyAt[index] < entry.startMs;
+            entry.gate = entry.gateIsSlot ? lastCompleted : releasedBy[index];
+        };
+        observer.launched = [&](size_t index, bool success) {
+            EntryResult& entry = result.entries[index];
+            entry.launchedMs = now();
+            entry.success = success;
+            int killAfter = programs[index].killAfterSeconds;
+            if (success && killAfter > 0) {
+                clock.Schedule(std::chrono::seconds(killAfter), [&, index]() { result.entries[index].killMs = now(); });
+            }
+        };
+        observer.completed = [&](size_t index) {
+            result.entries[index].doneMs = now();
+            lastCompleted = index;
+            graph.ForEachDependent(index, [&](size_t dependent) {
+                if (readyAt[dependent] < 0 && graph.State(dependent) == LaunchGraph::NodeState::Ready) {
+                    readyAt[dependent] = now();
+                    releasedBy[dependent] = index;
+                }
+            });
+        };
+
+        graph.Reset();
+        for (size_t i = 0; i < graph.Size(); i++) {
+            if (graph.State(i) == LaunchGraph::NodeState::Ready) readyAt[i] = 0;
+        }
+        LaunchScheduler::RunVirtual(graph, maxParallel, clock, [&](size_t index) {
+            LaunchScheduler::VirtualLaunch step;
+            step.launchMs = models[index].spawnMs;
+            step.success = !models[index].fails;
+            step.readyMs = models[index].readyMs;
+            return step;
+        }, observer);
+
+        // 继续推进到所有定时关闭执行完
+        std::chrono::milliseconds remaining(0);
+        while (clock.NextDeadline(remaining)) {
+            clock.AdvanceBy((std::max)(remaining, std::chrono::milliseconds(0)));
+        }
+
+        size_t last = kNone;
+        for (size_t i = 0; i < result.entries.size(); i++) {
+            const EntryResult& entry = result.entries[i];
+            if (entry.doneMs < 0) continue;
+            if (last == kNone || entry.doneMs >= result.entries[last].doneMs) last = i;
+        }
+        if (last != kNone) result.makespanMs = result.entries[last].doneMs;
+        for (size_t index = last; index != kNone; index = result.entries[index].gate) {
+            result.criticalPath.push_back(index);
+        }
+        std::reverse(result.criticalPath.begin(), result.criticalPath.end());
+        return result;
+    }
+
+    static std::wstring Report(const std::vector<ProgramConfig>& programs, const std::vector<EntryModel>& models,
+        const Result& result, int maxParallel) {
+        std::wstring report = L"模拟时间线 (" + std::to_wstring(programs.size()) + L" 个条目，并行上限 " +
+            std::to_wstring(maxParallel) + L"):\n      开始      启动完成      完成  条目";
+        for (size_t i = 0; i < programs.size(); i++) {
+            const EntryResult& entry = result.entries[i];
+            report += L"\n  ";
+            if (entry.startMs < 0) {
+                report += L"        -           -         -  " + programs[i].name + L"  未启动（依赖失败或循环依赖）";
+                continue;
+            }
+            report += Seconds(entry.startMs) + L"  " + Seconds(entry.launchedMs) + L"  " + Seconds(entry.doneMs) +
+                L"  " + programs[i].name;
+            if (!entry.success) {
+                report += L"  ✗ 启动失败";
+            }
+            else if (entry.doneMs > entry.launchedMs) {
+                report += L"  等待 " + std::to_wstring(models[i].readyMs) + L"ms (" + models[i].source + L")";
+            }
+            if (entry.gateIsSlot) report += L"  [等待空闲槽位]";
+            if (entry.killMs >= 0) report += L"  定时关闭于 " + Trim(Seconds(entry.killMs)) + L"s";
+        }
+
+        report += L"\n总耗时: " + Trim(Seconds(result.makespanMs)) + L"s\n关键路径:";
+        for (size_t step = 0; step < result.criticalPath.size(); step++) {
+            size_t index = result.criticalPath[step];
+            const EntryResult& entry = result.entries[index];
+            report += std::wstring(step == 0 ? L"\n    " : (entry.gateIsSlot ? L"\n  ⇢ " : L"\n  → ")) + programs[index].name +
+                L" (" + Trim(Seconds(entry.startMs)) + L"s → " + Trim(Seconds(entry.doneMs)) + L"s)";
+        }
+        report += L"\n（→ 等待依赖，⇢ 等待并行槽位）";
+        return report;
+    }
+
+private:
+    static int ParseInt(const std::wstring& text) {
+        try {
+            return std::stoi(text);
+        }
+        catch (...) {
+            return 0;
+        }
+    }
+
+    // 右对齐的秒数（毫秒精度）
+    static std::wstring Seconds(int64_t ms) {
+        wchar_t buffer[32];
+        swprintf(buffer, sizeof(buffer) / sizeof(buffer[0]), L"%9.3f", static_cast<double>(ms) / 1000);
+        return buffer;
+    }
+
+    static std::wstring Trim(const std::wstring& text) {
+        size_t first = text.find_first_not_of(L' ');
+        return first == std::wstring::npos ? text : text.substr(first);
+    }
+};
@@ -0,0 +1,165 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <chrono>
+#include <thread>
+#include "Platform.h"
+#include "ProgramConfig.h"
+#include "LaunchScheduler.h"
+#include "LaunchSimulator.h"
+#include "GameController.h"
+#include "TimerService.h"
+#include "TextEncoding.h"
+
+// 调度测试：用固定的计划和耗时模型执行LaunchSimulator::Run（虚拟时钟上的LaunchScheduler::RunVirtual），
+// 检查每个条目的开始时间、定时关闭时间、总耗时和关键路径。结果确定，不创建进程、不真实等待。
+// 另外以自身（--stand-in模式，仅休眠）作为已在运行的目标，检查接管后的定时关闭（虚拟时钟触发）。
+// 用法: LaunchSimulatorTest [--verbose]   任一检查失败时返回1
+
+static int failures = 0;
+
+static void Expect(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAIL: " << what << std::endl;
+        failures++;
+    }
+}
+
+static void ExpectEqual(int64_t actual, int64_t expected, const std::string& what) {
+    Expect(actual == expected, what + ": expected " + std::to_string(expected) + ", got " + std::to_string(actual));
+}
+
+// 固定计划：e0..e3同时就绪，创建进程耗时100·(i+1)毫秒，就绪耗时1000毫秒；e3依赖e0，e1启动5秒后定时关闭
+static std::vector<ProgramConfig> MakePlan() {
+    std::vector<ProgramConfig> programs;
+    for (int i = 0; i < 4; i++) {
+        ProgramConfig config;
+        config.order = i;
+        config.name = L"e" + std::to_wstring(i);
+        config.path = L"e" + std::to_wstring(i) + L".exe";
+        config.hasDependsOn = true;
+        programs.push_back(config);
+    }
+    programs[3].dependsOn = { L"e0" };
+    programs[1].killAfterSeconds = 5;
+    return programs;
+}
+
+static std::vector<LaunchSimulator::EntryModel> MakeModels(size_t count) {
+    std::vector<LaunchSimulator::EntryModel> models(count);
+    for (size_t i = 0; i < count; i++) {
+        models[i].spawnMs = 100 * static_cast<int>(i + 1);
+        models[i].readyMs = 1000;
+        models[i].source = L"test";
+    }
+    return models;
+}
+
+static LaunchSimulator::Result Simulate(const std::vector<ProgramConfig>& programs,
+    const std::vector<LaunchSimulator::EntryModel>& models, int maxParallel, bool verbose) {
+    LaunchGraph graph;
+    std::vector<std::wstring> warnings;
+    graph.Build(programs, warnings);
+    for (const auto& warning : warnings) Expect(false, "graph warning: " + TextEncoding::WideToUtf8(warning));
+
+    LaunchSimulator::Result result = LaunchSimulator::Run(programs, models, graph, maxParallel);
+    if (verbose) std::cout << TextEncoding::WideToUtf8(LaunchSimulator::Report(programs, models, result, maxParallel)) << std::endl;
+    return result;
+}
+
+static void CheckTimeline(const LaunchSimulator::Result& result, const std::string& label,
+    const std::vector<int64_t>& starts, int64_t killMs, int64_t makespanMs, const std::vector<size_t>& criticalPath) {
+    for (size_t i = 0; i < starts.size(); i++) {
+        ExpectEqual(result.entries[i].startMs, starts[i], label + " e" + std::to_string(i) + " start");
+        Expect(result.entries[i].success, label + " e" + std::to_string(i) + " success");
+    }
+    for (size_t i = 0; i < result.entries.size(); i++) {
+        ExpectEqual(result.entries[i].killMs, i == 1 ? killMs : -1, label + " e" + std::to_string(i) + " kill");
+    }
+    ExpectEqual(result.makespanMs, makespanMs, label + " makespan");
+    Expect(result.criticalPath == criticalPath, label + " critical path");
+}
+
+// 并行上限2：e2等e1启动完成后的空闲槽位，e3等e0就绪；关键路径为e0 → e3
+static void TestParallel(bool verbose) {
+    std::vector<ProgramConfig> programs = MakePlan();
+    LaunchSimulator::Result result = Simulate(programs, MakeModels(programs.size()), 2, verbose);
+    CheckTimeline(result, "parallel 2", { 0, 0, 200, 1100 }, 5200, 1500, { 0, 3 });
+    Expect(!result.entries[3].gateIsSlot && result.entries[3].gate == 0, "parallel 2 e3 gated by dependency e0");
+}
+
+// 并行上限1：条目依次占用唯一的槽位，关键路径经过全部条目且由槽位决定
+static void TestSerial(bool verbose) {
+    std::vector<ProgramConfig> programs = MakePlan();
+    LaunchSimulator::Result result = Simulate(programs, MakeModels(programs.size()), 1, verbose);
+    CheckTimeline(result, "parallel 1", { 0, 1100, 1300, 1600 }, 6300, 2000, { 0, 1, 2, 3 });
+    for (size_t i = 1; i < result.entries.size(); i++) {
+        Expect(result.entries[i].gateIsSlot, "parallel 1 e" + std::to_string(i) + " gated by slot");
+    }
+}
+
+// 启动失败：失败条目不安排定时关闭，依赖它的条目不启动
+static void TestFailure(bool verbose) {
+    std::vector<ProgramConfig> programs = MakePlan();
+    std::vector<LaunchSimulator::EntryModel> models = MakeModels(programs.size());
+    models[0].fails = true;
+    models[1].fails = true;
+    LaunchSimulator::Result result = Simulate(programs, models, 2, verbose);
+    Expect(!result.entries[0].success && !result.entries[1].success, "failure e0/e1 reported as failed");
+    ExpectEqual(result.entries[1].killMs, -1, "failure e1 kill");
+    ExpectEqual(result.entries[3].startMs, -1, "failure e3 start");
+    Expect(result.entries[2].success, "failure e2 success");
+}
+
+// 接管按processNameToKill匹配到的进程（与path的文件名不同）：定时关闭应按句柄关闭接管的进程本身
+static void TestAttachKill() {
+    Platform::SpawnRequest request;
+    request.path = Platform::ExecutablePath();
+    request.arguments = { L"--stand-in" };
+    Platform::ProcessHandle standIn;
+    if (request.path.empty() || !Platform::Spawn(request, standIn)) {
+        Expect(false, "attach kill: cannot spawn stand-in");
+        return;
+    }
+
+    ProgramConfig config;
+    config.name = L"attached";
+    config.path = L"platform_client.exe";
+    config.processNameToKill = Platform::FileNameOf(request.path);
+    config.ifRunning = IfRunningPolicy::Attach;
+    config.killAfterSeconds = 5;
+
+    TimerService clock{ TimerService::VirtualClockTag() };
+    {
+        GameController controller;
+        controller.SetTimerService(clock);
+        Expect(controller.Initialize(config) && controller.Attach(standIn.pid), "attach kill: attach");
+        clock.AdvanceBy(std::chrono::seconds(4));
+        Expect(Platform::WaitForExit(standIn, 0) == Platform::WaitResult::TimedOut, "attach kill: alive before kill time");
+        clock.AdvanceBy(std::chrono::seconds(1));
+        Expect(Platform::WaitForExit(standIn, 5000) == Platform::WaitResult::Exited, "attach kill: closed at kill time");
+    }
+    if (Platform::WaitForExit(standIn, 0) == Platform::WaitResult::TimedOut) Platform::Terminate(standIn);
+    Platform::CloseProcess(standIn);
+}
+
+int main(int argc, char* argv[]) {
+    // 替身进程：什么也不做，等待被关闭
+    if (argc >= 2 && std::string(argv[1]) == "--stand-in") {
+        std::this_thread::sleep_for(std::chrono::seconds(60));
+        return 0;
+    }
+
+    bool verbose = argc >= 2 && std::string(argv[1]) == "--verbose";
+    TestParallel(verbose);
+    TestSerial(verbose);
+    TestFailure(verbose);
+    TestAttachKill();
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "LaunchSimulatorTest: all checks passed" << std::endl;
+    return 0;
+}
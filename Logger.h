@@ -0,0 +1,276 @@
+#pragma once
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include "TextEncoding.h"
+#include "RotatingFile.h"
+
+enum class LogLevel { Debug, Info, Warning, Error, Off };
+
+// 异步日志：调用线程只把记录放入无锁的多生产者单消费者环形缓冲区，
+// 时间格式化、UTF-8转换以及控制台/文件写入都在后台线程上批量完成。
+// 时间戳按秒缓存，同一秒内的记录不再重复格式化。
+// 需要与同步输出（例如"按任意键退出"提示）保持顺序时先调用Flush。
+class Logger {
+private:
+    static constexpr size_t kCapacity = 4096;     // 必须是2的幂
+
+    struct Record {
+        LogLevel level = LogLevel::Info;
+        bool timestamped = true;                  // 控制台输出是否带[HH:MM:SS]前缀
+        std::chrono::system_clock::time_point time;
+        std::string utf8;                         // 两者只使用其一，宽字符串在后台线程转换
+        std::wstring wide;
+    };
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<size_t> enqueuePosition{ 0 };
+    size_t dequeuePosition = 0;                   // 仅后台线程访问
+
+    std::atomic<int> minimumLevel{ static_cast<int>(LogLevel::Info) };
+    std::atomic<bool> sleeping{ false };
+    std::mutex mutex;                             // 保护下列成员以及唤醒/Flush等待
+    std::condition_variable wakeup;
+    std::condition_variable drained;
+    size_t written = 0;                           // 已写出的记录数
+    bool consoleEnabled = true;
+    RotatingFile file;
+
+    // 时间戳缓存
+    time_t cachedSecond = -1;
+    char cachedClock[16] = {};                    // HH:MM:SS
+    char cachedDate[32] = {};                     // YYYY-MM-DD HH:MM:SS
+
+    Logger() : slots(new Slot[kCapacity]) {
+        for (size_t i = 0; i < kCapacity; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+        std::thread([this]() { WorkerLoop(); }).detach();
+        std::atexit([]() { Shared().Flush(); });
+    }
+
+    bool TryPush(Record& record) {
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots[position & (kCapacity - 1)];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            }
+            else if (difference < 0) {
+                return false;                     // 已满
+            }
+            else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        slot->record = std::move(record);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPop(Record& record) {
+        Slot& slot = slots[dequeuePosition & (kCapacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1) return false;
+        record = std::move(slot.record);
+        slot.sequence.store(dequeuePosition + kCapacity, std::memory_order_release);
+        dequeuePosition++;
+        return true;
+    }
+
+    bool HasPending() {
+        Slot& slot = slots[dequeuePosition & (kCapacity - 1)];
+        return slot.sequence.load(std::memory_order_acquire) == dequeuePosition + 1;
+    }
+
+    void WakeWorker() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(mutex);
+            wakeup.notify_one();
+        }
+    }
+
+    void UpdateTimestamp(std::chrono::system_clock::time_point time) {
+        time_t second = std::chrono::system_clock::to_time_t(time);
+        if (second == cachedSecond) return;
+        cachedSecond = second;
+        struct tm local = {};
+#ifdef _WIN32
+        localtime_s(&local, &second);
+#else
+        localtime_r(&second, &local);
+#endif
+        strftime(cachedClock, sizeof(cachedClock), "%H:%M:%S", &local);
+        strftime(cachedDate, sizeof(cachedDate), "%Y-%m-%d %H:%M:%S", &local);
+    }
+
+    static const char* LevelTag(LogLevel level) {
+        switch (level) {
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Warning: return "WARN ";
+        case LogLevel::Error: return "ERROR";
+        default: return "INFO ";
+        }
+    }
+
+    void Format(const Record& record, std::string& console, std::string& fileText) {
+        UpdateTimestamp(record.time);
+        std::string converted;
+        const std::string* text = &record.utf8;
+        if (!record.wide.empty()) {
+            converted = TextEncoding::WideToUtf8(record.wide);
+            text = &converted;
+        }
+        if (record.timestamped) {
+            console += '[';
+            console += cachedClock;
+            console += "] ";
+        }
+        console += *text;
+        console += '\n';
+
+        fileText += cachedDate;
+        fileText += ' ';
+        fileText += LevelTag(record.level);
+        fileText += ' ';
+        fileText += *text;
+        fileText += '\n';
+    }
+
+    void WorkerLoop() {
+        std::string console;
+        std::string fileText;
+        Record record;
+        while (true) {
+            console.clear();
+            fileText.clear();
+            size_t count = 0;
+            while (count < kCapacity && TryPop(record)) {
+                Format(record, console, fileText);
+                count++;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            if (count > 0) {
+                if (consoleEnabled) {
+                    fwrite(console.data(), 1, console.size(), stdout);
+                    fflush(stdout);
+                }
+                file.Write(fileText);
+                written += count;
+                drained.notify_all();
+                continue;
+            }
+
+            sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!HasPending()) wakeup.wait_for(lock, std::chrono::milliseconds(100));
+            sleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    void Push(Record& record) {
+        record.time = std::chrono::system_clock::now();
+        // 缓冲区满时等待后台线程写出，状态信息不丢弃
+        while (!TryPush(record)) {
+            WakeWorker();
+            std::this_thread::yield();
+        }
+        WakeWorker();
+    }
+
+public:
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // 进程内唯一实例，不析构，进程退出时自动Flush
+    static Logger& Shared() {
+        static Logger* logger = new Logger();
+        return *logger;
+    }
+
+    static bool ParseLevel(const std::string& name, LogLevel& level) {
+        if (name == "debug") level = LogLevel::Debug;
+        else if (name == "info") level = LogLevel::Info;
+        else if (name == "warning" || name == "warn") level = LogLevel::Warning;
+        else if (name == "error") level = LogLevel::Error;
+        else if (name == "off") level = LogLevel::Off;
+        else return false;
+        return true;
+    }
+
+    void SetLevel(LogLevel level) {
+        minimumLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+
+    bool IsEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= minimumLevel.load(std::memory_order_relaxed) && level != LogLevel::Off;
+    }
+
+    void SetConsoleEnabled(bool enabled) {
+        std::lock_guard<std::mutex> lock(mutex);
+        consoleEnabled = enabled;
+    }
+
+    // 同时写入滚动日志文件（单个文件超过maxBytes后滚动，最多保留maxFiles个）
+    bool OpenFile(const std::wstring& path, uint64_t maxBytes = 4 * 1024 * 1024, int maxFiles = 3) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return file.Open(path, maxBytes, maxFiles);
+    }
+
+    void Write(LogLevel level, std::wstring text, bool timestamped = true) {
+        if (!IsEnabled(level)) return;
+        Record record;
+        record.level = level;
+        record.timestamped = timestamped;
+        record.wide = std::move(text);
+        Push(record);
+    }
+
+    void Write(LogLevel level, std::string utf8, bool timestamped = true) {
+        if (!IsEnabled(level)) return;
+        Record record;
+        record.level = level;
+        record.timestamped = timestamped;
+        record.utf8 = std::move(utf8);
+        Push(record);
+    }
+
+    void Write(LogLevel level, const char* utf8, bool timestamped = true) {
+        Write(level, std::string(utf8), timestamped);
+    }
+
+    void Write(LogLevel level, const wchar_t* text, bool timestamped = true) {
+        Write(level, std::wstring(text), timestamped);
+    }
+
+    void Debug(std::wstring text) { Write(LogLevel::Debug, std::move(text)); }
+    void Info(std::wstring text) { Write(LogLevel::Info, std::move(text)); }
+    void Warning(std::wstring text) { Write(LogLevel::Warning, std::move(text)); }
+    void Error(std::wstring text) { Write(LogLevel::Error, std::move(text)); }
+
+    // 不带时间戳的输出（多行信息块、分隔线等）
+    void Print(std::wstring text) { Write(LogLevel::Info, std::move(text), false); }
+
+    // 等待此前写入的记录全部输出
+    void Flush() {
+        size_t target = enqueuePosition.load(std::memory_order_acquire);
+        WakeWorker();
+        std::unique_lock<std::mutex> lock(mutex);
+        drained.wait(lock, [&]() { return written >= target; });
+    }
+};
@@ -0,0 +1,193 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <initializer_list>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include "Platform.h"
+
+// 运行指标：计数器和固定分桶直方图，记录时只有原子加法（不加锁）；
+// 导出为Prometheus文本格式，写到node_exporter textfile collector读取的目录中（原子替换，不会读到半个文件）。
+// 指标只在本进程内累计：单独的GameController.exe进程中的启动不计入启动器的指标。
+class Metrics {
+public:
+    class Counter {
+    private:
+        std::atomic<uint64_t> value{ 0 };
+
+    public:
+        void Add(uint64_t count = 1) {
+            value.fetch_add(count, std::memory_order_relaxed);
+        }
+
+        uint64_t Value() const {
+            return value.load(std::memory_order_relaxed);
+        }
+    };
+
+    // 按整数标签（例如错误码）计数：固定大小的开放寻址表，空槽位用CAS占用，表满后计入overflow
+    class CodeCounter {
+    private:
+        static constexpr size_t kSlots = 32;
+        static constexpr int64_t kEmpty = INT64_MIN;
+
+        struct Slot {
+            std::atomic<int64_t> code{ kEmpty };
+            std::atomic<uint64_t> count{ 0 };
+        };
+
+        Slot slots[kSlots];
+        Counter overflow;
+
+    public:
+        void Add(int code) {
+            size_t start = static_cast<uint32_t>(code) % kSlots;
+            for (size_t i = 0; i < kSlots; i++) {
+                Slot& slot = slots[(start + i) % kSlots];
+                int64_t current = slot.code.load(std::memory_order_acquire);
+                if (current == kEmpty && slot.code.compare_exchange_strong(current, code, std::memory_order_acq_rel)) {
+                    current = code;
+                }
+                if (current == code) {
+                    slot.count.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+            }
+            overflow.Add();
+        }
+
+        // visit(code, count)，表满后多出的错误码以"other"报告
+        template <typename Visitor>
+        void ForEach(Visitor visit) const {
+            for (const Slot& slot : slots) {
+                int64_t code = slot.code.load(std::memory_order_acquire);
+                if (code != kEmpty) visit(std::to_string(code), slot.count.load(std::memory_order_relaxed));
+            }
+            if (overflow.Value() > 0) visit(std::string("other"), overflow.Value());
+        }
+    };
+
+    // 以毫秒记录，按Prometheus惯例以秒导出；桶的上界在构造时固定
+    class Histogram {
+    private:
+        std::vector<double> boundsMs;
+        std::unique_ptr<std::atomic<uint64_t>[]> buckets;  // 非累计计数，最后一个为+Inf
+        std::atomic<uint64_t> count{ 0 };
+        std::atomic<uint64_t> sumUs{ 0 };
+
+    public:
+        explicit Histogram(std::initializer_list<double> upperBoundsMs)
+            : boundsMs(upperBoundsMs), buckets(new std::atomic<uint64_t>[upperBoundsMs.size() + 1]) {
+            for (size_t i = 0; i <= boundsMs.size(); i++) buckets[i].store(0, std::memory_order_relaxed);
+        }
+
+        void Observe(double ms) {
+            if (ms < 0) ms = 0;
+            size_t bucket = 0;
+            while (bucket < boundsMs.size() && ms > boundsMs[bucket]) bucket++;
+            buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+            sumUs.fetch_add(static_cast<uint64_t>(ms * 1000), std::memory_order_relaxed);
+            count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void ObserveSince(std::chrono::steady_clock::time_point start) {
+            Observe(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        void AppendText(std::string& out, const std::string& name) const {
+            char line[160];
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i <= boundsMs.size(); i++) {
+                cumulative += buckets[i].load(std::memory_order_relaxed);
+                if (i < boundsMs.size()) {
+                    snprintf(line, sizeof(line), "%s_bucket{le=\"%g\"} %llu\n", name.c_str(), boundsMs[i] / 1000,
+                        static_cast<unsigned long long>(cumulative));
+                }
+                else {
+                    snprintf(line, sizeof(line), "%s_bucket{le=\"+Inf\"} %llu\n", name.c_str(),
+                        static_cast<unsigned long long>(cumulative));
+                }
+                out += line;
+            }
+            snprintf(line, sizeof(line), "%s_sum %.6f\n%s_count %llu\n", name.c_str(),
+                static_cast<double>(sumUs.load(std::memory_order_relaxed)) / 1e6, name.c_str(),
+                static_cast<unsigned long long>(count.load(std::memory_order_relaxed)));
+            out += line;
+        }
+    };
+
+    // 关闭目标的方式：整棵进程树、按句柄、按进程名
+    enum KillMethod { kKillTree, kKillHandle, kKillName, kKillMethodCount };
+
+    Counter launchesStarted;          // 成功创建的进程（含重启）
+    Counter launchesFailed;           // 首次启动失败（文件不存在或创建进程失败）
+    Counter restarts;
+    CodeCounter spawnErrors;          // 创建进程失败的错误码（Windows为GetLastError，POSIX为errno）
+    Histogram spawnLatency{ 0.5, 1, 2, 5, 10, 25, 50, 100, 250, 500, 1000, 2500 };
+    Histogram readinessLatency{ 100, 250, 500, 1000, 2000, 5000, 10000, 20000, 30000, 60000, 120000 };
+    Counter readinessTimeouts;
+    Counter kills[kKillMethodCount];
+    Counter killFailures[kKillMethodCount];
+    Histogram configParse{ 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 25, 100 };
+
+private:
+    mutable std::mutex writeMutex;    // 守护模式的定时导出与批次结束导出共用同一个临时文件
+
+public:
+    static Metrics& Shared() {
+        static Metrics metrics;
+        return metrics;
+    }
+
+    std::string ToPrometheusText() const {
+        static const char* const kMethodNames[kKillMethodCount] = { "tree", "handle", "name" };
+        std::string out;
+        auto header = [&](const char* name, const char* type, const char* help) {
+            out += std::string("# HELP ") + name + " " + help + "\n# TYPE " + name + " " + type + "\n";
+        };
+        auto sample = [&](const std::string& name, uint64_t value) {
+            out += name + " " + std::to_string(value) + "\n";
+        };
+
+        header("dailyclean_launches_started_total", "counter", "Processes started, including restarts.");
+        sample("dailyclean_launches_started_total", launchesStarted.Value());
+        header("dailyclean_launches_failed_total", "counter", "Launches that failed (missing file or process creation error).");
+        sample("dailyclean_launches_failed_total", launchesFailed.Value());
+        header("dailyclean_spawn_errors_total", "counter", "Process creation failures by OS error code, including restarts.");
+        spawnErrors.ForEach([&](const std::string& code, uint64_t value) {
+            sample("dailyclean_spawn_errors_total{code=\"" + code + "\"}", value);
+        });
+        header("dailyclean_restarts_total", "counter", "Automatic restarts after a process exited.");
+        sample("dailyclean_restarts_total", restarts.Value());
+        header("dailyclean_spawn_duration_seconds", "histogram", "Time spent creating a process.");
+        spawnLatency.AppendText(out, "dailyclean_spawn_duration_seconds");
+        header("dailyclean_readiness_duration_seconds", "histogram", "Time from start until the readiness condition was met.");
+        readinessLatency.AppendText(out, "dailyclean_readiness_duration_seconds");
+        header("dailyclean_readiness_timeouts_total", "counter", "Readiness waits that timed out.");
+        sample("dailyclean_readiness_timeouts_total", readinessTimeouts.Value());
+        header("dailyclean_kills_total", "counter", "Scheduled closes by method.");
+        for (int method = 0; method < kKillMethodCount; method++) {
+            sample(std::string("dailyclean_kills_total{method=\"") + kMethodNames[method] + "\"}", kills[method].Value());
+        }
+        header("dailyclean_kill_failures_total", "counter", "Scheduled closes that failed or found no process, by method.");
+        for (int method = 0; method < kKillMethodCount; method++) {
+            sample(std::string("dailyclean_kill_failures_total{method=\"") + kMethodNames[method] + "\"}", killFailures[method].Value());
+        }
+        header("dailyclean_config_parse_duration_seconds", "histogram", "Time spent reading and parsing one config file.");
+        configParse.AppendText(out, "dailyclean_config_parse_duration_seconds");
+        header("dailyclean_metrics_timestamp_seconds", "gauge", "Unix time when this file was written.");
+        sample("dailyclean_metrics_timestamp_seconds", static_cast<uint64_t>(std::time(nullptr)));
+        return out;
+    }
+
+    // 先写临时文件再替换，textfile collector只会看到完整的文件（文件名须以.prom结尾）
+    bool WriteTextFile(const std::wstring& path) const {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        return Platform::WriteFileAtomic(path, ToPrometheusText());
+    }
+};
@@ -0,0 +1,283 @@
+#pragma once
+#include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <ctime>
+#include "Platform.h"
+#include "RotatingFile.h"
+#include "TraceRecorder.h"
+
+// 子进程输出捕获：所有条目的输出管道由同一个I/O线程读取（Windows为完成端口上的重叠读，POSIX为epoll），
+// 读到的数据只复制进共享的环形缓冲区，由另一个线程写入各条目按大小滚动的日志文件。
+// I/O线程从不等待磁盘，管道总能及时读空，输出再多的子进程也不会因管道写满而阻塞；
+// 缓冲区满时丢弃新到的数据，并在该条目的日志中记下丢弃的字节数。
+// 线程数与子进程数量无关：一个读线程加一个写线程，首次使用时才创建。
+class OutputCapture {
+public:
+    using SinkId = uint64_t;
+
+private:
+    static constexpr size_t kRingCapacity = 4 * 1024 * 1024;
+    static constexpr size_t kBatchBytes = 256 * 1024;     // 写线程每次从缓冲区取出的最大字节数
+
+    // 缓冲区中每段数据的头部；dropped非0时是丢弃标记（本段没有数据）
+    struct ChunkHeader {
+        SinkId sink;
+        uint64_t dropped;
+        uint32_t length;
+        uint32_t reserved;
+    };
+
+    struct Sink {
+        RotatingFile file;            // 仅写线程使用（打开发生在登记之前）
+        int pipes = 0;                // 尚未读到EOF的管道数
+        uint64_t dropped = 0;         // 尚未记入日志的丢弃字节数
+        bool released = false;        // 所有者不再使用，管道读完、数据写完后关闭
+    };
+
+    // 写线程取出的一段：同一日志的相邻数据合并为一段
+    struct Piece {
+        Sink* sink;
+        size_t offset;
+        size_t length;
+        uint64_t dropped;
+    };
+
+    Platform::OutputReader reader;
+    std::mutex mutex;                 // 保护下列成员
+    std::condition_variable wakeup;
+    std::unique_ptr<char[]> ring;
+    size_t head = 0;                  // 下一个读取位置
+    size_t tail = 0;                  // 下一个写入位置
+    size_t used = 0;
+    std::unordered_map<SinkId, std::unique_ptr<Sink>> sinks;   // 只由写线程删除
+    std::unordered_map<uint64_t, SinkId> pipes;                // 管道key -> 日志
+    SinkId nextSinkId = 1;
+    uint64_t nextPipeKey = 1;
+    bool cleanupPending = false;
+    bool stopping = false;
+    std::thread readerThread;
+    std::thread writerThread;
+
+    void PutLocked(const void* data, size_t length) {
+        const char* bytes = static_cast<const char*>(data);
+        size_t first = (std::min)(length, kRingCapacity - tail);
+        memcpy(ring.get() + tail, bytes, first);
+        memcpy(ring.get(), bytes + first, length - first);
+        tail = (tail + length) % kRingCapacity;
+        used += length;
+    }
+
+    void TakeLocked(void* data, size_t length) {
+        char* bytes = static_cast<char*>(data);
+        size_t first = (std::min)(length, kRingCapacity - head);
+        memcpy(bytes, ring.get() + head, first);
+        memcpy(bytes + first, ring.get(), length - first);
+        head = (head + length) % kRingCapacity;
+        used -= length;
+    }
+
+    // 放入一段数据；空间不足时整段丢弃并计数，下一次放入成功时先放入丢弃标记
+    void PushLocked(SinkId id, Sink& sink, const char* data, size_t length) {
+        size_t needed = sizeof(ChunkHeader) * (sink.dropped ? 2 : 1) + length;
+        if (used + needed > kRingCapacity) {
+            sink.dropped += length;
+            return;
+        }
+        bool wasEmpty = used == 0;
+        if (sink.dropped) {
+            ChunkHeader marker = { id, sink.dropped, 0, 0 };
+            PutLocked(&marker, sizeof(marker));
+            sink.dropped = 0;
+        }
+        ChunkHeader header = { id, 0, static_cast<uint32_t>(length), 0 };
+        PutLocked(&header, sizeof(header));
+        PutLocked(data, length);
+        if (wasEmpty) wakeup.notify_one();
+    }
+
+    // I/O线程：data为空表示该管道的写端已全部关闭
+    void OnPipeData(uint64_t key, const char* data, size_t length) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto pipe = pipes.find(key);
+        if (pipe == pipes.end()) return;
+        auto sink = sinks.find(pipe->second);
+        if (sink == sinks.end()) return;
+        if (data) {
+            PushLocked(sink->first, *sink->second, data, length);
+            return;
+        }
+        pipes.erase(pipe);
+        if (--sink->second->pipes == 0 && sink->second->released) {
+            cleanupPending = true;
+            wakeup.notify_one();
+        }
+    }
+
+    void ReaderLoop() {
+        TraceRecorder::Shared().SetThreadName("output_reader");
+        while (reader.Wait([this](uint64_t key, const char* data, size_t length) { OnPipeData(key, data, length); })) {}
+    }
+
+    // 缓冲区为空时关闭已释放且管道都已读完的日志
+    void CollectLocked() {
+        cleanupPending = false;
+        for (auto it = sinks.begin(); it != sinks.end();) {
+            if (it->second->released && it->second->pipes == 0) it = sinks.erase(it);
+            else ++it;
+        }
+    }
+
+    void WriterLoop() {
+        TraceRecorder::Shared().SetThreadName("output_writer");
+        std::vector<char> batch;
+        std::vector<Piece> pieces;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wakeup.wait(lock, [this]() { return used > 0 || cleanupPending || stopping; });
+            if (used == 0) {
+                CollectLocked();
+                if (stopping) return;
+                continue;
+            }
+
+            batch.clear();
+            pieces.clear();
+            while (used > 0 && batch.size() < kBatchBytes) {
+                ChunkHeader header;
+                TakeLocked(&header, sizeof(header));
+                auto found = sinks.find(header.sink);   // 缓冲区非空时不会删除日志
+                Sink* sink = found != sinks.end() ? found->second.get() : nullptr;
+                if (header.dropped) {
+                    pieces.push_back({ sink, 0, 0, header.dropped });
+                    continue;
+                }
+                size_t offset = batch.size();
+                batch.resize(offset + header.length);
+                TakeLocked(batch.data() + offset, header.length);
+                if (!pieces.empty() && pieces.back().sink == sink && !pieces.back().dropped) {
+                    pieces.back().length += header.length;
+                }
+                else {
+                    pieces.push_back({ sink, offset, header.length, 0 });
+                }
+            }
+            lock.unlock();
+
+            for (const Piece& piece : pieces) {
+                if (!piece.sink) continue;
+                if (piece.dropped) {
+                    piece.sink->file.Write("\n[output capture: " + std::to_string(piece.dropped) + " bytes dropped]\n");
+                }
+                else {
+                    piece.sink->file.Write(batch.data() + piece.offset, piece.length);
+                }
+            }
+
+            lock.lock();
+            if (used == 0 && cleanupPending) CollectLocked();
+        }
+    }
+
+    static std::string Timestamp() {
+        time_t now = time(nullptr);
+        struct tm local;
+#ifdef _WIN32
+        localtime_s(&local, &now);
+#else
+        localtime_r(&now, &local);
+#endif
+        char buffer[32];
+        strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+        return buffer;
+    }
+
+public:
+    OutputCapture() : ring(new char[kRingCapacity]) {
+        readerThread = std::thread([this]() { ReaderLoop(); });
+        writerThread = std::thread([this]() { WriterLoop(); });
+    }
+
+    OutputCapture(const OutputCapture&) = delete;
+    OutputCapture& operator=(const OutputCapture&) = delete;
+
+    // 先停止读取，再把缓冲区中剩余的数据写完
+    ~OutputCapture() {
+        reader.Stop();
+        if (readerThread.joinable()) readerThread.join();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            wakeup.notify_one();
+        }
+        if (writerThread.joinable()) writerThread.join();
+    }
+
+    static OutputCapture& Shared() {
+        static OutputCapture capture;
+        return capture;
+    }
+
+    // 条目输出日志的位置：<配置目录>/logs/<name>.log
+    static std::wstring LogPathIn(const std::wstring& folder, const std::wstring& name) {
+        return Platform::JoinPath(Platform::JoinPath(folder, L"logs"), name + L".log");
+    }
+
+    // 打开（追加）日志文件，单个文件超过maxKB后滚动，最多保留files个；失败返回0
+    SinkId Open(const std::wstring& path, int maxKB, int files) {
+        auto sink = std::unique_ptr<Sink>(new Sink());
+        std::wstring folder = Platform::DirectoryOf(path);
+        if (!folder.empty() && !Platform::DirectoryExists(folder)) Platform::MakeDirectory(folder);
+        if (!sink->file.Open(path, static_cast<uint64_t>((std::max)(maxKB, 1)) * 1024, files)) return 0;
+        std::lock_guard<std::mutex> lock(mutex);
+        SinkId id = nextSinkId++;
+        sinks[id] = std::move(sink);
+        return id;
+    }
+
+    // 把子进程输出管道的读端交给I/O线程（总是接管读端）
+    bool Attach(SinkId id, Platform::NativeHandle readEnd) {
+        uint64_t key;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto sink = sinks.find(id);
+            if (sink == sinks.end() || sink->second->released) {
+                Platform::CloseOutputPipe(readEnd);
+                return false;
+            }
+            key = nextPipeKey++;
+            pipes[key] = id;
+            sink->second->pipes++;
+        }
+        if (reader.Add(readEnd, key)) return true;
+        OnPipeData(key, nullptr, 0);
+        return false;
+    }
+
+    // 写入一行带日期时间的说明（例如每次启动的分隔行），与管道数据按到达顺序排列
+    void Note(SinkId id, const std::string& text) {
+        std::string line = "=== " + Timestamp() + " " + text + " ===\n";
+        std::lock_guard<std::mutex> lock(mutex);
+        auto sink = sinks.find(id);
+        if (sink != sinks.end()) PushLocked(id, *sink->second, line.data(), line.size());
+    }
+
+    // 所有者不再使用；之后的管道数据照常写入，全部管道读完后关闭文件
+    void Release(SinkId id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto sink = sinks.find(id);
+        if (sink == sinks.end()) return;
+        sink->second->released = true;
+        if (sink->second->pipes == 0) {
+            cleanupPending = true;
+            wakeup.notify_one();
+        }
+    }
+};
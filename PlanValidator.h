@@ -0,0 +1,181 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <cwctype>
+#include "Platform.h"
+#include "ProgramConfig.h"
+#include "GameController.h"
+#include "TraceRecorder.h"
+
+// 启动前预检：第一次启动之前检查计划中的所有条目，一次报告全部问题，
+// 不必等到启动某个条目时才发现程序文件不存在。
+// 文件系统检查按路径去重后并发执行，同一路径（包括多个条目共用的工作目录）在一次运行内只检查一次。
+class PlanValidator {
+public:
+    static constexpr size_t kMaxArguments = 5;        // 与启动时传递的参数上限一致
+
+    enum class Severity { Warning, Error };
+
+    struct Issue {
+        size_t index;                 // 条目在programs中的下标
+        Severity severity;
+        std::wstring message;
+    };
+
+private:
+    struct PathState {
+        bool file = false;
+        bool executable = false;
+        bool directory = false;
+    };
+
+    // 一次运行内的检查结果缓存（路径 → 状态）
+    std::unordered_map<std::wstring, PathState> cache;
+
+    static std::wstring ExtensionOf(const std::wstring& path) {
+        std::wstring name = Platform::FileNameOf(path);
+        size_t dot = name.find_last_of(L'.');
+        if (dot == std::wstring::npos || dot == 0) return L"";
+        std::wstring extension = name.substr(dot);
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+            [](wchar_t c) { return static_cast<wchar_t>(std::towlower(c)); });
+        return extension;
+    }
+
+    static bool IsScriptExtension(const std::wstring& extension) {
+        return extension == L".bat" || extension == L".cmd" || extension == L".sh";
+    }
+
+    // 并发检查尚未缓存的路径
+    void CheckPaths(const std::vector<std::wstring>& paths, unsigned maxThreads) {
+        std::vector<std::wstring> pending;
+        for (const auto& path : paths) {
+            if (!path.empty() && cache.emplace(path, PathState()).second) pending.push_back(path);
+        }
+        if (pending.empty()) return;
+
+        std::vector<PathState> states(pending.size());
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            size_t index;
+            while ((index = next.fetch_add(1)) < pending.size()) {
+                PathState& state = states[index];
+                state.directory = Platform::DirectoryExists(pending[index]);
+                state.file = !state.directory && Platform::FileExists(pending[index]);
+                state.executable = state.file && Platform::IsExecutableFile(pending[index]);
+            }
+        };
+
+        if (maxThreads == 0) maxThreads = (std::max)(1u, (std::min)(8u, std::thread::hardware_concurrency()));
+        size_t threadCount = (std::min)(static_cast<size_t>(maxThreads), pending.size());
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < threadCount; i++) {
+            threads.emplace_back([&]() {
+                TraceRecorder::Shared().SetThreadName("preflight");
+                worker();
+            });
+        }
+        worker();
+        for (auto& thread : threads) thread.join();
+
+        for (size_t i = 0; i < pending.size(); i++) cache[pending[i]] = states[i];
+    }
+
+    void CheckEntry(size_t index, const ProgramConfig& config, std::vector<Issue>& issues) const {
+        auto error = [&](const std::wstring& message) { issues.push_back({ index, Severity::Error, message }); };
+        auto warning = [&](const std::wstring& message) { issues.push_back({ index, Severity::Warning, message }); };
+
+        if (config.type == ProgramType::ExeWithArgument && config.arguments.size() > kMaxArguments) {
+            error(L"参数有 " + std::to_wstring(config.arguments.size()) + L" 个，超过上限 " +
+                std::to_wstring(kMaxArguments) + L" 个，多出的不会传递");
+        }
+        else if (config.type != ProgramType::ExeWithArgument && !config.arguments.empty()) {
+            warning(L"type为" + ProgramTypeToString(config.type) + L"，配置的参数不会传递（需要ExeWithArgument）");
+        }
+
+        if (config.path.empty()) {
+            error(L"未配置程序路径");
+            return;
+        }
+
+        std::wstring extension = ExtensionOf(config.path);
+        bool typeMismatch = false;
+        if (config.type == ProgramType::Bat && !extension.empty() && !IsScriptExtension(extension)) {
+            error(L"type为Bat，但扩展名 " + extension + L" 不是脚本");
+            typeMismatch = true;
+        }
+        else if (config.type != ProgramType::Bat && IsScriptExtension(extension)) {
+            error(L"扩展名 " + extension + L" 是脚本，type应为Bat");
+            typeMismatch = true;
+        }
+
+        std::wstring workingDirectory = GameController::GetWorkingDirectory(config);
+        if (!workingDirectory.empty()) {
+            auto directory = cache.find(workingDirectory);
+            if (directory != cache.end() && !directory->second.directory) {
+                error(L"工作目录不存在: " + workingDirectory);
+                return;
+            }
+        }
+
+        const PathState& state = cache.at(config.path);
+        if (state.directory) {
+            error(L"程序路径是目录: " + config.path);
+        }
+        else if (!state.file) {
+            error(L"程序文件不存在: " + config.path);
+        }
+        else if (config.type != ProgramType::Bat && !typeMismatch && !state.executable) {
+            error(L"程序文件不可执行: " + config.path);
+        }
+    }
+
+public:
+    // programs为待启动的条目（已启用）；返回的问题按条目顺序排列，order重复的问题在最后
+    std::vector<Issue> Validate(const std::vector<ProgramConfig>& programs, unsigned maxThreads = 0) {
+        TraceSpan span("preflight", "plan");
+        std::vector<std::wstring> paths;
+        paths.reserve(programs.size() * 2);
+        for (const auto& config : programs) {
+            paths.push_back(config.path);
+            paths.push_back(GameController::GetWorkingDirectory(config));
+        }
+        CheckPaths(paths, maxThreads);
+
+        std::vector<Issue> issues;
+        for (size_t i = 0; i < programs.size(); i++) {
+            CheckEntry(i, programs[i], issues);
+        }
+
+        std::unordered_map<int, size_t> firstByOrder;
+        for (size_t i = 0; i < programs.size(); i++) {
+            auto inserted = firstByOrder.emplace(programs[i].order, i);
+            if (!inserted.second) {
+                issues.push_back({ i, Severity::Error, L"order " + std::to_wstring(programs[i].order) + L" 与 " +
+                    programs[inserted.first->second].name + L" 重复" });
+            }
+        }
+        return issues;
+    }
+
+    static bool HasErrors(const std::vector<Issue>& issues) {
+        return std::any_of(issues.begin(), issues.end(), [](const Issue& issue) { return issue.severity == Severity::Error; });
+    }
+
+    // 所有问题合成一条多行信息
+    static std::wstring Report(const std::vector<ProgramConfig>& programs, const std::vector<Issue>& issues) {
+        size_t errors = 0;
+        std::wstring lines;
+        for (const Issue& issue : issues) {
+            if (issue.severity == Severity::Error) errors++;
+            lines += std::wstring(issue.severity == Severity::Error ? L"\n  ✗ " : L"\n  ⚠ ") +
+                programs[issue.index].name + L": " + issue.message;
+        }
+        return L"启动前预检: " + std::to_wstring(errors) + L" 个错误, " + std::to_wstring(issues.size() - errors) +
+            L" 个警告" + lines;
+    }
+};
@@ -0,0 +1,138 @@
+#pragma once
+#ifdef _WIN32
+#include <winsock2.h>
+#include <windows.h>
+#endif
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// 操作系统抽象层：进程启动/等待/关闭/枚举、目录与文件、控制台以及就绪通知
+// Windows后端直接使用Win32 API；POSIX后端使用posix_spawn、/proc以及pidfd_open+epoll，
+// 使调度、解析和整个启动器都能在Linux上构建和运行。
+namespace Platform {
+
+    using ProcessId = uint32_t;
+
+#ifdef _WIN32
+    using NativeHandle = HANDLE;
+    inline const NativeHandle kInvalidHandle = NULL;
+    constexpr wchar_t kPathSeparator = L'\\';
+    constexpr const wchar_t* kExecutableSuffix = L".exe";
+    constexpr bool kHasWindows = true;            // 可查询进程的主窗口（HasVisibleWindow）
+#else
+    using NativeHandle = int;
+    constexpr NativeHandle kInvalidHandle = -1;
+    constexpr wchar_t kPathSeparator = L'/';
+    constexpr const wchar_t* kExecutableSuffix = L"";
+    constexpr bool kHasWindows = false;
+#endif
+
+    // 已启动的子进程：Windows为进程句柄，Linux为pidfd（内核不支持时仅有pid）
+    struct ProcessHandle {
+        ProcessId pid = 0;
+        NativeHandle handle = kInvalidHandle;
+
+        bool IsValid() const {
+            return pid != 0;
+        }
+    };
+
+    class ProcessGroup;
+
+    // 进程组容器的资源上限（0表示不限制）
+    struct ProcessGroupLimits {
+        uint64_t memoryBytes = 0;         // 整个进程树的内存上限
+        int cpuPercent = 0;               // 占整机CPU的百分比上限
+    };
+
+    // 调度设置：优先级档位1~5依次为idle、below-normal、normal、above-normal、high，0表示继承
+    struct SchedulingOptions {
+        int priorityClass = 0;            // CPU优先级
+        int ioPriority = 0;
+        int memoryPriority = 0;           // Linux没有内存优先级，映射为oom_score_adj
+        std::vector<int> cpus;            // 允许运行的CPU，空表示不限制
+
+        bool IsEmpty() const {
+            return priorityClass == 0 && ioPriority == 0 && memoryPriority == 0 && cpus.empty();
+        }
+    };
+
+    constexpr int kPriorityNormal = 3;
+
+    // 启动器/控制器自身是否已降为后台优先级（EnterBackgroundMode）
+    inline bool backgroundMode = false;
+
+    // 后台模式下，未显式设置的优先级按normal启动，子进程不继承后台优先级
+    inline SchedulingOptions EffectiveScheduling(const SchedulingOptions& options) {
+        SchedulingOptions effective = options;
+        if (backgroundMode) {
+            if (effective.priorityClass == 0) effective.priorityClass = kPriorityNormal;
+            if (effective.ioPriority == 0) effective.ioPriority = kPriorityNormal;
+            if (effective.memoryPriority == 0) effective.memoryPriority = kPriorityNormal;
+        }
+        return effective;
+    }
+
+    struct SpawnRequest {
+        std::wstring path;
+        std::vector<std::wstring> arguments;
+        std::wstring workingDirectory;    // 为空时继承当前目录
+        bool script = false;              // 通过系统shell执行（Windows为cmd.exe /c，POSIX为/bin/sh）
+        bool newConsole = false;          // 仅Windows：在新控制台窗口中启动
+        ProcessGroup* group = nullptr;    // 非空时进程（及其所有后代）在开始运行前放入该容器
+        SchedulingOptions scheduling;     // 在进程执行第一条指令之前应用
+        NativeHandle* outputPipe = nullptr;   // 非空时stdout和stderr合并写入新建的管道，读端（非阻塞）返回到这里
+    };
+
+    enum class WaitResult { Exited, TimedOut, Failed };
+
+    struct ProcessInfo {
+        ProcessId pid = 0;
+        ProcessId parentPid = 0;
+        std::wstring name;                // 可执行文件名，例如 game.exe
+        std::wstring path;                // 可执行文件完整路径（仅ListProcesses(true)，无权限读取时为空）
+    };
+
+    struct DirectoryEntry {
+        std::wstring name;
+        uint64_t size = 0;
+        uint64_t lastWriteTime = 0;       // 平台相关的时间戳，仅用于比较是否变化
+        bool isDirectory = false;
+    };
+
+    // 系统负载计数：CPU时间为开机以来的累计值，需两次读取求差
+    struct SystemLoadCounters {
+        uint64_t idleTime = 0;
+        uint64_t totalTime = 0;
+        int64_t availableMemoryMB = -1;   // 无法读取时为-1
+        int64_t diskQueueLength = -1;     // 各物理磁盘正在进行的I/O数之和，无法读取时为-1
+    };
+
+    inline bool IsPathSeparator(wchar_t c) {
+        return c == L'\\' || c == L'/';
+    }
+
+    inline std::wstring JoinPath(const std::wstring& directory, const std::wstring& name) {
+        if (directory.empty()) return name;
+        if (IsPathSeparator(directory.back())) return directory + name;
+        return directory + kPathSeparator + name;
+    }
+
+    // 文件名部分（不含目录），两种分隔符均可识别
+    inline std::wstring FileNameOf(const std::wstring& path) {
+        size_t lastSlash = path.find_last_of(L"\\/");
+        return lastSlash != std::wstring::npos ? path.substr(lastSlash + 1) : path;
+    }
+
+    inline std::wstring DirectoryOf(const std::wstring& path) {
+        size_t lastSlash = path.find_last_of(L"\\/");
+        return lastSlash != std::wstring::npos ? path.substr(0, lastSlash) : L"";
+    }
+}
+
+#ifdef _WIN32
+#include "PlatformWin32.h"
+#else
+#include "PlatformPosix.h"
+#endif
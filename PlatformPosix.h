@@ -0,0 +1,1219 @@
+#pragma once
+#include <spawn.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include <cwctype>
+#include "Platform.h"
+#include "TextEncoding.h"
+
+extern char** environ;
+
+// Platform.h 的POSIX后端（在Linux上测试）
+// 子进程通过posix_spawn启动，pidfd_open取得可等待的描述符，退出等待使用epoll；
+// 进程枚举读取/proc。内核不支持pidfd时退回到waitpid轮询。
+namespace Platform {
+
+    inline std::string ToNative(const std::wstring& path) {
+        return TextEncoding::WideToUtf8(path);
+    }
+
+    inline uint64_t StatTime(const struct stat& st) {
+        return static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000ull + static_cast<uint64_t>(st.st_mtim.tv_nsec);
+    }
+
+    inline int LastError() {
+        return errno;
+    }
+
+    inline ProcessId CurrentProcessId() {
+        return static_cast<ProcessId>(getpid());
+    }
+
+    // 进程管理
+    inline std::wstring CommandLineOf(const SpawnRequest& request) {
+        std::wstring commandLine = request.script ? L"/bin/sh \"" + request.path + L"\"" : request.path;
+        for (const auto& argument : request.arguments) {
+            commandLine += L" ";
+            commandLine += argument.find(L' ') != std::wstring::npos ? L"\"" + argument + L"\"" : argument;
+        }
+        return commandLine;
+    }
+
+    inline bool ReadSmallFile(const std::string& path, std::string& content) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        char buffer[4096];
+        ssize_t length;
+        content.clear();
+        while ((length = read(fd, buffer, sizeof(buffer))) > 0) content.append(buffer, static_cast<size_t>(length));
+        close(fd);
+        return true;
+    }
+
+    // 写入/proc、/sys下的控制文件（一次write，失败时返回false）
+    inline bool WriteSmallFile(const std::string& path, const std::string& content) {
+        int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        bool written = write(fd, content.data(), content.size()) == static_cast<ssize_t>(content.size());
+        close(fd);
+        return written;
+    }
+
+    inline int OpenPidfd(pid_t pid) {
+#ifdef SYS_pidfd_open
+        return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#else
+        (void)pid;
+        return -1;
+#endif
+    }
+
+    // 进程树容器：每个启动条目一个，定时关闭时一次调用结束整棵进程树，无需枚举进程快照
+    // 每次启动的进程都是新进程组的组长；cgroup v2可写时还会把进程移入独立的cgroup，
+    // 这样调用setsid脱离进程组的后代也能被关闭，并可设置内存和CPU上限
+    class ProcessGroup {
+    private:
+        std::mutex mutex;
+        std::string cgroupPath;                   // 为空表示未使用cgroup
+        // 启动过的进程组；组长退出并被回收、组内也没有进程后，组号可能被无关的进程组重新使用，
+        // 因此通过pidfd确认组长仍未被回收，组长已回收时只处理与本进程同一会话的组
+        struct Group {
+            pid_t pgid;
+            int leaderFd;                         // 组长的pidfd，-1表示内核不支持
+        };
+        std::vector<Group> processGroups;
+
+        // 组长尚未被回收（包括僵尸状态）时组号不会被重新使用
+        static bool LeaderHeld(const Group& group) {
+#ifdef SYS_pidfd_send_signal
+            if (group.leaderFd >= 0) return syscall(SYS_pidfd_send_signal, group.leaderFd, 0, nullptr, 0) == 0;
+#endif
+            return false;
+        }
+
+        // 组长已回收时，组内是否还有与本进程同一会话的进程（组号被其他会话重新使用时为false）
+        static bool GroupInOurSession(pid_t pgid) {
+            pid_t session = getsid(0);
+            DIR* dir = opendir("/proc");
+            if (!dir) return false;
+            bool found = false;
+            while (struct dirent* entry = readdir(dir)) {
+                if (entry->d_name[0] < '1' || entry->d_name[0] > '9') continue;
+                std::string stat;
+                if (!ReadSmallFile(std::string("/proc/") + entry->d_name + "/stat", stat)) continue;
+                size_t paren = stat.rfind(')');
+                if (paren == std::string::npos) continue;
+                char state;
+                int parent, group, sid;
+                if (sscanf(stat.c_str() + paren + 1, " %c %d %d %d", &state, &parent, &group, &sid) != 4) continue;
+                if (group != pgid || state == 'Z') continue;   // 只剩僵尸进程的组视为已结束
+                if (sid != session) {
+                    found = false;
+                    break;
+                }
+                found = true;
+            }
+            closedir(dir);
+            return found;
+        }
+
+        // 组是否仍属于本容器；组长已回收且组内没有本会话的进程时从列表中移除
+        bool OwnedLocked(size_t index) {
+            const Group& group = processGroups[index];
+            if (LeaderHeld(group) || (kill(-group.pgid, 0) == 0 && GroupInOurSession(group.pgid))) return true;
+            if (group.leaderFd >= 0) close(group.leaderFd);
+            processGroups.erase(processGroups.begin() + index);
+            return false;
+        }
+
+        // 本进程所在的cgroup v2目录（挂载点 + /proc/self/cgroup中的"0::"路径）
+        static std::string CurrentCgroup() {
+            std::string mounts, cgroups;
+            if (!ReadSmallFile("/proc/self/mounts", mounts) || !ReadSmallFile("/proc/self/cgroup", cgroups)) return "";
+            std::string mountPoint;
+            size_t lineStart = 0;
+            while (lineStart < mounts.size() && mountPoint.empty()) {
+                size_t lineEnd = mounts.find('\n', lineStart);
+                if (lineEnd == std::string::npos) lineEnd = mounts.size();
+                char device[256], path[1024], type[64];
+                if (sscanf(mounts.substr(lineStart, lineEnd - lineStart).c_str(), "%255s %1023s %63s", device, path, type) == 3 &&
+                    strcmp(type, "cgroup2") == 0) {
+                    mountPoint = path;
+                }
+                lineStart = lineEnd + 1;
+            }
+            size_t position = cgroups.find("0::");
+            if (mountPoint.empty() || position == std::string::npos) return "";
+            size_t end = cgroups.find('\n', position);
+            std::string relative = cgroups.substr(position + 3, end == std::string::npos ? std::string::npos : end - position - 3);
+            return relative == "/" ? mountPoint : mountPoint + relative;
+        }
+
+        bool KillCgroup() {
+            if (cgroupPath.empty()) return false;
+            if (WriteSmallFile(cgroupPath + "/cgroup.kill", "1")) return true;
+            // cgroup.kill需要5.14以上内核，否则逐个发送信号（重复一次以覆盖期间新建的进程）
+            bool killed = false;
+            for (int round = 0; round < 2; round++) {
+                std::string procs;
+                if (!ReadSmallFile(cgroupPath + "/cgroup.procs", procs)) break;
+                for (const char* cursor = procs.c_str(); *cursor;) {
+                    char* end;
+                    long pid = std::strtol(cursor, &end, 10);
+                    if (end == cursor) break;
+                    if (pid > 0 && kill(static_cast<pid_t>(pid), SIGKILL) == 0) killed = true;
+                    cursor = *end ? end + 1 : end;
+                }
+            }
+            return killed;
+        }
+
+    public:
+        ProcessGroup() = default;
+        ProcessGroup(const ProcessGroup&) = delete;
+        ProcessGroup& operator=(const ProcessGroup&) = delete;
+
+        // 仍有进程时cgroup目录无法删除，保留给系统在进程全部退出后清理
+        ~ProcessGroup() {
+            for (const Group& group : processGroups) {
+                if (group.leaderFd >= 0) close(group.leaderFd);
+            }
+            if (!cgroupPath.empty()) rmdir(cgroupPath.c_str());
+        }
+
+        // name只用于cgroup目录名，非ASCII字符替换为下划线
+        void Create(const std::wstring& name) {
+            static std::atomic<unsigned> counter{ 0 };
+            std::string parent = CurrentCgroup();
+            if (parent.empty() || access(parent.c_str(), W_OK) != 0) return;
+            std::string directory = "launcher.";
+            for (wchar_t c : name) directory += (c < 128 && (iswalnum(c) || c == L'-' || c == L'_')) ? static_cast<char>(c) : '_';
+            directory += "." + std::to_string(getpid()) + "." + std::to_string(counter++);
+            std::string path = parent + "/" + directory;
+            if (mkdir(path.c_str(), 0755) == 0) cgroupPath = path;
+        }
+
+        // 需要cgroup且父cgroup已启用memory/cpu控制器（委派给当前用户的cgroup通常满足）
+        bool SetLimits(const ProcessGroupLimits& limits) {
+            if (limits.memoryBytes == 0 && limits.cpuPercent <= 0) return true;
+            if (cgroupPath.empty()) return false;
+            std::string parent = cgroupPath.substr(0, cgroupPath.rfind('/'));
+            bool ok = true;
+            if (limits.memoryBytes > 0) {
+                WriteSmallFile(parent + "/cgroup.subtree_control", "+memory");
+                ok = WriteSmallFile(cgroupPath + "/memory.max", std::to_string(limits.memoryBytes)) && ok;
+            }
+            if (limits.cpuPercent > 0) {
+                WriteSmallFile(parent + "/cgroup.subtree_control", "+cpu");
+                const long long period = 100000;
+                long long quota = period * limits.cpuPercent * (std::max)(1u, std::thread::hardware_concurrency()) / 100;
+                ok = WriteSmallFile(cgroupPath + "/cpu.max", std::to_string(quota) + " " + std::to_string(period)) && ok;
+            }
+            return ok;
+        }
+
+        bool UsesCgroup() const {
+            return !cgroupPath.empty();
+        }
+
+        std::string CgroupProcsPath() const {
+            return cgroupPath + "/cgroup.procs";
+        }
+
+        // 由Spawn调用：进程已是新进程组的组长并已在cgroup中（重复写入cgroup.procs无副作用）
+        void Add(pid_t pid) {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = processGroups.size(); i-- > 0;) OwnedLocked(i);
+            processGroups.push_back({ pid, OpenPidfd(pid) });
+            if (!cgroupPath.empty()) WriteSmallFile(cgroupPath + "/cgroup.procs", std::to_string(pid));
+        }
+
+        // 容器中是否已没有进程（启动的进程及其后代都已退出）
+        bool IsEmpty() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!cgroupPath.empty()) {
+                std::string procs;
+                return ReadSmallFile(cgroupPath + "/cgroup.procs", procs) && procs.find_first_not_of(" \n") == std::string::npos;
+            }
+            bool empty = true;
+            for (size_t i = processGroups.size(); i-- > 0;) {
+                if (OwnedLocked(i) && kill(-processGroups[i].pgid, 0) == 0) empty = false;
+            }
+            return empty;
+        }
+
+        // 结束容器中的所有进程
+        bool Terminate() {
+            std::lock_guard<std::mutex> lock(mutex);
+            bool killed = KillCgroup();
+            for (size_t i = processGroups.size(); i-- > 0;) {
+                if (OwnedLocked(i) && kill(-processGroups[i].pgid, SIGKILL) == 0) killed = true;
+            }
+            return killed;
+        }
+    };
+
+    // fork之后、exec之前要做的设置（全部在fork之前准备好，子进程中只调用异步信号安全的函数）
+    struct ChildSetup {
+        std::string procsPath;            // 非空时先加入该cgroup
+        bool newProcessGroup = false;
+        bool setNice = false;
+        int nice = 0;
+        bool setAffinity = false;
+        cpu_set_t affinity;
+        int ioPriority = -1;              // ioprio_set的值，-1表示不设置
+        std::string oomScoreAdj;          // 非空时写入/proc/self/oom_score_adj
+        int outputFd = -1;                // 非负时复制为stdout和stderr，并忽略SIGPIPE
+    };
+
+    // 优先级档位1~5对应的nice、I/O优先级（idle类或best-effort类的级别）和oom_score_adj
+    inline ChildSetup PrepareChildSetup(const SchedulingOptions& options) {
+        static const int kNice[] = { 19, 10, 0, -5, -10 };
+        static const int kBestEffortLevel[] = { 7, 4, 2, 0 };
+        static const char* const kOomScoreAdj[] = { "800", "400", "0", "-200", "-500" };
+        const int kClassBestEffort = 2, kClassIdle = 3, kClassShift = 13;
+
+        ChildSetup setup;
+        CPU_ZERO(&setup.affinity);
+        if (options.priorityClass >= 1 && options.priorityClass <= 5) {
+            setup.setNice = true;
+            setup.nice = kNice[options.priorityClass - 1];
+        }
+        for (int cpu : options.cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &setup.affinity);
+                setup.setAffinity = true;
+            }
+        }
+        if (options.ioPriority == 1) {
+            setup.ioPriority = kClassIdle << kClassShift;
+        }
+        else if (options.ioPriority >= 2 && options.ioPriority <= 5) {
+            setup.ioPriority = (kClassBestEffort << kClassShift) | kBestEffortLevel[options.ioPriority - 2];
+        }
+        if (options.memoryPriority >= 1 && options.memoryPriority <= 5) {
+            setup.oomScoreAdj = kOomScoreAdj[options.memoryPriority - 1];
+        }
+        return setup;
+    }
+
+    // 在当前进程（子进程中）应用调度设置；权限不足（例如提高优先级）时保持继承的值
+    inline void ApplyChildSetup(const ChildSetup& setup) {
+        if (setup.setNice) setpriority(PRIO_PROCESS, 0, setup.nice);
+        if (setup.setAffinity) sched_setaffinity(0, sizeof(setup.affinity), &setup.affinity);
+#ifdef SYS_ioprio_set
+        if (setup.ioPriority >= 0) syscall(SYS_ioprio_set, 1 /* IOPRIO_WHO_PROCESS */, 0, setup.ioPriority);
+#endif
+        if (!setup.oomScoreAdj.empty()) {
+            int fd = open("/proc/self/oom_score_adj", O_WRONLY | O_CLOEXEC);
+            if (fd >= 0) {
+                if (write(fd, setup.oomScoreAdj.data(), setup.oomScoreAdj.size()) < 0) {}
+                close(fd);
+            }
+        }
+    }
+
+    // 进入cgroup和调度设置都必须发生在exec之前，否则程序启动后立即派生的进程会留在原cgroup中、
+    // 第一条指令已按继承的优先级运行，posix_spawn做不到这一点（也无法让子进程忽略SIGPIPE）：
+    // fork后子进程依次加入cgroup、成为新进程组的组长、重定向输出、应用调度设置、切换目录再exec，
+    // exec失败的errno经close-on-exec管道传回
+    inline pid_t SpawnWithSetup(const std::vector<char*>& argv, bool search, const std::string& directory,
+        const ChildSetup& setup) {
+        int errorPipe[2];
+        if (pipe2(errorPipe, O_CLOEXEC) != 0) return -1;
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(errorPipe[0]);
+            if (!setup.procsPath.empty()) {
+                int fd = open(setup.procsPath.c_str(), O_WRONLY | O_CLOEXEC);
+                if (fd >= 0) {
+                    if (write(fd, "0", 1) < 0) {}
+                    close(fd);
+                }
+            }
+            if (setup.newProcessGroup) setpgid(0, 0);
+            if (setup.outputFd >= 0) {
+                // 捕获方（启动器）先退出后，写输出只会失败而不会终止程序（与Windows一致）
+                signal(SIGPIPE, SIG_IGN);
+                dup2(setup.outputFd, STDOUT_FILENO);
+                dup2(setup.outputFd, STDERR_FILENO);
+            }
+            ApplyChildSetup(setup);
+            if (directory.empty() || chdir(directory.c_str()) == 0) {
+                if (search) execvp(argv[0], argv.data());
+                else execv(argv[0], argv.data());
+            }
+            int error = errno;
+            if (write(errorPipe[1], &error, sizeof(error)) < 0) {}
+            _exit(127);
+        }
+
+        close(errorPipe[1]);
+        if (pid < 0) {
+            close(errorPipe[0]);
+            return -1;
+        }
+        int childError = 0;
+        ssize_t length;
+        do {
+            length = read(errorPipe[0], &childError, sizeof(childError));
+        } while (length < 0 && errno == EINTR);
+        close(errorPipe[0]);
+        if (length > 0) {
+            waitpid(pid, nullptr, 0);
+            errno = childError;
+            return -1;
+        }
+        return pid;
+    }
+
+    // 子进程输出管道：两端都是close-on-exec（只有dup2到stdout/stderr的副本被子进程继承，
+    // 同时启动的其他子进程不会持有写端），读端非阻塞
+    inline bool OpenOutputPipe(int fds[2]) {
+        if (pipe2(fds, O_CLOEXEC) != 0) return false;
+        fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+        return true;
+    }
+
+    inline void CloseOutputPipe(NativeHandle readEnd) {
+        if (readEnd >= 0) close(readEnd);
+    }
+
+    inline bool Spawn(const SpawnRequest& request, ProcessHandle& process) {
+        // 工作目录切换发生在exec之前，相对路径需先按当前目录展开（与CreateProcessW一致）
+        std::string path = ToNative(request.path);
+        if (!path.empty() && path[0] != '/' && path.find('/') != std::string::npos) {
+            char cwd[4096];
+            if (getcwd(cwd, sizeof(cwd))) path = std::string(cwd) + "/" + path;
+        }
+
+        std::vector<std::string> args;
+        if (request.script) args.push_back("/bin/sh");
+        args.push_back(path);
+        for (const auto& argument : request.arguments) args.push_back(ToNative(argument));
+
+        std::vector<char*> argv;
+        for (auto& argument : args) argv.push_back(&argument[0]);
+        argv.push_back(nullptr);
+        bool search = path.find('/') == std::string::npos || request.script;
+
+        SchedulingOptions scheduling = EffectiveScheduling(request.scheduling);
+        if ((request.group && request.group->UsesCgroup()) || !scheduling.IsEmpty() || request.outputPipe) {
+            ChildSetup setup = PrepareChildSetup(scheduling);
+            if (request.group) {
+                setup.newProcessGroup = true;
+                if (request.group->UsesCgroup()) setup.procsPath = request.group->CgroupProcsPath();
+            }
+            int output[2] = { -1, -1 };
+            if (request.outputPipe && !OpenOutputPipe(output)) return false;
+            setup.outputFd = output[1];
+            pid_t pid = SpawnWithSetup(argv, search, ToNative(request.workingDirectory), setup);
+            if (request.outputPipe) {
+                // 父进程不保留写端，子进程（及其后代）全部退出后读端收到EOF
+                int error = errno;
+                close(output[1]);
+                if (pid >= 0) *request.outputPipe = output[0];
+                else close(output[0]);
+                errno = error;
+            }
+            if (pid < 0) return false;
+            if (request.group) request.group->Add(pid);
+            process.pid = static_cast<ProcessId>(pid);
+            process.handle = OpenPidfd(pid);
+            return true;
+        }
+
+        posix_spawnattr_t attributes;
+        posix_spawnattr_init(&attributes);
+        if (request.group) {
+            // 在exec之前成为新进程组的组长，之后派生的进程都在组内
+            posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+            posix_spawnattr_setpgroup(&attributes, 0);
+        }
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        if (!request.workingDirectory.empty()) {
+            posix_spawn_file_actions_addchdir_np(&actions, ToNative(request.workingDirectory).c_str());
+        }
+
+        pid_t pid = 0;
+        int result = search ?
+            posix_spawnp(&pid, argv[0], &actions, &attributes, argv.data(), environ) :
+            posix_spawn(&pid, argv[0], &actions, &attributes, argv.data(), environ);
+        posix_spawn_file_actions_destroy(&actions);
+        posix_spawnattr_destroy(&attributes);
+        if (result != 0) {
+            errno = result;
+            return false;
+        }
+        if (request.group) request.group->Add(pid);
+
+        process.pid = static_cast<ProcessId>(pid);
+        process.handle = OpenPidfd(pid);
+        return true;
+    }
+
+    // 回收已退出的子进程，避免僵尸进程（不是本进程的子进程时什么也不做）
+    inline bool Reap(const ProcessHandle& process) {
+        int status = 0;
+        pid_t result = waitpid(static_cast<pid_t>(process.pid), &status, WNOHANG);
+        return result == static_cast<pid_t>(process.pid) || (result < 0 && errno == ECHILD);
+    }
+
+    // 检查子进程是否已退出但不回收，退出码留给GetExitCode，回收由CloseProcess完成
+    // 不是本进程的子进程（或已被回收）时也视为已退出，此时info.si_pid为0
+    inline bool PeekExit(const ProcessHandle& process, siginfo_t& info) {
+        info = siginfo_t();
+        if (waitid(P_PID, static_cast<id_t>(process.pid), &info, WEXITED | WNOHANG | WNOWAIT) < 0) return errno == ECHILD;
+        return info.si_pid != 0;
+    }
+
+    // 已退出进程的退出码；被信号终止时按shell惯例为128+信号编号（进程被回收后无法再取得）
+    inline bool GetExitCode(const ProcessHandle& process, int& exitCode) {
+        siginfo_t info;
+        if (!process.IsValid() || !PeekExit(process, info) || info.si_pid == 0) return false;
+        exitCode = info.si_code == CLD_EXITED ? info.si_status : 128 + info.si_status;
+        return true;
+    }
+
+    // timeoutMs小于0时无限等待；不回收进程，以便之后仍能取得退出码
+    inline WaitResult WaitForExit(const ProcessHandle& process, int timeoutMs) {
+        if (!process.IsValid()) return WaitResult::Failed;
+
+        if (process.handle < 0) {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+            siginfo_t info;
+            while (!PeekExit(process, info)) {
+                if (timeoutMs >= 0 && std::chrono::steady_clock::now() >= deadline) return WaitResult::TimedOut;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            return WaitResult::Exited;
+        }
+
+        int epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd < 0) return WaitResult::Failed;
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        int ready = -1;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, process.handle, &event) == 0) {
+            do {
+                ready = epoll_wait(epollFd, &event, 1, timeoutMs);
+            } while (ready < 0 && errno == EINTR);
+        }
+        close(epollFd);
+
+        if (ready < 0) return WaitResult::Failed;
+        if (ready == 0) return WaitResult::TimedOut;
+        return WaitResult::Exited;
+    }
+
+    inline bool Terminate(const ProcessHandle& process) {
+        if (!process.IsValid()) return false;
+#ifdef SYS_pidfd_send_signal
+        // 通过pidfd发送信号，不会误杀PID被复用后的其他进程
+        if (process.handle >= 0) return syscall(SYS_pidfd_send_signal, process.handle, SIGKILL, nullptr, 0) == 0;
+#endif
+        return kill(static_cast<pid_t>(process.pid), SIGKILL) == 0;
+    }
+
+    inline bool TerminateById(ProcessId pid) {
+        return kill(static_cast<pid_t>(pid), SIGKILL) == 0;
+    }
+
+    inline void CloseProcess(ProcessHandle& process) {
+        if (process.IsValid()) Reap(process);
+        if (process.handle >= 0) close(process.handle);
+        process = ProcessHandle();
+    }
+
+    // 打开已在运行的进程（不是本进程的子进程，无法取得退出码）
+    inline bool OpenProcessById(ProcessId pid, ProcessHandle& process) {
+        if (pid == 0 || kill(static_cast<pid_t>(pid), 0) != 0) return false;
+        process.pid = pid;
+        process.handle = OpenPidfd(static_cast<pid_t>(pid));
+        return true;
+    }
+
+    // 没有统一的窗口系统可查询（见kHasWindows）
+    inline bool HasVisibleWindow(const std::vector<ProcessId>&) {
+        return false;
+    }
+
+    // 枚举/proc：名称取自comm；comm最长15字节，被截断时从命令行中找出完整文件名
+    // withPaths为true时额外读取/proc/<pid>/exe（解释器运行的脚本为解释器路径）
+    inline std::vector<ProcessInfo> ListProcesses(bool withPaths = false) {
+        std::vector<ProcessInfo> processes;
+        DIR* dir = opendir("/proc");
+        if (!dir) return processes;
+
+        while (struct dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] < '0' || entry->d_name[0] > '9') continue;
+            std::string base = std::string("/proc/") + entry->d_name;
+
+            std::string statLine;
+            if (!ReadSmallFile(base + "/stat", statLine)) continue;
+            size_t nameStart = statLine.find('(');
+            size_t nameEnd = statLine.rfind(')');
+            if (nameStart == std::string::npos || nameEnd == std::string::npos || nameEnd + 4 > statLine.size()) continue;
+
+            char state = statLine[nameEnd + 2];
+            if (state == 'Z' || state == 'X') continue;       // 已退出但尚未回收
+
+            ProcessInfo info;
+            info.pid = static_cast<ProcessId>(std::strtoul(entry->d_name, nullptr, 10));
+            info.parentPid = static_cast<ProcessId>(std::strtoul(statLine.c_str() + nameEnd + 4, nullptr, 10));
+            std::string name = statLine.substr(nameStart + 1, nameEnd - nameStart - 1);
+
+            std::string cmdline;
+            if (name.size() >= 15 && ReadSmallFile(base + "/cmdline", cmdline)) {
+                for (size_t start = 0; start < cmdline.size();) {
+                    size_t end = cmdline.find('\0', start);
+                    if (end == std::string::npos) end = cmdline.size();
+                    std::string argument = cmdline.substr(start, end - start);
+                    std::string fileName = argument.substr(argument.find_last_of('/') + 1);
+                    if (fileName.compare(0, name.size(), name) == 0) {
+                        name = fileName;
+                        break;
+                    }
+                    start = end + 1;
+                }
+            }
+            info.name = TextEncoding::Utf8ToWide(name);
+            if (withPaths) {
+                char target[4096];
+                ssize_t length = readlink((base + "/exe").c_str(), target, sizeof(target) - 1);
+                if (length > 0) info.path = TextEncoding::Utf8ToWide(std::string(target, static_cast<size_t>(length)));
+            }
+            processes.push_back(info);
+        }
+        closedir(dir);
+        return processes;
+    }
+
+    // 文件与目录
+    inline std::wstring ToLowerCase(std::wstring str) {
+        std::transform(str.begin(), str.end(), str.begin(),
+            [](wchar_t c) { return static_cast<wchar_t>(std::towlower(c)); });
+        return str;
+    }
+
+    // extension为空时列出全部文件，否则按扩展名过滤（不区分大小写，与Windows一致）
+    inline std::vector<DirectoryEntry> ListDirectory(const std::wstring& folder, const std::wstring& extension = L"") {
+        std::vector<DirectoryEntry> entries;
+        DIR* dir = opendir(ToNative(folder).c_str());
+        if (!dir) return entries;
+
+        std::wstring lowerExtension = ToLowerCase(extension);
+        while (struct dirent* item = readdir(dir)) {
+            std::string name = item->d_name;
+            if (name == "." || name == "..") continue;
+
+            DirectoryEntry entry;
+            entry.name = TextEncoding::Utf8ToWide(name);
+            if (!lowerExtension.empty() && (entry.name.size() < lowerExtension.size() ||
+                ToLowerCase(entry.name.substr(entry.name.size() - lowerExtension.size())) != lowerExtension)) continue;
+
+            struct stat st;
+            if (fstatat(dirfd(dir), item->d_name, &st, 0) != 0) continue;
+            entry.isDirectory = S_ISDIR(st.st_mode);
+            entry.size = static_cast<uint64_t>(st.st_size);
+            entry.lastWriteTime = StatTime(st);
+            entries.push_back(entry);
+        }
+        closedir(dir);
+        return entries;
+    }
+
+    inline bool GetFileStamp(const std::wstring& path, uint64_t& size, uint64_t& lastWriteTime) {
+        struct stat st;
+        if (stat(ToNative(path).c_str(), &st) != 0) return false;
+        size = static_cast<uint64_t>(st.st_size);
+        lastWriteTime = StatTime(st);
+        return true;
+    }
+
+    inline bool FileExists(const std::wstring& path) {
+        struct stat st;
+        return stat(ToNative(path).c_str(), &st) == 0 && !S_ISDIR(st.st_mode);
+    }
+
+    inline bool DirectoryExists(const std::wstring& path) {
+        struct stat st;
+        return stat(ToNative(path).c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+    }
+
+    // 普通文件且当前用户有执行权限
+    inline bool IsExecutableFile(const std::wstring& path) {
+        std::string native = ToNative(path);
+        struct stat st;
+        return stat(native.c_str(), &st) == 0 && S_ISREG(st.st_mode) && access(native.c_str(), X_OK) == 0;
+    }
+
+    inline bool MakeDirectory(const std::wstring& path) {
+        return mkdir(ToNative(path).c_str(), 0755) == 0 || errno == EEXIST;
+    }
+
+    inline bool ReadWholeFile(const std::wstring& path, std::string& content) {
+        int fd = open(ToNative(path).c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0;
+        if (ok) {
+            posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+            content.resize(static_cast<size_t>(st.st_size));
+            size_t total = 0;
+            while (total < content.size()) {
+                ssize_t length = read(fd, &content[total], content.size() - total);
+                if (length <= 0) break;
+                total += static_cast<size_t>(length);
+            }
+            ok = total == content.size();
+        }
+        close(fd);
+        return ok;
+    }
+
+    // 读取offset之后的全部内容，fileSize返回当前文件大小（用于发现截断）
+    inline bool ReadFileFrom(const std::wstring& path, uint64_t offset, std::string& data, uint64_t& fileSize) {
+        int fd = open(ToNative(path).c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            return false;
+        }
+        fileSize = static_cast<uint64_t>(st.st_size);
+        data.clear();
+
+        char buffer[8192];
+        ssize_t length;
+        while (offset < fileSize && (length = pread(fd, buffer, sizeof(buffer), static_cast<off_t>(offset))) > 0) {
+            data.append(buffer, static_cast<size_t>(length));
+            offset += static_cast<uint64_t>(length);
+        }
+        close(fd);
+        return true;
+    }
+
+    // 写入临时文件后rename替换，避免中途失败留下不完整的文件
+    // 临时文件名唯一（mkostemp），多个线程或进程同时写同一目标时不会互相覆盖临时文件
+    inline bool WriteFileAtomic(const std::wstring& path, const std::string& content) {
+        std::string target = ToNative(path);
+        std::string tempPath = target + ".XXXXXX";
+        int fd = mkostemp(&tempPath[0], O_CLOEXEC);
+        if (fd < 0) return false;
+        fchmod(fd, 0644);
+
+        size_t total = 0;
+        while (total < content.size()) {
+            ssize_t length = write(fd, content.data() + total, content.size() - total);
+            if (length <= 0) break;
+            total += static_cast<size_t>(length);
+        }
+        close(fd);
+
+        if (total != content.size() || rename(tempPath.c_str(), target.c_str()) != 0) {
+            unlink(tempPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // 以O_APPEND方式一次写入（多个进程同时追加时各条记录不会交错）
+    inline bool AppendToFile(const std::wstring& path, const std::string& data) {
+        int fd = open(ToNative(path).c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+        ssize_t length = write(fd, data.data(), data.size());
+        close(fd);
+        return length == static_cast<ssize_t>(data.size());
+    }
+
+    // 只读内存映射
+    class MappedFile {
+    private:
+        const char* view = nullptr;
+        size_t size = 0;
+
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        ~MappedFile() {
+            Close();
+        }
+
+        bool Open(const std::wstring& path) {
+            Close();
+            int fd = open(ToNative(path).c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) return false;
+
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0) {
+                void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED) {
+                    view = static_cast<const char*>(mapped);
+                    size = static_cast<size_t>(st.st_size);
+                }
+            }
+            close(fd);
+            return view != nullptr;
+        }
+
+        void Close() {
+            if (view) munmap(const_cast<char*>(view), size);
+            view = nullptr;
+            size = 0;
+        }
+
+        const char* Data() const { return view; }
+        size_t Size() const { return size; }
+    };
+
+    // 把文件读入页缓存：每块先posix_fadvise(WILLNEED)让内核并发发出读取，再pread等到数据进入缓存
+    // （readahead在较新的内核上提交后即返回，无法据此限速和计时）
+    class PrefetchFile {
+    private:
+        int fd = -1;
+        uint64_t size = 0;
+        std::vector<char> buffer;
+
+    public:
+        PrefetchFile() = default;
+        PrefetchFile(const PrefetchFile&) = delete;
+        PrefetchFile& operator=(const PrefetchFile&) = delete;
+
+        ~PrefetchFile() {
+            Close();
+        }
+
+        bool Open(const std::wstring& path) {
+            Close();
+            fd = open(ToNative(path).c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) return false;
+            struct stat st;
+            if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+                Close();
+                return false;
+            }
+            size = static_cast<uint64_t>(st.st_size);
+            return true;
+        }
+
+        bool Read(uint64_t offset, uint64_t length) {
+            if (fd < 0) return false;
+            posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(length), POSIX_FADV_WILLNEED);
+            if (buffer.size() < length) buffer.resize(static_cast<size_t>(length));
+            while (length > 0) {
+                ssize_t count = pread(fd, buffer.data(), static_cast<size_t>(length), static_cast<off_t>(offset));
+                if (count < 0 && errno == EINTR) continue;
+                if (count <= 0) return count == 0;      // 文件在预读期间被截断
+                offset += static_cast<uint64_t>(count);
+                length -= static_cast<uint64_t>(count);
+            }
+            return true;
+        }
+
+        void Close() {
+            if (fd >= 0) close(fd);
+            fd = -1;
+            size = 0;
+        }
+
+        uint64_t Size() const { return size; }
+    };
+
+    inline std::wstring ExecutablePath() {
+        char exePath[4096];
+        ssize_t length = readlink("/proc/self/exe", exePath, sizeof(exePath) - 1);
+        if (length <= 0) return L"";
+        return TextEncoding::Utf8ToWide(std::string(exePath, static_cast<size_t>(length)));
+    }
+
+    inline std::wstring ExecutableDirectory() {
+        std::wstring exePath = ExecutablePath();
+        return exePath.empty() ? L"." : DirectoryOf(exePath);
+    }
+
+    // 控制台与时间
+    inline std::wstring LocalTimeString() {
+        time_t now = time(nullptr);
+        struct tm local;
+        localtime_r(&now, &local);
+        wchar_t buffer[64];
+        swprintf(buffer, sizeof(buffer) / sizeof(wchar_t), L"%02d:%02d:%02d", local.tm_hour, local.tm_min, local.tm_sec);
+        return std::wstring(buffer);
+    }
+
+    // 终端默认即为UTF-8
+    inline void SetConsoleUtf8() {
+    }
+
+    inline void SetConsoleTitleText(const std::wstring& title) {
+        if (isatty(STDOUT_FILENO)) {
+            std::string sequence = "\033]0;" + TextEncoding::WideToUtf8(title) + "\007";
+            ssize_t written = write(STDOUT_FILENO, sequence.data(), sequence.size());
+            (void)written;
+        }
+    }
+
+    // 系统负载：/proc/stat的CPU时间（iowait计入空闲）、/proc/meminfo的MemAvailable，
+    // 以及/proc/diskstats中/sys/block下整盘设备正在进行的I/O数（跳过loop、ram等虚拟设备）
+    inline bool ReadSystemLoad(SystemLoadCounters& counters) {
+        std::string content;
+        if (!ReadSmallFile("/proc/stat", content)) return false;
+        unsigned long long user = 0, nice = 0, system = 0, idle = 0, iowait = 0, irq = 0, softirq = 0, steal = 0;
+        if (sscanf(content.c_str(), "cpu %llu %llu %llu %llu %llu %llu %llu %llu",
+            &user, &nice, &system, &idle, &iowait, &irq, &softirq, &steal) < 4) return false;
+        counters.idleTime = idle + iowait;
+        counters.totalTime = user + nice + system + idle + iowait + irq + softirq + steal;
+
+        counters.availableMemoryMB = -1;
+        if (ReadSmallFile("/proc/meminfo", content)) {
+            size_t position = content.find("MemAvailable:");
+            if (position != std::string::npos) {
+                counters.availableMemoryMB = std::strtoll(content.c_str() + position + 13, nullptr, 10) / 1024;
+            }
+        }
+
+        counters.diskQueueLength = -1;
+        if (ReadSmallFile("/proc/diskstats", content)) {
+            size_t lineStart = 0;
+            while (lineStart < content.size()) {
+                size_t lineEnd = content.find('\n', lineStart);
+                if (lineEnd == std::string::npos) lineEnd = content.size();
+                unsigned major = 0, minor = 0;
+                char device[64] = {};
+                unsigned long long fields[9] = {};
+                std::string line = content.substr(lineStart, lineEnd - lineStart);
+                lineStart = lineEnd + 1;
+                if (sscanf(line.c_str(), "%u %u %63s %llu %llu %llu %llu %llu %llu %llu %llu %llu", &major, &minor, device,
+                    &fields[0], &fields[1], &fields[2], &fields[3], &fields[4], &fields[5], &fields[6], &fields[7], &fields[8]) < 12) continue;
+                std::string name = device;
+                if (name.compare(0, 4, "loop") == 0 || name.compare(0, 3, "ram") == 0 || name.compare(0, 4, "zram") == 0) continue;
+                if (access(("/sys/block/" + name).c_str(), F_OK) != 0) continue;
+                counters.diskQueueLength = (std::max)(counters.diskQueueLength, int64_t(0)) + static_cast<int64_t>(fields[8]);
+            }
+        }
+        return true;
+    }
+
+    // 把本进程降为后台优先级（nice 19、I/O idle类）。Linux的nice和I/O优先级按线程生效，
+    // 因此逐个设置/proc/self/task下已有的线程，之后创建的线程从创建者继承
+    inline bool EnterBackgroundMode() {
+        DIR* tasks = opendir("/proc/self/task");
+        if (!tasks) return false;
+        bool ok = true;
+        while (struct dirent* entry = readdir(tasks)) {
+            if (entry->d_name[0] == '.') continue;
+            id_t tid = static_cast<id_t>(std::strtoul(entry->d_name, nullptr, 10));
+            if (setpriority(PRIO_PROCESS, tid, 19) != 0) ok = false;
+#ifdef SYS_ioprio_set
+            syscall(SYS_ioprio_set, 1 /* IOPRIO_WHO_PROCESS */, static_cast<int>(tid), 3 << 13 /* IOPRIO_CLASS_IDLE */);
+#endif
+        }
+        closedir(tasks);
+        backgroundMode = true;
+        return ok;
+    }
+
+    // 网络
+    inline bool IsTcpPortOpen(int port) {
+        if (port <= 0 || port > 65535) return false;
+
+        int s = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_TCP);
+        if (s < 0) return false;
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<unsigned short>(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bool listening = connect(s, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        close(s);
+        return listening;
+    }
+
+    // 子进程退出监视：所有pidfd注册在同一个epoll实例上，由一个线程阻塞等待
+    // 注册时复制pidfd，调用方关闭进程句柄不影响监视；没有pidfd（内核低于5.3）的进程无法注册
+    class ExitWatcher {
+    private:
+        static constexpr uint64_t kWakeKey = ~0ull;
+        int epollFd = -1;
+        int wakeFd = -1;
+        std::mutex mutex;
+        std::unordered_map<uint64_t, int> fds;    // key -> 复制的pidfd
+        bool stopping = false;
+
+        void RemoveLocked(std::unordered_map<uint64_t, int>::iterator it) {
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second, nullptr);
+            close(it->second);
+            fds.erase(it);
+        }
+
+    public:
+        ExitWatcher() {
+            epollFd = epoll_create1(EPOLL_CLOEXEC);
+            wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            struct epoll_event event = {};
+            event.events = EPOLLIN;
+            event.data.u64 = kWakeKey;
+            if (epollFd >= 0 && wakeFd >= 0) epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+        }
+
+        ExitWatcher(const ExitWatcher&) = delete;
+        ExitWatcher& operator=(const ExitWatcher&) = delete;
+
+        ~ExitWatcher() {
+            for (auto& entry : fds) close(entry.second);
+            if (wakeFd >= 0) close(wakeFd);
+            if (epollFd >= 0) close(epollFd);
+        }
+
+        bool Add(const ProcessHandle& process, uint64_t key) {
+            if (process.handle < 0 || epollFd < 0) return false;
+            int fd = fcntl(process.handle, F_DUPFD_CLOEXEC, 0);
+            if (fd < 0) return false;
+            struct epoll_event event = {};
+            event.events = EPOLLIN;
+            event.data.u64 = key;
+            std::lock_guard<std::mutex> lock(mutex);
+            if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+                close(fd);
+                return false;
+            }
+            fds[key] = fd;
+            return true;
+        }
+
+        void Remove(uint64_t key) {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = fds.find(key);
+            if (it != fds.end()) RemoveLocked(it);
+        }
+
+        // 阻塞到至少一个进程退出，退出的进程自动移除；Stop之后返回false
+        bool Wait(std::vector<uint64_t>& exited) {
+            exited.clear();
+            struct epoll_event events[16];
+            while (true) {
+                int ready = epoll_wait(epollFd, events, 16, -1);
+                if (ready < 0 && errno == EINTR) continue;
+                if (ready < 0) return false;
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (stopping) return false;
+                for (int i = 0; i < ready; i++) {
+                    uint64_t key = events[i].data.u64;
+                    if (key == kWakeKey) {
+                        uint64_t count;
+                        while (read(wakeFd, &count, sizeof(count)) > 0) {}
+                        continue;
+                    }
+                    auto it = fds.find(key);
+                    if (it == fds.end()) continue;
+                    RemoveLocked(it);
+                    exited.push_back(key);
+                }
+                if (!exited.empty()) return true;
+            }
+        }
+
+        void Stop() {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            uint64_t one = 1;
+            if (write(wakeFd, &one, sizeof(one)) < 0) {}
+        }
+    };
+
+    // 子进程输出读取：一个线程通过epoll同时读取所有输出管道（读端非阻塞），
+    // 每次就绪最多读kReadsPerWakeup次，输出很多的进程不会饿死其他管道，剩余数据留到下一轮
+    class OutputReader {
+    private:
+        static constexpr uint64_t kWakeKey = ~0ull;
+        static constexpr size_t kBufferSize = 64 * 1024;
+        static constexpr int kReadsPerWakeup = 4;
+        int epollFd = -1;
+        int wakeFd = -1;
+        std::mutex mutex;
+        std::unordered_map<uint64_t, int> fds;    // key -> 管道读端
+        bool stopping = false;
+        char buffer[kBufferSize];                 // 仅等待线程使用
+
+    public:
+        OutputReader() {
+            epollFd = epoll_create1(EPOLL_CLOEXEC);
+            wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            struct epoll_event event = {};
+            event.events = EPOLLIN;
+            event.data.u64 = kWakeKey;
+            if (epollFd >= 0 && wakeFd >= 0) epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+        }
+
+        OutputReader(const OutputReader&) = delete;
+        OutputReader& operator=(const OutputReader&) = delete;
+
+        ~OutputReader() {
+            for (auto& entry : fds) close(entry.second);
+            if (wakeFd >= 0) close(wakeFd);
+            if (epollFd >= 0) close(epollFd);
+        }
+
+        // 接管读端（失败时也会关闭）
+        bool Add(NativeHandle readEnd, uint64_t key) {
+            if (readEnd < 0) return false;
+            struct epoll_event event = {};
+            event.events = EPOLLIN;
+            event.data.u64 = key;
+            std::lock_guard<std::mutex> lock(mutex);
+            if (epollFd < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, readEnd, &event) != 0) {
+                close(readEnd);
+                return false;
+            }
+            fds[key] = readEnd;
+            return true;
+        }
+
+        // 阻塞到有管道可读或关闭，对每段数据调用onData(key, data, length)；
+        // 写端全部关闭后调用一次onData(key, nullptr, 0)并自动移除。onData在内部锁内调用，不能再调用Add；
+        // Stop之后返回false
+        template <typename Handler>
+        bool Wait(Handler&& onData) {
+            struct epoll_event events[16];
+            while (true) {
+                int ready = epoll_wait(epollFd, events, 16, -1);
+                if (ready < 0 && errno == EINTR) continue;
+                if (ready < 0) return false;
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (stopping) return false;
+                for (int i = 0; i < ready; i++) {
+                    uint64_t key = events[i].data.u64;
+                    if (key == kWakeKey) {
+                        uint64_t count;
+                        while (read(wakeFd, &count, sizeof(count)) > 0) {}
+                        continue;
+                    }
+                    auto it = fds.find(key);
+                    if (it == fds.end()) continue;
+                    bool closed = false;
+                    for (int reads = 0; reads < kReadsPerWakeup; reads++) {
+                        ssize_t length = read(it->second, buffer, sizeof(buffer));
+                        if (length > 0) {
+                            onData(key, static_cast<const char*>(buffer), static_cast<size_t>(length));
+                            continue;
+                        }
+                        if (length < 0 && errno == EINTR) continue;
+                        closed = length == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+                        break;
+                    }
+                    if (!closed) continue;
+                    epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second, nullptr);
+                    close(it->second);
+                    fds.erase(it);
+                    onData(key, static_cast<const char*>(nullptr), static_cast<size_t>(0));
+                }
+                return true;
+            }
+        }
+
+        void Stop() {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            uint64_t one = 1;
+            if (write(wakeFd, &one, sizeof(one)) < 0) {}
+        }
+    };
+
+    // 跨进程就绪通知（命名管道FIFO）：启动器创建读端并等待，独立控制器写入一个字节
+    class ReadyEvent {
+    private:
+        std::string path;
+        int fd = -1;
+
+    public:
+        ReadyEvent() = default;
+        ReadyEvent(const ReadyEvent&) = delete;
+        ReadyEvent& operator=(const ReadyEvent&) = delete;
+
+        ~ReadyEvent() {
+            if (fd >= 0) close(fd);
+            if (!path.empty()) unlink(path.c_str());
+        }
+
+        static std::wstring MakeName(size_t index) {
+            return L"/tmp/DailyClean_Ready_" + std::to_wstring(getpid()) + L"_" + std::to_wstring(index);
+        }
+
+        bool Create(const std::wstring& name) {
+            std::string fifoPath = ToNative(name);
+            unlink(fifoPath.c_str());
+            if (mkfifo(fifoPath.c_str(), 0600) != 0) return false;
+            path = fifoPath;
+            // 非阻塞打开读端，没有写入方时也不会阻塞
+            fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+            return fd >= 0;
+        }
+
+        // 收到通知返回true；控制器进程退出或超时返回false
+        bool Wait(const ProcessHandle& controller, int timeoutMs) {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+            while (true) {
+                struct pollfd fds[2] = { { fd, POLLIN, 0 }, { controller.handle, POLLIN, 0 } };
+                int remaining = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now()).count());
+                if (remaining < 0) remaining = 0;
+                int ready = poll(fds, controller.handle >= 0 ? 2 : 1, remaining);
+                if (ready < 0 && errno == EINTR) continue;
+                if (ready <= 0) return false;
+
+                char byte;
+                if ((fds[0].revents & POLLIN) && read(fd, &byte, 1) == 1) return true;
+                if (fds[1].revents & POLLIN) return false;
+                // 写入方关闭但没有数据（POLLHUP）：继续等待直到超时
+                if (remaining == 0) return false;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+
+        static bool Signal(const std::wstring& name) {
+            int writer = open(ToNative(name).c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+            if (writer < 0) return false;
+            char byte = 1;
+            bool signaled = write(writer, &byte, 1) == 1;
+            close(writer);
+            return signaled;
+        }
+    };
+}
@@ -0,0 +1,929 @@
+#pragma once
+#include <winsock2.h>
+#include <windows.h>
+#include <tlhelp32.h>
+#include <winioctl.h>
+#include <string>
+#include <vector>
+#include <cwchar>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include "Platform.h"
+
+#pragma comment(lib, "ws2_32.lib")
+#pragma comment(lib, "user32.lib")
+
+// Platform.h 的Win32后端
+namespace Platform {
+
+    inline uint64_t FileTimeToUInt64(const FILETIME& time) {
+        return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    }
+
+    inline int LastError() {
+        return static_cast<int>(GetLastError());
+    }
+
+    inline ProcessId CurrentProcessId() {
+        return GetCurrentProcessId();
+    }
+
+    // 进程管理
+    // 参数含空格时加引号；批处理通过 cmd.exe /c 执行
+    inline std::wstring CommandLineOf(const SpawnRequest& request) {
+        std::wstring commandLine = request.script ? L"cmd.exe /c \"" + request.path + L"\"" : request.path;
+        for (const auto& argument : request.arguments) {
+            commandLine += L" ";
+            commandLine += argument.find(L' ') != std::wstring::npos ? L"\"" + argument + L"\"" : argument;
+        }
+        return commandLine;
+    }
+
+    // 进程树容器（Job Object）：每个启动条目一个，定时关闭时一次调用结束整棵进程树，无需枚举进程快照
+    // 进程以挂起状态创建，加入作业后才开始运行，派生的所有后代自动属于同一作业
+    // 未设置JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE：启动器退出不影响已启动的程序
+    class ProcessGroup {
+    private:
+        HANDLE job = NULL;
+
+    public:
+        ProcessGroup() = default;
+        ProcessGroup(const ProcessGroup&) = delete;
+        ProcessGroup& operator=(const ProcessGroup&) = delete;
+
+        ~ProcessGroup() {
+            if (job) CloseHandle(job);
+        }
+
+        void Create(const std::wstring& name) {
+            (void)name;
+            if (!job) job = CreateJobObjectW(NULL, NULL);
+        }
+
+        bool SetLimits(const ProcessGroupLimits& limits) {
+            if (limits.memoryBytes == 0 && limits.cpuPercent <= 0) return true;
+            if (!job) return false;
+            bool ok = true;
+            if (limits.memoryBytes > 0) {
+                JOBOBJECT_EXTENDED_LIMIT_INFORMATION info = {};
+                info.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_JOB_MEMORY;
+                info.JobMemoryLimit = static_cast<SIZE_T>(limits.memoryBytes);
+                ok = SetInformationJobObject(job, JobObjectExtendedLimitInformation, &info, sizeof(info)) != FALSE && ok;
+            }
+            if (limits.cpuPercent > 0) {
+                JOBOBJECT_CPU_RATE_CONTROL_INFORMATION info = {};
+                info.ControlFlags = JOB_OBJECT_CPU_RATE_CONTROL_ENABLE | JOB_OBJECT_CPU_RATE_CONTROL_HARD_CAP;
+                info.CpuRate = static_cast<DWORD>((std::min)(limits.cpuPercent, 100) * 100);   // 以1/10000为单位
+                ok = SetInformationJobObject(job, JobObjectCpuRateControlInformation, &info, sizeof(info)) != FALSE && ok;
+            }
+            return ok;
+        }
+
+        bool IsValid() const {
+            return job != NULL;
+        }
+
+        // 由Spawn在进程恢复运行前调用
+        bool Add(HANDLE process) {
+            return job && AssignProcessToJobObject(job, process) != FALSE;
+        }
+
+        // 作业中是否已没有进程（启动的进程及其后代都已退出）
+        bool IsEmpty() {
+            JOBOBJECT_BASIC_ACCOUNTING_INFORMATION info = {};
+            if (!job || !QueryInformationJobObject(job, JobObjectBasicAccountingInformation, &info, sizeof(info), NULL)) return true;
+            return info.ActiveProcesses == 0;
+        }
+
+        // 结束作业中的所有进程
+        bool Terminate() {
+            return job && !IsEmpty() && TerminateJobObject(job, 1) != FALSE;
+        }
+    };
+
+    // 在挂起的进程恢复运行前应用调度设置；权限不足（例如高I/O优先级）时保持默认值
+    inline void ApplyScheduling(HANDLE process, const SchedulingOptions& options) {
+        static const DWORD kPriorityClass[] = { IDLE_PRIORITY_CLASS, BELOW_NORMAL_PRIORITY_CLASS, NORMAL_PRIORITY_CLASS,
+            ABOVE_NORMAL_PRIORITY_CLASS, HIGH_PRIORITY_CLASS };
+        static const ULONG kMemoryPriority[] = { MEMORY_PRIORITY_VERY_LOW, MEMORY_PRIORITY_BELOW_NORMAL,
+            MEMORY_PRIORITY_NORMAL, MEMORY_PRIORITY_NORMAL, MEMORY_PRIORITY_NORMAL };
+        static const ULONG kIoPriority[] = { 0, 1, 2, 2, 3 };   // IoPriorityVeryLow/Low/Normal/High
+
+        if (options.priorityClass >= 1 && options.priorityClass <= 5) {
+            SetPriorityClass(process, kPriorityClass[options.priorityClass - 1]);
+        }
+        if (!options.cpus.empty()) {
+            DWORD_PTR mask = 0, processMask = 0, systemMask = 0;
+            for (int cpu : options.cpus) {
+                if (cpu >= 0 && cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) mask |= static_cast<DWORD_PTR>(1) << cpu;
+            }
+            if (GetProcessAffinityMask(process, &processMask, &systemMask)) mask &= systemMask;
+            if (mask) SetProcessAffinityMask(process, mask);
+        }
+        if (options.memoryPriority >= 1 && options.memoryPriority <= 5) {
+            MEMORY_PRIORITY_INFORMATION info = {};
+            info.MemoryPriority = kMemoryPriority[options.memoryPriority - 1];
+            SetProcessInformation(process, ProcessMemoryPriority, &info, sizeof(info));
+        }
+        if (options.ioPriority >= 1 && options.ioPriority <= 5) {
+            // 进程I/O优先级没有公开的Win32 API，使用ntdll的NtSetInformationProcess(ProcessIoPriority)
+            using SetInformationProcess = NTSTATUS(WINAPI*)(HANDLE, ULONG, PVOID, ULONG);
+            static const SetInformationProcess setInformation = reinterpret_cast<SetInformationProcess>(
+                reinterpret_cast<void*>(GetProcAddress(GetModuleHandleW(L"ntdll.dll"), "NtSetInformationProcess")));
+            const ULONG kProcessIoPriority = 33;
+            ULONG value = kIoPriority[options.ioPriority - 1];
+            if (setInformation) setInformation(process, kProcessIoPriority, &value, sizeof(value));
+        }
+    }
+
+    // 把本进程降为后台模式（CPU、I/O和内存优先级都降低）；子进程不继承后台模式
+    inline bool EnterBackgroundMode() {
+        backgroundMode = true;
+        return SetPriorityClass(GetCurrentProcess(), PROCESS_MODE_BACKGROUND_BEGIN) != FALSE;
+    }
+
+    // 子进程输出管道：读端是支持重叠I/O的命名管道（匿名管道不支持重叠读），写端可继承
+    inline bool OpenOutputPipe(HANDLE& readEnd, HANDLE& writeEnd) {
+        static std::atomic<unsigned long> counter{ 0 };
+        std::wstring name = L"\\\\.\\pipe\\DailyClean_Output_" + std::to_wstring(GetCurrentProcessId()) + L"_" +
+            std::to_wstring(++counter);
+        readEnd = CreateNamedPipeW(name.c_str(), PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+            PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, 1, 0, 64 * 1024, 0, NULL);
+        if (readEnd == INVALID_HANDLE_VALUE) {
+            readEnd = NULL;
+            return false;
+        }
+        SECURITY_ATTRIBUTES attributes = { sizeof(attributes), NULL, TRUE };
+        writeEnd = CreateFileW(name.c_str(), GENERIC_WRITE, 0, &attributes, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (writeEnd == INVALID_HANDLE_VALUE) {
+            CloseHandle(readEnd);
+            readEnd = writeEnd = NULL;
+            return false;
+        }
+        return true;
+    }
+
+    inline void CloseOutputPipe(NativeHandle readEnd) {
+        if (readEnd) CloseHandle(readEnd);
+    }
+
+    inline bool Spawn(const SpawnRequest& request, ProcessHandle& process) {
+        STARTUPINFOEXW si = {};
+        si.StartupInfo.cb = sizeof(si);
+        PROCESS_INFORMATION pi;
+        std::wstring commandLine = CommandLineOf(request);
+        SchedulingOptions scheduling = EffectiveScheduling(request.scheduling);
+        bool useGroup = request.group && request.group->IsValid();
+        bool suspended = useGroup || !scheduling.IsEmpty();
+        DWORD flags = (request.newConsole ? CREATE_NEW_CONSOLE : 0) | (suspended ? CREATE_SUSPENDED : 0);
+
+        // 输出重定向：只允许子进程继承写端（PROC_THREAD_ATTRIBUTE_HANDLE_LIST），
+        // 其他线程同时启动的子进程不会持有它，否则子进程退出后读端收不到EOF；stdin为空
+        HANDLE outputRead = NULL, outputWrite = NULL;
+        std::vector<char> attributeBuffer;
+        if (request.outputPipe) {
+            if (!OpenOutputPipe(outputRead, outputWrite)) return false;
+            SIZE_T size = 0;
+            InitializeProcThreadAttributeList(NULL, 1, 0, &size);
+            attributeBuffer.resize(size);
+            si.lpAttributeList = reinterpret_cast<LPPROC_THREAD_ATTRIBUTE_LIST>(attributeBuffer.data());
+            if (!InitializeProcThreadAttributeList(si.lpAttributeList, 1, 0, &size)) {
+                CloseHandle(outputRead);
+                CloseHandle(outputWrite);
+                return false;
+            }
+            UpdateProcThreadAttribute(si.lpAttributeList, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST,
+                &outputWrite, sizeof(outputWrite), NULL, NULL);
+            si.StartupInfo.dwFlags |= STARTF_USESTDHANDLES;
+            si.StartupInfo.hStdOutput = outputWrite;
+            si.StartupInfo.hStdError = outputWrite;
+            flags |= EXTENDED_STARTUPINFO_PRESENT;
+        }
+
+        BOOL success = CreateProcessW(
+            NULL,
+            &commandLine[0],
+            NULL,
+            NULL,
+            request.outputPipe ? TRUE : FALSE,
+            flags,
+            NULL,
+            request.workingDirectory.empty() ? NULL : request.workingDirectory.c_str(),
+            &si.StartupInfo,
+            &pi
+        );
+        if (request.outputPipe) {
+            DWORD error = GetLastError();
+            DeleteProcThreadAttributeList(si.lpAttributeList);
+            CloseHandle(outputWrite);
+            if (success) *request.outputPipe = outputRead;
+            else CloseHandle(outputRead);
+            SetLastError(error);
+        }
+        if (!success) return false;
+
+        if (suspended) {
+            // 加入作业失败（例如所在作业不允许嵌套）时仍然运行，只是无法按进程树关闭
+            if (useGroup) request.group->Add(pi.hProcess);
+            ApplyScheduling(pi.hProcess, scheduling);
+            ResumeThread(pi.hThread);
+        }
+        CloseHandle(pi.hThread);
+        process.pid = static_cast<ProcessId>(pi.dwProcessId);
+        process.handle = pi.hProcess;
+        return true;
+    }
+
+    // timeoutMs小于0时无限等待
+    inline WaitResult WaitForExit(const ProcessHandle& process, int timeoutMs) {
+        if (!process.handle) return WaitResult::Failed;
+        DWORD result = WaitForSingleObject(process.handle, timeoutMs < 0 ? INFINITE : static_cast<DWORD>(timeoutMs));
+        if (result == WAIT_OBJECT_0) return WaitResult::Exited;
+        return result == WAIT_TIMEOUT ? WaitResult::TimedOut : WaitResult::Failed;
+    }
+
+    // Windows无需回收已退出的进程，关闭句柄即可（见CloseProcess）
+    inline bool Reap(const ProcessHandle&) {
+        return true;
+    }
+
+    inline bool GetExitCode(const ProcessHandle& process, int& exitCode) {
+        DWORD code = 0;
+        if (!process.handle || !GetExitCodeProcess(process.handle, &code) || code == STILL_ACTIVE) return false;
+        exitCode = static_cast<int>(code);
+        return true;
+    }
+
+    inline bool Terminate(const ProcessHandle& process) {
+        return process.handle && TerminateProcess(process.handle, 0) != FALSE;
+    }
+
+    inline bool TerminateById(ProcessId pid) {
+        HANDLE hProcess = OpenProcess(PROCESS_TERMINATE, FALSE, pid);
+        if (!hProcess) return false;
+        bool terminated = TerminateProcess(hProcess, 0) != FALSE;
+        CloseHandle(hProcess);
+        return terminated;
+    }
+
+    inline void CloseProcess(ProcessHandle& process) {
+        if (process.handle) CloseHandle(process.handle);
+        process = ProcessHandle();
+    }
+
+    // 打开已在运行的进程，用于等待退出和按句柄关闭
+    inline bool OpenProcessById(ProcessId pid, ProcessHandle& process) {
+        HANDLE handle = OpenProcess(SYNCHRONIZE | PROCESS_TERMINATE | PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+        if (!handle) return false;
+        process.pid = pid;
+        process.handle = handle;
+        return true;
+    }
+
+    // pids中是否有进程拥有可见的顶层主窗口（无所有者窗口）
+    inline bool HasVisibleWindow(const std::vector<ProcessId>& pids) {
+        struct Search {
+            const std::vector<ProcessId>* pids;
+            bool found;
+        } search = { &pids, false };
+        EnumWindows([](HWND window, LPARAM param) -> BOOL {
+            Search* search = reinterpret_cast<Search*>(param);
+            DWORD owner = 0;
+            GetWindowThreadProcessId(window, &owner);
+            if (IsWindowVisible(window) && GetWindow(window, GW_OWNER) == NULL &&
+                std::find(search->pids->begin(), search->pids->end(), owner) != search->pids->end()) {
+                search->found = true;
+                return FALSE;
+            }
+            return TRUE;
+        }, reinterpret_cast<LPARAM>(&search));
+        return search.found;
+    }
+
+    // withPaths为true时逐个查询完整路径（无权限打开的系统进程路径为空）
+    inline std::vector<ProcessInfo> ListProcesses(bool withPaths = false) {
+        std::vector<ProcessInfo> processes;
+        HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+        if (hSnapshot == INVALID_HANDLE_VALUE) return processes;
+
+        PROCESSENTRY32W pe;
+        pe.dwSize = sizeof(PROCESSENTRY32W);
+        if (Process32FirstW(hSnapshot, &pe)) {
+            do {
+                ProcessInfo info;
+                info.pid = static_cast<ProcessId>(pe.th32ProcessID);
+                info.parentPid = static_cast<ProcessId>(pe.th32ParentProcessID);
+                info.name = pe.szExeFile;
+                if (withPaths) {
+                    HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pe.th32ProcessID);
+                    if (hProcess) {
+                        wchar_t path[MAX_PATH * 2];
+                        DWORD length = MAX_PATH * 2;
+                        if (QueryFullProcessImageNameW(hProcess, 0, path, &length)) info.path.assign(path, length);
+                        CloseHandle(hProcess);
+                    }
+                }
+                processes.push_back(info);
+            } while (Process32NextW(hSnapshot, &pe));
+        }
+        CloseHandle(hSnapshot);
+        return processes;
+    }
+
+    // 文件与目录
+    // extension为空时列出全部文件，例如 L".json"
+    inline std::vector<DirectoryEntry> ListDirectory(const std::wstring& folder, const std::wstring& extension = L"") {
+        std::vector<DirectoryEntry> entries;
+        WIN32_FIND_DATAW findFileData;
+        HANDLE hFind = FindFirstFileW(JoinPath(folder, L"*" + extension).c_str(), &findFileData);
+        if (hFind == INVALID_HANDLE_VALUE) return entries;
+
+        do {
+            DirectoryEntry entry;
+            entry.name = findFileData.cFileName;
+            if (entry.name == L"." || entry.name == L"..") continue;
+            entry.isDirectory = (findFileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+            entry.size = (static_cast<uint64_t>(findFileData.nFileSizeHigh) << 32) | findFileData.nFileSizeLow;
+            entry.lastWriteTime = FileTimeToUInt64(findFileData.ftLastWriteTime);
+            entries.push_back(entry);
+        } while (FindNextFileW(hFind, &findFileData));
+        FindClose(hFind);
+        return entries;
+    }
+
+    inline bool GetFileStamp(const std::wstring& path, uint64_t& size, uint64_t& lastWriteTime) {
+        WIN32_FILE_ATTRIBUTE_DATA data;
+        if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data)) return false;
+        size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+        lastWriteTime = FileTimeToUInt64(data.ftLastWriteTime);
+        return true;
+    }
+
+    inline bool FileExists(const std::wstring& path) {
+        DWORD attrib = GetFileAttributesW(path.c_str());
+        return attrib != INVALID_FILE_ATTRIBUTES && !(attrib & FILE_ATTRIBUTE_DIRECTORY);
+    }
+
+    inline bool DirectoryExists(const std::wstring& path) {
+        DWORD attrib = GetFileAttributesW(path.c_str());
+        return attrib != INVALID_FILE_ATTRIBUTES && (attrib & FILE_ATTRIBUTE_DIRECTORY);
+    }
+
+    // CreateProcess能直接执行的映像（PE或COM），脚本不算
+    inline bool IsExecutableFile(const std::wstring& path) {
+        DWORD binaryType;
+        return FileExists(path) && GetBinaryTypeW(path.c_str(), &binaryType) != FALSE;
+    }
+
+    inline bool MakeDirectory(const std::wstring& path) {
+        return CreateDirectoryW(path.c_str(), NULL) != FALSE || GetLastError() == ERROR_ALREADY_EXISTS;
+    }
+
+    inline bool ReadWholeFile(const std::wstring& path, std::string& content) {
+        HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+            NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (hFile == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER size;
+        bool ok = GetFileSizeEx(hFile, &size) != FALSE;
+        if (ok) {
+            content.resize(static_cast<size_t>(size.QuadPart));
+            DWORD bytesRead = 0;
+            ok = content.empty() ||
+                (ReadFile(hFile, &content[0], static_cast<DWORD>(content.size()), &bytesRead, NULL) &&
+                    bytesRead == content.size());
+        }
+        CloseHandle(hFile);
+        return ok;
+    }
+
+    // 读取offset之后的全部内容，fileSize返回当前文件大小（用于发现截断）
+    inline bool ReadFileFrom(const std::wstring& path, uint64_t offset, std::string& data, uint64_t& fileSize) {
+        HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (hFile == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(hFile, &size)) {
+            CloseHandle(hFile);
+            return false;
+        }
+        fileSize = static_cast<uint64_t>(size.QuadPart);
+        data.clear();
+        if (offset < fileSize) {
+            LARGE_INTEGER position;
+            position.QuadPart = static_cast<LONGLONG>(offset);
+            SetFilePointerEx(hFile, position, NULL, FILE_BEGIN);
+
+            char buffer[8192];
+            DWORD bytesRead = 0;
+            while (ReadFile(hFile, buffer, sizeof(buffer), &bytesRead, NULL) && bytesRead > 0) {
+                data.append(buffer, bytesRead);
+            }
+        }
+        CloseHandle(hFile);
+        return true;
+    }
+
+    // 写入临时文件后替换，避免中途失败留下不完整的文件
+    // 临时文件名按进程和序号区分，多个线程或进程同时写同一目标时不会互相覆盖临时文件
+    inline bool WriteFileAtomic(const std::wstring& path, const std::string& content) {
+        static std::atomic<unsigned> sequence{ 0 };
+        std::wstring tempPath = path + L"." + std::to_wstring(GetCurrentProcessId()) + L"." +
+            std::to_wstring(sequence++) + L".tmp";
+        HANDLE hFile = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, NULL, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (hFile == INVALID_HANDLE_VALUE) return false;
+
+        DWORD written = 0;
+        bool ok = WriteFile(hFile, content.data(), static_cast<DWORD>(content.size()), &written, NULL) &&
+            written == content.size();
+        CloseHandle(hFile);
+
+        if (!ok || !MoveFileExW(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+            DeleteFileW(tempPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // 以追加方式打开并一次写入（多个进程同时追加时各条记录不会交错）
+    inline bool AppendToFile(const std::wstring& path, const std::string& data) {
+        HANDLE hFile = CreateFileW(path.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (hFile == INVALID_HANDLE_VALUE) return false;
+        DWORD written = 0;
+        bool ok = WriteFile(hFile, data.data(), static_cast<DWORD>(data.size()), &written, NULL) && written == data.size();
+        CloseHandle(hFile);
+        return ok;
+    }
+
+    // 只读内存映射
+    class MappedFile {
+    private:
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = NULL;
+        const char* view = nullptr;
+        size_t size = 0;
+
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        ~MappedFile() {
+            Close();
+        }
+
+        bool Open(const std::wstring& path) {
+            Close();
+            file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+            if (file == INVALID_HANDLE_VALUE) return false;
+
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+                Close();
+                return false;
+            }
+            size = static_cast<size_t>(fileSize.QuadPart);
+            mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            view = mapping ? static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+            if (!view) {
+                Close();
+                return false;
+            }
+            return true;
+        }
+
+        void Close() {
+            if (view) UnmapViewOfFile(view);
+            if (mapping) CloseHandle(mapping);
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+            view = nullptr;
+            mapping = NULL;
+            file = INVALID_HANDLE_VALUE;
+            size = 0;
+        }
+
+        const char* Data() const { return view; }
+        size_t Size() const { return size; }
+    };
+
+    // 把文件读入系统缓存：每次Read把区间拆成若干片同时发出重叠读取，再等待全部完成
+    // 读到的数据直接丢弃，之后程序打开同一文件时命中缓存
+    class PrefetchFile {
+    private:
+        static constexpr DWORD kSliceBytes = 256 * 1024;
+        static constexpr int kSlices = 4;
+
+        HANDLE file = INVALID_HANDLE_VALUE;
+        uint64_t size = 0;
+        std::vector<char> buffer;
+        HANDLE events[kSlices] = {};
+
+    public:
+        PrefetchFile() = default;
+        PrefetchFile(const PrefetchFile&) = delete;
+        PrefetchFile& operator=(const PrefetchFile&) = delete;
+
+        ~PrefetchFile() {
+            Close();
+            for (HANDLE event : events) {
+                if (event) CloseHandle(event);
+            }
+        }
+
+        bool Open(const std::wstring& path) {
+            Close();
+            file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+            if (file == INVALID_HANDLE_VALUE) return false;
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(file, &fileSize)) {
+                Close();
+                return false;
+            }
+            size = static_cast<uint64_t>(fileSize.QuadPart);
+            if (buffer.empty()) buffer.resize(static_cast<size_t>(kSliceBytes) * kSlices);
+            for (HANDLE& event : events) {
+                if (!event) event = CreateEventW(NULL, TRUE, FALSE, NULL);
+            }
+            return true;
+        }
+
+        bool Read(uint64_t offset, uint64_t length) {
+            if (file == INVALID_HANDLE_VALUE) return false;
+            bool ok = true;
+            while (length > 0) {
+                OVERLAPPED overlapped[kSlices] = {};
+                bool pending[kSlices] = {};
+                int issued = 0;
+                for (; issued < kSlices && length > 0; issued++) {
+                    DWORD slice = static_cast<DWORD>((std::min)(length, static_cast<uint64_t>(kSliceBytes)));
+                    overlapped[issued].Offset = static_cast<DWORD>(offset);
+                    overlapped[issued].OffsetHigh = static_cast<DWORD>(offset >> 32);
+                    overlapped[issued].hEvent = events[issued];
+                    ResetEvent(events[issued]);
+                    if (!ReadFile(file, buffer.data() + static_cast<size_t>(issued) * kSliceBytes, slice, NULL, &overlapped[issued])) {
+                        DWORD error = GetLastError();
+                        if (error == ERROR_IO_PENDING) pending[issued] = true;
+                        else if (error != ERROR_HANDLE_EOF) ok = false;
+                    }
+                    offset += slice;
+                    length -= slice;
+                }
+                for (int i = 0; i < issued; i++) {
+                    DWORD transferred = 0;
+                    if (pending[i] && !GetOverlappedResult(file, &overlapped[i], &transferred, TRUE) &&
+                        GetLastError() != ERROR_HANDLE_EOF) ok = false;
+                }
+                if (!ok) break;
+            }
+            return ok;
+        }
+
+        void Close() {
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+            file = INVALID_HANDLE_VALUE;
+            size = 0;
+        }
+
+        uint64_t Size() const { return size; }
+    };
+
+    inline std::wstring ExecutablePath() {
+        wchar_t exePath[MAX_PATH];
+        GetModuleFileNameW(NULL, exePath, MAX_PATH);
+        return exePath;
+    }
+
+    inline std::wstring ExecutableDirectory() {
+        return DirectoryOf(ExecutablePath());
+    }
+
+    // 控制台与时间
+    inline std::wstring LocalTimeString() {
+        SYSTEMTIME st;
+        GetLocalTime(&st);
+        wchar_t buffer[64];
+        swprintf_s(buffer, sizeof(buffer) / sizeof(wchar_t), L"%02d:%02d:%02d", st.wHour, st.wMinute, st.wSecond);
+        return std::wstring(buffer);
+    }
+
+    inline void SetConsoleUtf8() {
+        SetConsoleOutputCP(65001);
+        SetConsoleCP(65001);
+    }
+
+    inline void SetConsoleTitleText(const std::wstring& title) {
+        SetConsoleTitleW(title.c_str());
+    }
+
+    // 系统负载：GetSystemTimes的内核时间已包含空闲时间；
+    // 磁盘队列取各PhysicalDriveN的DISK_PERFORMANCE.QueueDepth（无需管理员权限）
+    inline bool ReadSystemLoad(SystemLoadCounters& counters) {
+        FILETIME idle, kernel, user;
+        if (!GetSystemTimes(&idle, &kernel, &user)) return false;
+        counters.idleTime = FileTimeToUInt64(idle);
+        counters.totalTime = FileTimeToUInt64(kernel) + FileTimeToUInt64(user);
+
+        MEMORYSTATUSEX memory = {};
+        memory.dwLength = sizeof(memory);
+        counters.availableMemoryMB = GlobalMemoryStatusEx(&memory) ?
+            static_cast<int64_t>(memory.ullAvailPhys / (1024 * 1024)) : -1;
+
+        counters.diskQueueLength = -1;
+        for (int drive = 0; drive < 16; drive++) {
+            std::wstring devicePath = L"\\\\.\\PhysicalDrive" + std::to_wstring(drive);
+            HANDLE device = CreateFileW(devicePath.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, NULL);
+            if (device == INVALID_HANDLE_VALUE) break;
+            DISK_PERFORMANCE performance = {};
+            DWORD bytes = 0;
+            if (DeviceIoControl(device, IOCTL_DISK_PERFORMANCE, NULL, 0, &performance, sizeof(performance), &bytes, NULL)) {
+                counters.diskQueueLength = (std::max)(counters.diskQueueLength, int64_t(0)) + performance.QueueDepth;
+            }
+            CloseHandle(device);
+        }
+        return true;
+    }
+
+    // 网络
+    inline bool IsTcpPortOpen(int port) {
+        static bool wsaInitialized = []() {
+            WSADATA wsaData;
+            return WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+        }();
+        if (!wsaInitialized || port <= 0 || port > 65535) return false;
+
+        SOCKET s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (s == INVALID_SOCKET) return false;
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<unsigned short>(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bool listening = connect(s, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        closesocket(s);
+        return listening;
+    }
+
+    // 子进程退出监视：每个进程句柄通过RegisterWaitForSingleObject交给系统线程池等待，
+    // 退出通知放入队列，由调用Wait的线程取出；进程数量不受MAXIMUM_WAIT_OBJECTS限制
+    // 注册时复制句柄，调用方关闭进程句柄不影响监视
+    class ExitWatcher {
+    private:
+        struct Watch {
+            ExitWatcher* owner;
+            uint64_t key;
+            HANDLE process;
+            HANDLE wait;
+        };
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::unordered_map<uint64_t, std::unique_ptr<Watch>> watches;
+        std::vector<uint64_t> exitedKeys;          // 线程池回调放入，Wait取出
+        bool stopping = false;
+
+        // 线程池线程上执行；只持有本监视器的锁
+        static VOID CALLBACK OnExit(PVOID context, BOOLEAN) {
+            Watch* watch = static_cast<Watch*>(context);
+            ExitWatcher* owner = watch->owner;
+            std::lock_guard<std::mutex> lock(owner->mutex);
+            owner->exitedKeys.push_back(watch->key);
+            owner->changed.notify_all();
+        }
+
+        // 注销等待（等待正在执行的回调结束）并关闭句柄，调用时不能持有mutex
+        static void Release(std::unique_ptr<Watch>& watch) {
+            if (watch->wait) UnregisterWaitEx(watch->wait, INVALID_HANDLE_VALUE);
+            CloseHandle(watch->process);
+            watch.reset();
+        }
+
+    public:
+        ExitWatcher() = default;
+
+        ExitWatcher(const ExitWatcher&) = delete;
+        ExitWatcher& operator=(const ExitWatcher&) = delete;
+
+        ~ExitWatcher() {
+            std::unordered_map<uint64_t, std::unique_ptr<Watch>> remaining;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                remaining.swap(watches);
+            }
+            for (auto& entry : remaining) Release(entry.second);
+        }
+
+        bool Add(const ProcessHandle& process, uint64_t key) {
+            if (!process.handle) return false;
+            std::unique_ptr<Watch> watch(new Watch{ this, key, NULL, NULL });
+            if (!DuplicateHandle(GetCurrentProcess(), process.handle, GetCurrentProcess(), &watch->process,
+                SYNCHRONIZE | PROCESS_QUERY_LIMITED_INFORMATION, FALSE, 0)) return false;
+            // 注册时持有锁：回调要等注册完成、wait已写入后才能放入通知（注册本身不等待回调）
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!RegisterWaitForSingleObject(&watch->wait, watch->process, OnExit, watch.get(), INFINITE, WT_EXECUTEONLYONCE)) {
+                CloseHandle(watch->process);
+                return false;
+            }
+            watches[key] = std::move(watch);
+            return true;
+        }
+
+        void Remove(uint64_t key) {
+            std::unique_ptr<Watch> removed;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                auto it = watches.find(key);
+                if (it == watches.end()) return;
+                removed = std::move(it->second);
+                watches.erase(it);
+            }
+            Release(removed);
+            // 注销之前回调可能已放入通知
+            std::lock_guard<std::mutex> lock(mutex);
+            exitedKeys.erase(std::remove(exitedKeys.begin(), exitedKeys.end(), key), exitedKeys.end());
+        }
+
+        // 阻塞到至少一个进程退出，退出的进程自动移除；Stop之后返回false
+        bool Wait(std::vector<uint64_t>& exited) {
+            exited.clear();
+            std::vector<std::unique_ptr<Watch>> finished;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [this]() { return stopping || !exitedKeys.empty(); });
+                if (stopping) return false;
+                // 同时退出的进程一并报告
+                for (uint64_t key : exitedKeys) {
+                    auto it = watches.find(key);
+                    if (it == watches.end()) continue;
+                    exited.push_back(key);
+                    finished.push_back(std::move(it->second));
+                    watches.erase(it);
+                }
+                exitedKeys.clear();
+            }
+            for (auto& watch : finished) Release(watch);
+            return true;
+        }
+
+        void Stop() {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            changed.notify_all();
+        }
+    };
+
+    // 子进程输出读取：所有输出管道关联到同一个完成端口，每个管道始终有一个未完成的重叠读，
+    // 一个线程在端口上等待完成包
+    class OutputReader {
+    private:
+        static constexpr size_t kBufferSize = 64 * 1024;
+        static constexpr ULONG_PTR kPipeKey = 1;   // 完成键0表示唤醒
+
+        struct Pipe {
+            OVERLAPPED overlapped;                 // 必须是第一个成员，完成包中的OVERLAPPED*即Pipe*
+            HANDLE handle;
+            uint64_t key;
+            bool reading;                          // 有未完成的读
+            char buffer[kBufferSize];
+        };
+
+        HANDLE port = NULL;
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Pipe>> pipes;
+        bool stopping = false;
+
+        // 同步完成时完成包同样会投递到端口；返回false表示管道已断开
+        static bool IssueRead(Pipe& pipe) {
+            pipe.overlapped = OVERLAPPED();
+            pipe.reading = ReadFile(pipe.handle, pipe.buffer, static_cast<DWORD>(kBufferSize), NULL, &pipe.overlapped) ||
+                GetLastError() == ERROR_IO_PENDING;
+            return pipe.reading;
+        }
+
+    public:
+        OutputReader() {
+            port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+        }
+
+        OutputReader(const OutputReader&) = delete;
+        OutputReader& operator=(const OutputReader&) = delete;
+
+        // 取消未完成的读，收齐完成包之后才能释放缓冲区
+        ~OutputReader() {
+            size_t pending = 0;
+            for (auto& pipe : pipes) {
+                if (!pipe->reading) continue;
+                CancelIoEx(pipe->handle, NULL);
+                pending++;
+            }
+            while (pending > 0 && port) {
+                DWORD bytes = 0;
+                ULONG_PTR completionKey = 0;
+                LPOVERLAPPED overlapped = NULL;
+                BOOL result = GetQueuedCompletionStatus(port, &bytes, &completionKey, &overlapped, 1000);
+                if (overlapped) pending--;
+                else if (!result) break;
+            }
+            for (auto& pipe : pipes) CloseHandle(pipe->handle);
+            if (port) CloseHandle(port);
+        }
+
+        // 接管读端；返回false时读端已关闭（包括子进程已退出且没有输出），不会再有回调
+        bool Add(NativeHandle readEnd, uint64_t key) {
+            if (!readEnd) return false;
+            auto pipe = std::unique_ptr<Pipe>(new Pipe());
+            pipe->handle = readEnd;
+            pipe->key = key;
+            pipe->reading = false;
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!port || !CreateIoCompletionPort(readEnd, port, kPipeKey, 0) || !IssueRead(*pipe)) {
+                CloseHandle(readEnd);
+                return false;
+            }
+            pipes.push_back(std::move(pipe));
+            return true;
+        }
+
+        // 阻塞到有读操作完成，对数据调用onData(key, data, length)；管道断开（写端全部关闭）后
+        // 调用一次onData(key, nullptr, 0)并自动移除。onData在内部锁内调用，不能再调用Add；
+        // Stop之后返回false
+        template <typename Handler>
+        bool Wait(Handler&& onData) {
+            while (true) {
+                DWORD bytes = 0;
+                ULONG_PTR completionKey = 0;
+                LPOVERLAPPED overlapped = NULL;
+                BOOL result = GetQueuedCompletionStatus(port, &bytes, &completionKey, &overlapped, INFINITE);
+                std::lock_guard<std::mutex> lock(mutex);
+                Pipe* pipe = reinterpret_cast<Pipe*>(overlapped);
+                if (pipe) pipe->reading = false;
+                if (stopping) return false;
+                if (!pipe) {
+                    if (!result) return false;
+                    continue;
+                }
+
+                if (result && bytes > 0) onData(pipe->key, static_cast<const char*>(pipe->buffer), static_cast<size_t>(bytes));
+                if (result && IssueRead(*pipe)) return true;
+
+                CloseHandle(pipe->handle);
+                uint64_t key = pipe->key;
+                pipes.erase(std::find_if(pipes.begin(), pipes.end(),
+                    [pipe](const std::unique_ptr<Pipe>& item) { return item.get() == pipe; }));
+                onData(key, static_cast<const char*>(nullptr), static_cast<size_t>(0));
+                return true;
+            }
+        }
+
+        void Stop() {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            if (port) PostQueuedCompletionStatus(port, 0, 0, NULL);
+        }
+    };
+
+    // 跨进程就绪通知（命名事件）：启动器创建并等待，独立控制器在程序就绪后触发
+    class ReadyEvent {
+    private:
+        HANDLE event = NULL;
+
+    public:
+        ReadyEvent() = default;
+        ReadyEvent(const ReadyEvent&) = delete;
+        ReadyEvent& operator=(const ReadyEvent&) = delete;
+
+        ~ReadyEvent() {
+            if (event) CloseHandle(event);
+        }
+
+        static std::wstring MakeName(size_t index) {
+            return L"Local\\DailyClean_Ready_" + std::to_wstring(GetCurrentProcessId()) + L"_" + std::to_wstring(index);
+        }
+
+        bool Create(const std::wstring& name) {
+            event = CreateEventW(NULL, TRUE, FALSE, name.c_str());
+            return event != NULL;
+        }
+
+        // 事件触发返回true；控制器进程退出或超时返回false
+        bool Wait(const ProcessHandle& controller, int timeoutMs) {
+            HANDLE handles[2] = { event, controller.handle };
+            DWORD count = controller.handle ? 2 : 1;
+            return WaitForMultipleObjects(count, handles, FALSE, static_cast<DWORD>(timeoutMs)) == WAIT_OBJECT_0;
+        }
+
+        static bool Signal(const std::wstring& name) {
+            HANDLE hEvent = OpenEventW(EVENT_MODIFY_STATE, FALSE, name.c_str());
+            if (!hEvent) return false;
+            bool signaled = SetEvent(hEvent) != FALSE;
+            CloseHandle(hEvent);
+            return signaled;
+        }
+    };
+}
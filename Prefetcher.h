@@ -0,0 +1,292 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <cwctype>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include "Platform.h"
+#include "ProgramConfig.h"
+#include "TraceRecorder.h"
+
+// 预读阶段：在启动计划之前把各条目的可执行文件和prefetch列出的文件读入页缓存，
+// 冷启动时程序自己的读取不必再等磁盘。按计划顺序预读，多个工作线程并发读取，总带宽受上限约束；
+// 条目已开始启动时，其尚未开始预读的文件直接跳过，不与程序自己的读取争抢磁盘
+class Prefetcher {
+public:
+    struct Report {
+        size_t files = 0;             // 已预读的文件数
+        size_t skippedFiles = 0;      // 条目先启动而跳过的文件数
+        size_t failedFiles = 0;       // 无法打开或读取的文件数
+        uint64_t bytes = 0;
+        int elapsedMs = 0;            // 预读阶段总用时
+        size_t entries = 0;
+        size_t entriesReady = 0;      // 启动前已完成预读的条目数
+        int savedMs = 0;              // 启动前完成的读取所用的I/O时间，即从启动路径上移走的时间
+    };
+
+private:
+    static constexpr uint64_t kChunkBytes = 1024 * 1024;
+
+    struct FileTask {
+        size_t entry;
+        std::wstring path;
+    };
+
+    struct EntryState {
+        std::wstring name;
+        size_t pendingFiles = 0;
+        bool launched = false;
+        bool readyBeforeLaunch = false;
+        int64_t savedUs = 0;
+    };
+
+    std::mutex mutex;
+    std::vector<FileTask> tasks;
+    size_t nextTask = 0;
+    std::vector<EntryState> entries;
+    std::unordered_map<std::wstring, size_t> entryByName;
+    std::vector<std::thread> workers;
+    std::atomic<bool> stopping{ false };
+    Report report;
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point finishTime;     // 最后一个文件完成的时刻
+
+    // 带宽上限：各线程按读取量依次预约时间片，0表示不限制
+    uint64_t bytesPerSecond = 0;
+    std::chrono::steady_clock::time_point nextSlot;
+
+    void Throttle(uint64_t bytes) {
+        if (bytesPerSecond == 0) return;
+        std::chrono::steady_clock::time_point start;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            start = (std::max)(std::chrono::steady_clock::now(), nextSlot);
+            nextSlot = start + std::chrono::microseconds(bytes * 1000000 / bytesPerSecond);
+        }
+        std::this_thread::sleep_until(start);
+    }
+
+    // 取下一个文件；所属条目已经启动的文件跳过
+    bool NextTask(FileTask& task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        while (nextTask < tasks.size()) {
+            task = tasks[nextTask++];
+            EntryState& entry = entries[task.entry];
+            if (!entry.launched) return true;
+            entry.pendingFiles--;
+            report.skippedFiles++;
+        }
+        return false;
+    }
+
+    void WorkerLoop() {
+        TraceRecorder::Shared().SetThreadName("prefetch");
+        Platform::PrefetchFile file;
+        FileTask task;
+        while (!stopping && NextTask(task)) {
+            uint64_t bytes = 0;
+            int64_t ioUs = 0;             // 只计读取本身，不含限速等待
+            bool ok = false;
+            {
+                TraceSpan span("prefetch_file", "io", entries[task.entry].name);
+                if (file.Open(task.path)) {
+                    ok = true;
+                    for (uint64_t offset = 0; ok && offset < file.Size() && !stopping; offset += kChunkBytes) {
+                        uint64_t length = (std::min)(kChunkBytes, file.Size() - offset);
+                        Throttle(length);
+                        auto start = std::chrono::steady_clock::now();
+                        ok = file.Read(offset, length);
+                        ioUs += std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - start).count();
+                        if (ok) bytes += length;
+                    }
+                    file.Close();
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            EntryState& entry = entries[task.entry];
+            entry.pendingFiles--;
+            finishTime = std::chrono::steady_clock::now();
+            report.bytes += bytes;
+            if (ok) report.files++;
+            else report.failedFiles++;
+            if (!entry.launched) {
+                entry.savedUs += ioUs;
+                if (entry.pendingFiles == 0) entry.readyBeforeLaunch = true;
+            }
+        }
+    }
+
+    static bool WildcardMatch(const std::wstring& pattern, const std::wstring& text) {
+        size_t p = 0, t = 0, starP = std::wstring::npos, starT = 0;
+        while (t < text.size()) {
+            if (p < pattern.size() && (pattern[p] == L'?' || std::towlower(pattern[p]) == std::towlower(text[t]))) {
+                p++;
+                t++;
+            }
+            else if (p < pattern.size() && pattern[p] == L'*') {
+                starP = p++;
+                starT = t;
+            }
+            else if (starP != std::wstring::npos) {
+                p = starP + 1;
+                t = ++starT;
+            }
+            else {
+                return false;
+            }
+        }
+        while (p < pattern.size() && pattern[p] == L'*') p++;
+        return p == pattern.size();
+    }
+
+    // 从directory开始逐级匹配components[index..]，"**"匹配任意层子目录
+    static void ExpandFrom(const std::wstring& directory, const std::vector<std::wstring>& components, size_t index,
+        std::vector<std::wstring>& files) {
+        const std::wstring& component = components[index];
+        bool last = index + 1 == components.size();
+        std::vector<Platform::DirectoryEntry> listing = Platform::ListDirectory(directory);
+        if (component == L"**") {
+            if (!last) ExpandFrom(directory, components, index + 1, files);
+            for (const auto& item : listing) {
+                if (item.isDirectory) ExpandFrom(Platform::JoinPath(directory, item.name), components, index, files);
+                else if (last) files.push_back(Platform::JoinPath(directory, item.name));
+            }
+            return;
+        }
+        for (const auto& item : listing) {
+            if (!WildcardMatch(component, item.name)) continue;
+            std::wstring path = Platform::JoinPath(directory, item.name);
+            if (last) {
+                if (!item.isDirectory) files.push_back(path);
+            }
+            else if (item.isDirectory) {
+                ExpandFrom(path, components, index + 1, files);
+            }
+        }
+    }
+
+public:
+    Prefetcher() = default;
+    Prefetcher(const Prefetcher&) = delete;
+    Prefetcher& operator=(const Prefetcher&) = delete;
+
+    ~Prefetcher() {
+        stopping = true;
+        for (auto& worker : workers) {
+            if (worker.joinable()) worker.join();
+        }
+    }
+
+    // 展开通配符（* ? 和 **），相对路径基于baseDirectory；不含通配符的路径原样返回
+    static std::vector<std::wstring> ExpandPattern(const std::wstring& pattern, const std::wstring& baseDirectory) {
+        bool absolute = (!pattern.empty() && Platform::IsPathSeparator(pattern[0])) ||
+            (pattern.size() > 1 && pattern[1] == L':');
+        std::wstring path = absolute || baseDirectory.empty() ? pattern : Platform::JoinPath(baseDirectory, pattern);
+        size_t wildcard = path.find_first_of(L"*?");
+        if (wildcard == std::wstring::npos) return { path };
+
+        // 通配符之前的部分是普通目录
+        size_t split = path.find_last_of(L"\\/", wildcard);
+        std::wstring directory = split == std::wstring::npos ? L"." : path.substr(0, (std::max)(split, size_t(1)));
+        std::vector<std::wstring> components;
+        size_t start = split == std::wstring::npos ? 0 : split + 1;
+        while (start <= path.size()) {
+            size_t end = path.find_first_of(L"\\/", start);
+            if (end == std::wstring::npos) end = path.size();
+            if (end > start) components.push_back(path.substr(start, end - start));
+            start = end + 1;
+        }
+
+        std::vector<std::wstring> files;
+        if (!components.empty()) ExpandFrom(directory, components, 0, files);
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    // 条目要预读的文件：可执行文件本身和prefetch列出的文件
+    static std::vector<std::wstring> FilesOf(const ProgramConfig& config) {
+        std::vector<std::wstring> files;
+        if (!config.path.empty()) files.push_back(config.path);
+        std::wstring baseDirectory = Platform::DirectoryOf(config.path);
+        for (const auto& pattern : config.prefetch) {
+            std::vector<std::wstring> matched = ExpandPattern(pattern, baseDirectory);
+            files.insert(files.end(), matched.begin(), matched.end());
+        }
+        return files;
+    }
+
+    // 按plan顺序开始预读；bandwidthMBps为0时不限速。上一次预读须已Finish（守护模式每次运行重复使用）
+    void Start(const std::vector<ProgramConfig>& plan, int workerCount, int bandwidthMBps) {
+        tasks.clear();
+        nextTask = 0;
+        entries.clear();
+        entryByName.clear();
+        report = Report();
+        stopping = false;
+        startTime = std::chrono::steady_clock::now();
+        finishTime = startTime;
+        nextSlot = startTime;
+        bytesPerSecond = static_cast<uint64_t>((std::max)(bandwidthMBps, 0)) * 1024 * 1024;
+
+        std::unordered_set<std::wstring> seen;
+        for (const auto& config : plan) {
+            size_t index = entries.size();
+            entries.emplace_back();
+            entries[index].name = config.name;
+            entryByName[config.name] = index;
+            for (auto& path : FilesOf(config)) {
+                if (!seen.insert(path).second) continue;
+                tasks.push_back({ index, std::move(path) });
+                entries[index].pendingFiles++;
+            }
+        }
+        report.entries = entries.size();
+
+        int count = (std::min)((std::max)(workerCount, 1), static_cast<int>(tasks.size()));
+        for (int i = 0; i < count; i++) {
+            workers.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    size_t FileCount() const {
+        return tasks.size();
+    }
+
+    // 条目开始启动：之后才完成的读取不再计入节省的时间，尚未开始的文件不再预读
+    void NotifyLaunch(const std::wstring& name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entryByName.find(name);
+        if (it == entryByName.end()) return;
+        EntryState& entry = entries[it->second];
+        entry.launched = true;
+        if (entry.pendingFiles == 0) entry.readyBeforeLaunch = true;
+    }
+
+    // 等待预读结束并汇总
+    Report Finish() {
+        for (auto& worker : workers) {
+            if (worker.joinable()) worker.join();
+        }
+        workers.clear();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        report.elapsedMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            finishTime - startTime).count());
+        report.entriesReady = 0;
+        int64_t savedUs = 0;
+        for (const auto& entry : entries) {
+            if (entry.readyBeforeLaunch) report.entriesReady++;
+            savedUs += entry.savedUs;
+        }
+        report.savedMs = static_cast<int>(savedUs / 1000);
+        return report;
+    }
+};
@@ -0,0 +1,114 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <cwctype>
+#include <unordered_map>
+#include <unordered_set>
+#include "Platform.h"
+
+// 系统进程快照：一次枚举，按名称、可执行文件路径和父进程建立索引
+class ProcessSnapshot {
+private:
+    using ProcessId = Platform::ProcessId;
+
+    std::unordered_map<std::wstring, std::vector<ProcessId>> pidsByName;   // 小写进程名 -> PID列表
+    std::unordered_map<std::wstring, std::vector<ProcessId>> pidsByPath;   // 小写完整路径 -> PID列表（仅withPaths）
+    std::unordered_map<ProcessId, std::vector<ProcessId>> childrenByParent; // 父PID -> 子PID列表
+    std::unordered_set<ProcessId> unknownPath;                               // 无法读取路径的进程
+
+public:
+    static std::wstring ToLower(std::wstring str) {
+        std::transform(str.begin(), str.end(), str.begin(),
+            [](wchar_t c) { return static_cast<wchar_t>(std::towlower(c)); });
+        return str;
+    }
+
+    // withPaths为true时同时建立路径索引（Windows上每个进程多一次OpenProcess）
+    static std::shared_ptr<ProcessSnapshot> Capture(bool withPaths = false) {
+        auto snapshot = std::make_shared<ProcessSnapshot>();
+        for (const auto& process : Platform::ListProcesses(withPaths)) {
+            snapshot->pidsByName[ToLower(process.name)].push_back(process.pid);
+            snapshot->childrenByParent[process.parentPid].push_back(process.pid);
+            if (!withPaths) continue;
+            if (process.path.empty()) snapshot->unknownPath.insert(process.pid);
+            else snapshot->pidsByPath[ToLower(process.path)].push_back(process.pid);
+        }
+        return snapshot;
+    }
+
+    std::vector<ProcessId> FindByPath(const std::wstring& path) const {
+        auto it = pidsByPath.find(ToLower(path));
+        return it != pidsByPath.end() ? it->second : std::vector<ProcessId>();
+    }
+
+    bool IsPathKnown(ProcessId pid) const {
+        return unknownPath.count(pid) == 0;
+    }
+
+    std::vector<ProcessId> FindByName(const std::wstring& name) const {
+        auto it = pidsByName.find(ToLower(name));
+        return it != pidsByName.end() ? it->second : std::vector<ProcessId>();
+    }
+
+    // 查找rootPid的所有后代中名称匹配的进程（rootPid已退出时其子进程仍记录着它的PID）
+    std::vector<ProcessId> FindDescendantsByName(ProcessId rootPid, const std::wstring& name) const {
+        std::vector<ProcessId> candidates = FindByName(name);
+        if (candidates.empty()) return candidates;
+
+        std::unordered_set<ProcessId> descendants;
+        std::vector<ProcessId> stack = { rootPid };
+        while (!stack.empty()) {
+            ProcessId pid = stack.back();
+            stack.pop_back();
+            auto it = childrenByParent.find(pid);
+            if (it == childrenByParent.end()) continue;
+            for (ProcessId child : it->second) {
+                // 系统空闲进程的父PID为0，避免形成环
+                if (child == pid || child == 0 || !descendants.insert(child).second) continue;
+                stack.push_back(child);
+            }
+        }
+
+        std::vector<ProcessId> result;
+        for (ProcessId pid : candidates) {
+            if (descendants.count(pid)) {
+                result.push_back(pid);
+            }
+        }
+        return result;
+    }
+};
+
+// 共享快照缓存：短时间内多个定时关闭任务复用同一次枚举
+class ProcessSnapshotCache {
+private:
+    std::mutex mutex;
+    std::shared_ptr<ProcessSnapshot> snapshot;
+    std::chrono::steady_clock::time_point capturedAt;
+
+public:
+    static ProcessSnapshotCache& Shared() {
+        static ProcessSnapshotCache cache;
+        return cache;
+    }
+
+    std::shared_ptr<const ProcessSnapshot> Get(std::chrono::milliseconds maxAge = std::chrono::milliseconds(250)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto now = std::chrono::steady_clock::now();
+        if (!snapshot || now - capturedAt > maxAge) {
+            snapshot = ProcessSnapshot::Capture();
+            capturedAt = now;
+        }
+        return snapshot;
+    }
+
+    // 结束进程后调用，下次查询重新枚举
+    void Invalidate() {
+        std::lock_guard<std::mutex> lock(mutex);
+        snapshot.reset();
+    }
+};
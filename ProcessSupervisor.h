@@ -0,0 +1,100 @@
+#pragma once
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "Platform.h"
+#include "TraceRecorder.h"
+
+// 进程退出监督：所有被监督的子进程由同一个线程上的事件循环等待
+// （Windows为WaitForMultipleObjects，POSIX为pidfd+epoll），进程退出时在该线程上回调其退出码。
+// 没有待监督的进程时线程一直阻塞，不做任何轮询。
+class ProcessSupervisor {
+public:
+    using WatchId = uint64_t;
+    using ExitCallback = std::function<void(int exitCode)>;   // 无法取得退出码时为-1
+
+private:
+    struct WatchedProcess {
+        Platform::ProcessHandle process;
+        ExitCallback callback;
+    };
+
+    std::mutex mutex;
+    std::condition_variable callbackDone;
+    Platform::ExitWatcher watcher;
+    std::unordered_map<WatchId, WatchedProcess> watches;
+    WatchId nextId = 1;
+    WatchId runningId = 0;
+    std::thread::id workerThreadId;
+    std::thread worker;
+
+    void WorkerLoop() {
+        std::vector<uint64_t> exited;
+        while (watcher.Wait(exited)) {
+            for (WatchId id : exited) {
+                std::unique_lock<std::mutex> lock(mutex);
+                auto it = watches.find(id);
+                if (it == watches.end()) continue;
+                WatchedProcess watch = std::move(it->second);
+                watches.erase(it);
+                runningId = id;
+                lock.unlock();
+
+                int exitCode = -1;
+                Platform::GetExitCode(watch.process, exitCode);
+                Platform::Reap(watch.process);      // 及时回收，僵尸进程不会让进程组看起来仍在运行
+                TraceRecorder::Shared().SetThreadName("supervisor");
+                watch.callback(exitCode);
+
+                lock.lock();
+                runningId = 0;
+                callbackDone.notify_all();
+            }
+        }
+    }
+
+public:
+    ProcessSupervisor() {
+        worker = std::thread([this]() { WorkerLoop(); });
+        workerThreadId = worker.get_id();
+    }
+
+    ProcessSupervisor(const ProcessSupervisor&) = delete;
+    ProcessSupervisor& operator=(const ProcessSupervisor&) = delete;
+
+    ~ProcessSupervisor() {
+        watcher.Stop();
+        if (worker.joinable()) worker.join();
+    }
+
+    static ProcessSupervisor& Shared() {
+        static ProcessSupervisor supervisor;
+        return supervisor;
+    }
+
+    // 开始监督进程，返回0表示无法监督（没有可等待的句柄或超过平台上限）
+    // process在回调执行前必须保持打开，以便读取退出码
+    WatchId Watch(const Platform::ProcessHandle& process, ExitCallback callback) {
+        std::lock_guard<std::mutex> lock(mutex);
+        WatchId id = nextId++;
+        if (!watcher.Add(process, id)) return 0;
+        watches[id] = { process, std::move(callback) };
+        return id;
+    }
+
+    // 停止监督；若其回调正在执行，等待执行结束后再返回（在回调中调用时不等待）
+    bool Unwatch(WatchId id) {
+        if (!id) return false;
+        std::unique_lock<std::mutex> lock(mutex);
+        watcher.Remove(id);
+        bool removed = watches.erase(id) > 0;
+        if (std::this_thread::get_id() != workerThreadId) {
+            callbackDone.wait(lock, [&]() { return runningId != id; });
+        }
+        return removed;
+    }
+};
@@ -0,0 +1,271 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// 程序类型枚举
+enum class ProgramType {
+    Exe,              // 普通EXE程序
+    Bat,              // BAT脚本文件
+    ExeWithArgument   // 需要参数的EXE程序
+};
+
+inline std::wstring ProgramTypeToString(ProgramType type) {
+    switch (type) {
+    case ProgramType::Exe: return L"Exe";
+    case ProgramType::Bat: return L"Bat";
+    case ProgramType::ExeWithArgument: return L"ExeWithArgument";
+    default: return L"Unknown";
+    }
+}
+
+inline ProgramType StringToProgramType(const std::wstring& str) {
+    if (str == L"Exe") return ProgramType::Exe;
+    if (str == L"Bat") return ProgramType::Bat;
+    if (str == L"ExeWithArgument") return ProgramType::ExeWithArgument;
+    return ProgramType::Exe;
+}
+
+// 就绪条件类型
+enum class ReadinessType {
+    None,             // 未配置，使用delayAfterStart固定等待
+    ProcessAlive,     // 启动的进程存活指定毫秒数
+    ProcessPresent,   // 指定名称的进程出现
+    FileChanged,      // 文件被创建或修改
+    LogLine,          // 日志文件出现匹配的行
+    TcpPort           // 本机TCP端口开始监听
+};
+
+// 就绪条件配置
+struct ReadinessCondition {
+    ReadinessType type = ReadinessType::None;
+    std::wstring target;              // alive: 毫秒数 / process: 进程名 / file、log: 文件路径 / port: 端口号
+    std::wstring pattern;             // log: 匹配日志行的正则表达式
+    int timeoutMs = 30000;            // 超时时间（毫秒）
+};
+
+inline ReadinessType StringToReadinessType(const std::wstring& str) {
+    if (str == L"alive") return ReadinessType::ProcessAlive;
+    if (str == L"process") return ReadinessType::ProcessPresent;
+    if (str == L"file") return ReadinessType::FileChanged;
+    if (str == L"log") return ReadinessType::LogLine;
+    if (str == L"port") return ReadinessType::TcpPort;
+    return ReadinessType::None;
+}
+
+inline std::wstring ReadinessTypeToString(ReadinessType type) {
+    switch (type) {
+    case ReadinessType::ProcessAlive: return L"alive";
+    case ReadinessType::ProcessPresent: return L"process";
+    case ReadinessType::FileChanged: return L"file";
+    case ReadinessType::LogLine: return L"log";
+    case ReadinessType::TcpPort: return L"port";
+    default: return L"";
+    }
+}
+
+// 进程退出后的重启策略
+enum class RestartMode {
+    Never,            // 不重启
+    OnFailure,        // 退出码非0时重启
+    Always            // 任何退出都重启（定时关闭除外）
+};
+
+inline RestartMode StringToRestartMode(const std::wstring& str) {
+    if (str == L"on-failure") return RestartMode::OnFailure;
+    if (str == L"always") return RestartMode::Always;
+    return RestartMode::Never;
+}
+
+inline std::wstring RestartModeToString(RestartMode mode) {
+    switch (mode) {
+    case RestartMode::OnFailure: return L"on-failure";
+    case RestartMode::Always: return L"always";
+    default: return L"never";
+    }
+}
+
+// 重启策略配置：等待时间从delayMs开始每次翻倍，最多maxDelayMs；
+// 连续重启limit次后视为崩溃循环不再重启（运行超过一分钟后重新计数）
+struct RestartPolicy {
+    RestartMode mode = RestartMode::Never;
+    int delayMs = 1000;
+    int maxDelayMs = 60000;
+    int limit = 5;
+};
+
+// 目标进程已在运行（启动器启动时的进程快照中找到）时的处理方式
+enum class IfRunningPolicy {
+    Start,            // 照常再启动一个
+    Skip,             // 跳过，不再启动也不管理
+    Attach            // 接管已运行的进程：监督其退出并安排定时关闭
+};
+
+inline IfRunningPolicy StringToIfRunningPolicy(const std::wstring& str) {
+    if (str == L"skip") return IfRunningPolicy::Skip;
+    if (str == L"attach") return IfRunningPolicy::Attach;
+    return IfRunningPolicy::Start;
+}
+
+inline std::wstring IfRunningPolicyToString(IfRunningPolicy policy) {
+    switch (policy) {
+    case IfRunningPolicy::Skip: return L"skip";
+    case IfRunningPolicy::Attach: return L"attach";
+    default: return L"start";
+    }
+}
+
+// 启动后等待时间的取法
+enum class DelayMode {
+    Fixed,            // 固定等待delayAfterStart
+    Auto              // 按启动历史的高分位数等待，不超过delayAfterStart（历史不足时等于delayAfterStart）
+};
+
+inline DelayMode StringToDelayMode(const std::wstring& str) {
+    if (str == L"auto") return DelayMode::Auto;
+    return DelayMode::Fixed;
+}
+
+inline std::wstring DelayModeToString(DelayMode mode) {
+    return mode == DelayMode::Auto ? L"auto" : L"fixed";
+}
+
+// 优先级档位（CPU、I/O和内存优先级共用），Default表示不修改
+enum class PriorityLevel { Default, Idle, BelowNormal, Normal, AboveNormal, High };
+
+inline PriorityLevel StringToPriorityLevel(const std::wstring& str) {
+    if (str == L"idle") return PriorityLevel::Idle;
+    if (str == L"below-normal") return PriorityLevel::BelowNormal;
+    if (str == L"normal") return PriorityLevel::Normal;
+    if (str == L"above-normal") return PriorityLevel::AboveNormal;
+    if (str == L"high") return PriorityLevel::High;
+    return PriorityLevel::Default;
+}
+
+inline std::wstring PriorityLevelToString(PriorityLevel level) {
+    switch (level) {
+    case PriorityLevel::Idle: return L"idle";
+    case PriorityLevel::BelowNormal: return L"below-normal";
+    case PriorityLevel::Normal: return L"normal";
+    case PriorityLevel::AboveNormal: return L"above-normal";
+    case PriorityLevel::High: return L"high";
+    default: return L"";
+    }
+}
+
+// 解析CPU编号列表，例如 "0-3,6"；空字符串表示不限制，格式错误返回false
+inline bool ParseCpuList(const std::wstring& text, std::vector<int>& cpus) {
+    cpus.clear();
+    size_t position = 0;
+    while (position < text.size()) {
+        size_t end = text.find(L',', position);
+        if (end == std::wstring::npos) end = text.size();
+        std::wstring item = text.substr(position, end - position);
+        position = end + 1;
+        item.erase(0, item.find_first_not_of(L' '));
+        item.erase(item.find_last_not_of(L' ') + 1);
+        if (item.empty()) continue;
+
+        size_t dash = item.find(L'-', 1);
+        int first = 0, last = 0;
+        try {
+            size_t used = 0;
+            first = std::stoi(item.substr(0, dash), &used);
+            if (used != (dash == std::wstring::npos ? item.size() : dash)) return false;
+            last = first;
+            if (dash != std::wstring::npos) {
+                std::wstring upper = item.substr(dash + 1);
+                last = std::stoi(upper, &used);
+                if (used != upper.size()) return false;
+            }
+        }
+        catch (...) {
+            return false;
+        }
+        if (first < 0 || last < first || last > 1023) return false;
+        for (int cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+    }
+    return true;
+}
+
+// 进程调度设置：在程序执行第一条指令之前应用
+struct SchedulingSettings {
+    PriorityLevel priorityClass = PriorityLevel::Default;   // CPU优先级
+    PriorityLevel ioPriority = PriorityLevel::Default;
+    PriorityLevel memoryPriority = PriorityLevel::Default;
+    std::wstring cpuAffinity;         // 允许运行的CPU编号，例如 "0-3,6"
+
+    bool Enabled() const {
+        return priorityClass != PriorityLevel::Default || ioPriority != PriorityLevel::Default ||
+            memoryPriority != PriorityLevel::Default || !cpuAffinity.empty();
+    }
+};
+
+// 整个进程树的资源上限（0表示不限制）
+struct ResourceLimits {
+    int memoryMB = 0;
+    int cpuPercent = 0;               // 占整机CPU的百分比
+
+    bool Enabled() const {
+        return memoryMB > 0 || cpuPercent > 0;
+    }
+};
+
+// 负载准入阈值：系统负载低于阈值后才启动（-1/0表示不检查该项）
+struct AdmissionThresholds {
+    int maxCpuPercent = -1;           // CPU使用率上限（%）
+    int maxDiskQueue = -1;            // 磁盘队列长度上限（正在进行的I/O数）
+    int minFreeMemoryMB = 0;          // 可用内存下限（MB）
+    int maxWaitMs = 30000;            // 最长等待时间，超时后仍然启动
+
+    bool Enabled() const {
+        return maxCpuPercent >= 0 || maxDiskQueue >= 0 || minFreeMemoryMB > 0;
+    }
+};
+
+// 子进程输出捕获：stdout和stderr写入<配置目录>/logs/<name>.log，超过上限后滚动
+struct OutputCaptureSettings {
+    bool enabled = false;
+    int maxKB = 1024;                 // 单个日志文件的大小上限（KB）
+    int files = 3;                    // 保留的文件数（含当前文件）
+};
+
+// 程序配置类
+struct ProgramConfig {
+    int order;                        // 执行顺序（唯一，从小到大依次执行）
+    bool enabled;                     // 是否启用该程序
+    std::wstring path;                // 程序路径
+    std::vector<std::wstring> arguments; // 命令行参数（最多5个）
+    ProgramType type;                 // 程序类型
+    int delayAfterStart;              // 启动后等待时间（毫秒），未配置就绪条件时使用
+    DelayMode delayMode = DelayMode::Fixed; // auto时delayAfterStart只作为上限
+    ReadinessCondition readiness;     // 就绪条件（满足后才启动依赖它的程序）
+    AdmissionThresholds admission;    // 启动前等待系统负载回落的阈值
+    RestartPolicy restart;            // 进程退出后是否以及如何重启
+    ResourceLimits limits;            // 进程树（Job Object / cgroup）的资源上限
+    SchedulingSettings scheduling;    // 优先级和CPU亲和性
+    std::vector<std::wstring> prefetch; // 预读阶段额外读入页缓存的文件或通配符（相对路径基于程序所在目录）
+    IfRunningPolicy ifRunning = IfRunningPolicy::Start; // 目标已在运行时跳过或接管
+    OutputCaptureSettings output;     // 是否以及如何保存程序的控制台输出
+    
+    std::wstring processNameToKill;   // 要关闭的进程名
+    bool killAnyByName = false;       // 启动的进程树中没有同名进程时，是否关闭系统中所有同名进程（须显式开启）
+    int killAfterSeconds;             // 启动后多少秒关闭（0表示不关闭）
+    
+    std::wstring name;                // 配置名称（用于JSON文件名）
+    std::wstring description;         // 描述信息
+
+    std::vector<std::wstring> dependsOn; // 前置程序名称（需等待其启动完成）
+    bool hasDependsOn;                // JSON中是否写了dependsOn（未写则按order顺序串行）
+
+    ProgramConfig() : order(0), enabled(true), type(ProgramType::Exe),
+        delayAfterStart(2000), killAfterSeconds(0), hasDependsOn(false) {}
+
+    ProgramConfig(int ord, bool en, const std::wstring& p, const std::vector<std::wstring>& args,
+        ProgramType t, int delay, const std::wstring& killProcess = L"",
+        int killAfter = 0, const std::wstring& configName = L"",
+        const std::wstring& desc = L"")
+        : order(ord), enabled(en), path(p), arguments(args), type(t),
+        delayAfterStart(delay), processNameToKill(killProcess),
+        killAfterSeconds(killAfter), name(configName), description(desc),
+        hasDependsOn(false) {}
+};
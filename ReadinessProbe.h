@@ -0,0 +1,154 @@
+#pragma once
+#include <string>
+#include <regex>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <atomic>
+#include <algorithm>
+#include "Platform.h"
+#include "ProgramConfig.h"
+#include "ProcessSnapshot.h"
+#include "TextEncoding.h"
+
+enum class ReadinessResult { Ready, TimedOut, Failed };
+
+// 就绪探测器：启动前调用Prepare记录初始状态，启动后调用Wait阻塞到条件满足或超时
+class ReadinessProbe {
+private:
+    ReadinessCondition condition;
+    int pollIntervalMs = 100;
+    static constexpr int kMaxProcessPollMs = 1000;    // 进程检查需要枚举系统进程，间隔逐次加倍到此上限
+
+    bool fileExisted = false;
+    uint64_t initialWriteTime = 0;
+    uint64_t logOffset = 0;
+    std::string partialLine;
+
+    static int ToInt(const std::wstring& str) {
+        try {
+            return std::stoi(str);
+        }
+        catch (...) {
+            return 0;
+        }
+    }
+
+    bool GetWriteTime(uint64_t& writeTime) {
+        uint64_t size = 0;
+        return Platform::GetFileStamp(condition.target, size, writeTime);
+    }
+
+    uint64_t GetFileSize64() {
+        uint64_t size = 0, writeTime = 0;
+        return Platform::GetFileStamp(condition.target, size, writeTime) ? size : 0;
+    }
+
+    // 使用共享快照：同时等待的多个探测和定时关闭复用同一次枚举
+    bool CheckProcessPresent() {
+        return !ProcessSnapshotCache::Shared().Get()->FindByName(condition.target).empty();
+    }
+
+    bool CheckFileChanged() {
+        uint64_t writeTime;
+        if (!GetWriteTime(writeTime)) return false;
+        if (!fileExisted) return true;
+        return writeTime != initialWriteTime;
+    }
+
+    // 只读取上次位置之后新增的内容
+    bool CheckLogLine(const std::wregex& regex) {
+        std::string data;
+        uint64_t fileSize = 0;
+        if (!Platform::ReadFileFrom(condition.target, logOffset, data, fileSize)) return false;
+        if (fileSize < logOffset) {
+            // 日志被截断或轮转，从头开始读
+            logOffset = 0;
+            partialLine.clear();
+            if (!Platform::ReadFileFrom(condition.target, 0, data, fileSize)) return false;
+        }
+        logOffset += data.size();
+        partialLine += data;
+
+        bool matched = false;
+        size_t lineStart = 0;
+        size_t lineEnd;
+        while ((lineEnd = partialLine.find('\n', lineStart)) != std::string::npos) {
+            std::string line = partialLine.substr(lineStart, lineEnd - lineStart);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            lineStart = lineEnd + 1;
+            if (std::regex_search(TextEncoding::Utf8ToWide(line), regex)) {
+                matched = true;
+                break;
+            }
+        }
+        partialLine.erase(0, lineStart);
+        return matched;
+    }
+
+    bool CheckTcpPort() {
+        return Platform::IsTcpPortOpen(ToInt(condition.target));
+    }
+
+public:
+    ReadinessProbe() = default;
+    explicit ReadinessProbe(const ReadinessCondition& readiness) : condition(readiness) {}
+
+    // 启动前调用，记录文件的初始状态，避免把旧内容当成就绪信号
+    void Prepare() {
+        if (condition.type == ReadinessType::FileChanged) {
+            fileExisted = GetWriteTime(initialWriteTime);
+        }
+        else if (condition.type == ReadinessType::LogLine) {
+            logOffset = GetFileSize64();
+            partialLine.clear();
+        }
+    }
+
+    // cancel非空时每个检查间隔查看一次，置位后返回Failed
+    ReadinessResult Wait(const Platform::ProcessHandle& process, const std::atomic<bool>* cancel = nullptr) {
+        if (condition.type == ReadinessType::None) return ReadinessResult::Ready;
+
+        if (condition.type == ReadinessType::ProcessAlive) {
+            // 进程在指定时间内未退出即视为就绪
+            if (!process.IsValid()) return ReadinessResult::Failed;
+            auto aliveDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ToInt(condition.target));
+            while (true) {
+                if (cancel && *cancel) return ReadinessResult::Failed;
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(aliveDeadline - std::chrono::steady_clock::now());
+                int waitMs = static_cast<int>((std::max)(std::chrono::milliseconds(0), (std::min)(remaining, std::chrono::milliseconds(pollIntervalMs))).count());
+                if (Platform::WaitForExit(process, waitMs) != Platform::WaitResult::TimedOut) return ReadinessResult::Failed;
+                if (remaining.count() <= pollIntervalMs) return ReadinessResult::Ready;
+            }
+        }
+
+        std::wregex regex;
+        if (condition.type == ReadinessType::LogLine) {
+            try {
+                regex = std::wregex(condition.pattern);
+            }
+            catch (const std::regex_error&) {
+                return ReadinessResult::Failed;
+            }
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(condition.timeoutMs);
+        int intervalMs = pollIntervalMs;
+        while (true) {
+            bool ready = false;
+            switch (condition.type) {
+            case ReadinessType::ProcessPresent: ready = CheckProcessPresent(); break;
+            case ReadinessType::FileChanged: ready = CheckFileChanged(); break;
+            case ReadinessType::LogLine: ready = CheckLogLine(regex); break;
+            case ReadinessType::TcpPort: ready = CheckTcpPort(); break;
+            default: return ReadinessResult::Failed;
+            }
+            if (ready) return ReadinessResult::Ready;
+
+            if (std::chrono::steady_clock::now() >= deadline) return ReadinessResult::TimedOut;
+            if (cancel && *cancel) return ReadinessResult::Failed;
+            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+            if (condition.type == ReadinessType::ProcessPresent) intervalMs = (std::min)(intervalMs * 2, kMaxProcessPollMs);
+        }
+    }
+};
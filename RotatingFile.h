@@ -0,0 +1,87 @@
+#pragma once
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include "TextEncoding.h"
+
+// 按大小滚动的日志文件：file.log 写满后依次改名为 file.log.1、file.log.2 ...
+class RotatingFile {
+private:
+    std::wstring path;
+    uint64_t maxBytes = 0;
+    int maxFiles = 0;
+    FILE* file = nullptr;
+    uint64_t size = 0;
+
+    static FILE* OpenAppend(const std::wstring& path) {
+#ifdef _WIN32
+        return _wfopen(path.c_str(), L"ab");
+#else
+        return fopen(TextEncoding::WideToUtf8(path).c_str(), "ab");
+#endif
+    }
+
+    static void Rename(const std::wstring& from, const std::wstring& to) {
+#ifdef _WIN32
+        _wremove(to.c_str());
+        _wrename(from.c_str(), to.c_str());
+#else
+        rename(TextEncoding::WideToUtf8(from).c_str(), TextEncoding::WideToUtf8(to).c_str());
+#endif
+    }
+
+    void Rotate() {
+        Close();
+        for (int i = maxFiles - 1; i >= 1; i--) {
+            std::wstring from = i == 1 ? path : path + L"." + std::to_wstring(i - 1);
+            Rename(from, path + L"." + std::to_wstring(i));
+        }
+        file = OpenAppend(path);
+        size = 0;
+    }
+
+public:
+    RotatingFile() = default;
+    RotatingFile(const RotatingFile&) = delete;
+    RotatingFile& operator=(const RotatingFile&) = delete;
+
+    ~RotatingFile() {
+        Close();
+    }
+
+    bool Open(const std::wstring& filePath, uint64_t maxFileBytes, int fileCount) {
+        Close();
+        path = filePath;
+        maxBytes = maxFileBytes;
+        maxFiles = fileCount < 1 ? 1 : fileCount;
+        file = OpenAppend(path);
+        if (!file) return false;
+        fseek(file, 0, SEEK_END);
+        size = static_cast<uint64_t>(ftell(file));
+        return true;
+    }
+
+    bool IsOpen() const {
+        return file != nullptr;
+    }
+
+    void Write(const char* data, size_t length) {
+        if (!file || length == 0) return;
+        if (maxBytes > 0 && size > 0 && size + length > maxBytes) {
+            Rotate();
+            if (!file) return;
+        }
+        fwrite(data, 1, length, file);
+        fflush(file);
+        size += length;
+    }
+
+    void Write(const std::string& text) {
+        Write(text.data(), text.size());
+    }
+
+    void Close() {
+        if (file) fclose(file);
+        file = nullptr;
+    }
+};
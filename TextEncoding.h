@@ -0,0 +1,89 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+// UTF-8 与 wstring 互转（不依赖系统API，wchar_t为16位时使用代理对）
+namespace TextEncoding {
+
+    inline void AppendCodePoint(std::wstring& out, uint32_t codePoint) {
+        if (sizeof(wchar_t) == 2 && codePoint > 0xFFFF) {
+            codePoint -= 0x10000;
+            out.push_back(static_cast<wchar_t>(0xD800 + (codePoint >> 10)));
+            out.push_back(static_cast<wchar_t>(0xDC00 + (codePoint & 0x3FF)));
+        }
+        else {
+            out.push_back(static_cast<wchar_t>(codePoint));
+        }
+    }
+
+    inline void AppendUtf8(std::string& out, uint32_t codePoint) {
+        if (codePoint < 0x80) {
+            out.push_back(static_cast<char>(codePoint));
+        }
+        else if (codePoint < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+        else if (codePoint < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+        else {
+            out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+    }
+
+    // 从pos处解码一个UTF-8字符并前移pos，非法序列返回U+FFFD
+    inline uint32_t DecodeUtf8(std::string_view str, size_t& pos) {
+        unsigned char lead = static_cast<unsigned char>(str[pos++]);
+        if (lead < 0x80) return lead;
+
+        int extra = 0;
+        uint32_t codePoint = 0;
+        if ((lead & 0xE0) == 0xC0) { extra = 1; codePoint = lead & 0x1F; }
+        else if ((lead & 0xF0) == 0xE0) { extra = 2; codePoint = lead & 0x0F; }
+        else if ((lead & 0xF8) == 0xF0) { extra = 3; codePoint = lead & 0x07; }
+        else return 0xFFFD;
+
+        for (int i = 0; i < extra; i++) {
+            if (pos >= str.size()) return 0xFFFD;
+            unsigned char next = static_cast<unsigned char>(str[pos]);
+            if ((next & 0xC0) != 0x80) return 0xFFFD;
+            codePoint = (codePoint << 6) | (next & 0x3F);
+            pos++;
+        }
+        return codePoint > 0x10FFFF ? 0xFFFD : codePoint;
+    }
+
+    inline std::wstring Utf8ToWide(std::string_view str) {
+        std::wstring result;
+        result.reserve(str.size());
+        size_t pos = 0;
+        while (pos < str.size()) {
+            AppendCodePoint(result, DecodeUtf8(str, pos));
+        }
+        return result;
+    }
+
+    inline std::string WideToUtf8(std::wstring_view wstr) {
+        std::string result;
+        result.reserve(wstr.size());
+        for (size_t i = 0; i < wstr.size(); i++) {
+            uint32_t codePoint = static_cast<uint32_t>(wstr[i]);
+            if (sizeof(wchar_t) == 2 && codePoint >= 0xD800 && codePoint <= 0xDBFF && i + 1 < wstr.size()) {
+                uint32_t low = static_cast<uint32_t>(wstr[i + 1]);
+                if (low >= 0xDC00 && low <= 0xDFFF) {
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    i++;
+                }
+            }
+            AppendUtf8(result, codePoint);
+        }
+        return result;
+    }
+}
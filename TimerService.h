@@ -0,0 +1,224 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <queue>
+#include <vector>
+#include <unordered_map>
+
+// 定时器服务：所有定时关闭、重启和探测任务共用一个线程
+// 最小堆按到期时间排序，空闲时线程阻塞在条件变量上，待处理定时器数量不影响空闲开销。
+// 虚拟时钟模式下不创建线程，由调用方通过AdvanceBy推进时间，便于无需真实等待的测试。
+class TimerService {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+    using TimerId = uint64_t;
+    using Callback = std::function<void()>;
+
+    struct VirtualClockTag {};
+
+private:
+    struct Timer {
+        TimePoint deadline;
+        uint64_t generation;          // 每次重新调度递增，堆中旧条目据此失效
+        Callback callback;
+    };
+
+    struct HeapEntry {
+        TimePoint deadline;
+        uint64_t sequence;            // 同一时刻到期时按调度顺序触发
+        TimerId id;
+        uint64_t generation;
+
+        bool operator>(const HeapEntry& other) const {
+            if (deadline != other.deadline) return deadline > other.deadline;
+            return sequence > other.sequence;
+        }
+    };
+
+    mutable std::mutex mutex;
+    std::condition_variable wakeup;
+    std::condition_variable callbackDone;
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+    std::unordered_map<TimerId, Timer> timers;
+    TimerId nextId = 1;
+    uint64_t nextSequence = 0;
+
+    bool virtualClock = false;
+    TimePoint virtualNow;
+    TimerId runningId = 0;
+    std::thread::id workerThreadId;
+    bool stopping = false;
+    std::thread worker;
+
+    TimePoint NowLocked() const {
+        return virtualClock ? virtualNow : Clock::now();
+    }
+
+    void Push(TimerId id, const Timer& timer) {
+        heap.push({ timer.deadline, nextSequence++, id, timer.generation });
+    }
+
+    // 丢弃堆顶已取消或已重新调度的条目
+    void DropStale() {
+        while (!heap.empty()) {
+            const HeapEntry& top = heap.top();
+            auto it = timers.find(top.id);
+            if (it != timers.end() && it->second.generation == top.generation) return;
+            heap.pop();
+        }
+    }
+
+    // 取出堆顶定时器并在解锁状态下执行
+    void FireTop(std::unique_lock<std::mutex>& lock) {
+        HeapEntry entry = heap.top();
+        heap.pop();
+        auto it = timers.find(entry.id);
+        Callback callback = std::move(it->second.callback);
+        timers.erase(it);
+
+        runningId = entry.id;
+        lock.unlock();
+        callback();
+        lock.lock();
+        runningId = 0;
+        callbackDone.notify_all();
+    }
+
+    void WorkerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            DropStale();
+            if (heap.empty()) {
+                wakeup.wait(lock);
+                continue;
+            }
+            TimePoint deadline = heap.top().deadline;
+            if (deadline > Clock::now()) {
+                wakeup.wait_until(lock, deadline);
+                continue;
+            }
+            FireTop(lock);
+        }
+    }
+
+public:
+    TimerService() {
+        worker = std::thread([this]() { WorkerLoop(); });
+        workerThreadId = worker.get_id();
+    }
+
+    explicit TimerService(VirtualClockTag) : virtualClock(true), virtualNow() {}
+
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    ~TimerService() {
+        Shutdown();
+    }
+
+    // 进程内共享的实时定时器服务
+    static TimerService& Shared() {
+        static TimerService service;
+        return service;
+    }
+
+    void Shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            timers.clear();
+            heap = {};
+        }
+        wakeup.notify_all();
+        if (worker.joinable()) worker.join();
+    }
+
+    TimePoint Now() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return NowLocked();
+    }
+
+    bool IsVirtual() const {
+        return virtualClock;
+    }
+
+    // 按本服务的时钟等待：实时模式下休眠，虚拟时钟下直接推进时间
+    void SleepFor(std::chrono::milliseconds duration) {
+        if (virtualClock) AdvanceBy(duration);
+        else std::this_thread::sleep_for(duration);
+    }
+
+    TimerId Schedule(std::chrono::milliseconds delay, Callback callback) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) return 0;
+        TimerId id = nextId++;
+        Timer& timer = timers[id];
+        timer.deadline = NowLocked() + delay;
+        timer.generation = 0;
+        timer.callback = std::move(callback);
+        bool earliest = heap.empty() || timer.deadline < heap.top().deadline;
+        Push(id, timer);
+        if (earliest) wakeup.notify_one();
+        return id;
+    }
+
+    // 取消定时器；若其回调正在其他线程执行，等待执行结束后再返回
+    bool Cancel(TimerId id) {
+        std::unique_lock<std::mutex> lock(mutex);
+        bool removed = timers.erase(id) > 0;
+        if (!virtualClock && std::this_thread::get_id() != workerThreadId) {
+            callbackDone.wait(lock, [&]() { return runningId != id; });
+        }
+        return removed;
+    }
+
+    // 以当前时间为基准重新设置到期时间，已触发或已取消的定时器返回false
+    bool Reschedule(TimerId id, std::chrono::milliseconds delay) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = timers.find(id);
+        if (it == timers.end()) return false;
+        it->second.deadline = NowLocked() + delay;
+        it->second.generation++;
+        Push(id, it->second);
+        wakeup.notify_one();
+        return true;
+    }
+
+    bool IsPending(TimerId id) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return timers.count(id) > 0;
+    }
+
+    size_t Pending() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return timers.size();
+    }
+
+    // 虚拟时钟：推进时间并在当前线程按到期顺序执行所有到期的定时器
+    void AdvanceBy(std::chrono::milliseconds duration) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!virtualClock) return;
+        TimePoint target = virtualNow + duration;
+        while (true) {
+            DropStale();
+            if (heap.empty() || heap.top().deadline > target) break;
+            if (heap.top().deadline > virtualNow) virtualNow = heap.top().deadline;
+            FireTop(lock);
+        }
+        virtualNow = target;
+    }
+
+    // 虚拟时钟：距离下一个定时器到期的时间，没有定时器时返回false
+    bool NextDeadline(std::chrono::milliseconds& remaining) {
+        std::lock_guard<std::mutex> lock(mutex);
+        DropStale();
+        if (heap.empty()) return false;
+        remaining = std::chrono::duration_cast<std::chrono::milliseconds>(heap.top().deadline - NowLocked());
+        return true;
+    }
+};
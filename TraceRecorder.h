@@ -0,0 +1,186 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include "Platform.h"
+#include "TextEncoding.h"
+#include "ConfigParser.h"
+
+// 启动时间线追踪：记录配置加载、解析、启动、就绪等待、延时和定时关闭等阶段，
+// 导出为Chrome Trace Event JSON，可直接在Perfetto或chrome://tracing中打开。
+// 每个线程写入自己的缓冲区（只有导出时才会与写入线程竞争其锁）；
+// 未启用时每个埋点只有一次原子读取。
+class TraceRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    struct Event {
+        const char* name;             // 仅保存字符串字面量
+        const char* category;
+        char phase;                   // 'X' 时间段，'i' 瞬时事件
+        int64_t timestampUs;
+        int64_t durationUs;
+        std::wstring entry;           // 相关的程序名称（可为空）
+        Platform::ProcessId pid;      // 相关的进程（0表示无）
+    };
+
+    struct ThreadBuffer {
+        std::mutex mutex;
+        uint32_t threadId = 0;
+        std::string threadName;
+        std::vector<Event> events;
+    };
+
+    std::atomic<bool> enabled{ false };
+    Clock::time_point origin = Clock::now();
+    std::mutex registryMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+    ThreadBuffer& LocalBuffer() {
+        thread_local std::shared_ptr<ThreadBuffer> local;
+        if (!local) {
+            local = std::make_shared<ThreadBuffer>();
+            local->events.reserve(256);
+            std::lock_guard<std::mutex> lock(registryMutex);
+            local->threadId = static_cast<uint32_t>(buffers.size() + 1);
+            buffers.push_back(local);
+        }
+        return *local;
+    }
+
+    void Append(Event&& event) {
+        ThreadBuffer& buffer = LocalBuffer();
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.events.push_back(std::move(event));
+    }
+
+    static void AppendEvent(std::string& out, const Event& event, Platform::ProcessId processId, uint32_t threadId) {
+        char header[160];
+        snprintf(header, sizeof(header), ",\n{\"ph\":\"%c\",\"pid\":%u,\"tid\":%u,\"ts\":%lld", event.phase,
+            static_cast<unsigned>(processId), static_cast<unsigned>(threadId), static_cast<long long>(event.timestampUs));
+        out += header;
+        if (event.phase == 'X') out += ",\"dur\":" + std::to_string(event.durationUs);
+        else out += ",\"s\":\"t\"";
+        out += ",\"cat\":\"";
+        out += event.category;
+        out += "\",\"name\":\"";
+        out += event.name;
+        out += "\",\"args\":{";
+        bool first = true;
+        if (!event.entry.empty()) {
+            out += "\"entry\":";
+            AppendJsonString(out, event.entry);
+            first = false;
+        }
+        if (event.pid != 0) {
+            out += first ? "" : ",";
+            out += "\"pid\":" + std::to_string(event.pid);
+        }
+        out += "}}";
+    }
+
+public:
+    static TraceRecorder& Shared() {
+        static TraceRecorder recorder;
+        return recorder;
+    }
+
+    // 开始记录，时间戳以此刻为零点
+    void Enable() {
+        origin = Clock::now();
+        enabled.store(true, std::memory_order_release);
+    }
+
+    bool IsEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    int64_t NowUs() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - origin).count();
+    }
+
+    // 为当前线程命名，显示在时间线的线程轨道上
+    void SetThreadName(const std::string& name) {
+        if (!IsEnabled()) return;
+        ThreadBuffer& buffer = LocalBuffer();
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.threadName = name;
+    }
+
+    void Instant(const char* name, const char* category, const std::wstring& entry = L"", Platform::ProcessId pid = 0) {
+        if (!IsEnabled()) return;
+        Append({ name, category, 'i', NowUs(), 0, entry, pid });
+    }
+
+    void Complete(const char* name, const char* category, int64_t startUs, int64_t durationUs,
+        const std::wstring& entry = L"", Platform::ProcessId pid = 0) {
+        Append({ name, category, 'X', startUs, durationUs, entry, pid });
+    }
+
+    // 合并所有线程的缓冲区写出（可在其他线程仍在记录时调用）
+    bool WriteChromeTrace(const std::wstring& path) {
+        Platform::ProcessId processId = Platform::CurrentProcessId();
+        std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        out += "{\"ph\":\"M\",\"pid\":" + std::to_string(processId) + ",\"name\":\"process_name\",\"args\":{\"name\":\"launcher\"}}";
+
+        std::vector<std::shared_ptr<ThreadBuffer>> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            snapshot = buffers;
+        }
+        for (const auto& buffer : snapshot) {
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+            std::string threadName = buffer->threadName.empty() ?
+                "thread " + std::to_string(buffer->threadId) : buffer->threadName;
+            out += ",\n{\"ph\":\"M\",\"pid\":" + std::to_string(processId) + ",\"tid\":" + std::to_string(buffer->threadId) +
+                ",\"name\":\"thread_name\",\"args\":{\"name\":";
+            AppendJsonString(out, TextEncoding::Utf8ToWide(threadName));
+            out += "}}";
+            for (const Event& event : buffer->events) {
+                AppendEvent(out, event, processId, buffer->threadId);
+            }
+        }
+        out += "\n]}\n";
+        return Platform::WriteFileAtomic(path, out);
+    }
+};
+
+// 作用域时间段：构造时记录开始时刻，析构时写入一个完整事件
+// 未启用追踪时只有构造时的一次原子读取
+class TraceSpan {
+private:
+    const char* name;
+    const char* category;
+    int64_t startUs = -1;
+    std::wstring entry;
+    Platform::ProcessId pid = 0;
+
+public:
+    TraceSpan(const char* spanName, const char* spanCategory, const std::wstring& entryName = L"")
+        : name(spanName), category(spanCategory) {
+        TraceRecorder& recorder = TraceRecorder::Shared();
+        if (!recorder.IsEnabled()) return;
+        startUs = recorder.NowUs();
+        entry = entryName;
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    // 时间段内才得知的进程ID（例如启动后）
+    void SetPid(Platform::ProcessId processId) {
+        pid = processId;
+    }
+
+    ~TraceSpan() {
+        if (startUs < 0) return;
+        TraceRecorder& recorder = TraceRecorder::Shared();
+        recorder.Complete(name, category, startUs, recorder.NowUs() - startUs, entry, pid);
+    }
+};